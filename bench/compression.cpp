@@ -0,0 +1,134 @@
+// compression.cpp : measures the time and the size of xlsx and ods files
+// written with different compression options.
+//
+// Usage: compression [rows]
+//
+// A reference workbook of four sheets of eight columns, with text,
+// integers, decimals, and dates, is written into memory once per format
+// and compression profile; xlsx is written with texts in the cells, with
+// texts in a shared string table (xlsx-sst), and in the compact encoding
+// (xlsx-compact). The time is processor time; the throughput is
+// that of the stored package, which is about the size of the XML written.
+
+#include "splib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef WIN32
+#define _T(x) x
+#define _tmain  main
+#define _ttoi   atoi
+#endif // WIN32
+
+/** A compression profile */
+struct Profile {
+    /** The name of the profile */
+    const char* name;
+
+    /** The level of the entries */
+    int level;
+
+    /** The level of the sheets, or -2 for the level of the entries */
+    int sheetLevel;
+};
+
+/**
+ * Fills a spreadsheet with the reference workbook.
+ */
+void setupWorkbook(splib::Spreadsheet& sp, int rows) {
+    const _TCHAR* categories[] = {
+        _T("North"), _T("South"), _T("East"), _T("West"), _T("Central")};
+    for (int t = 0; t < 4; t++) {
+        _TCHAR name[16];
+        name[0] = _T('S');
+        name[1] = (_TCHAR)(_T('1') + t);
+        name[2] = 0;
+        splib::Table& table = sp.insertTable(t, name);
+        for (int row = 0; row < rows; row++) {
+            table.cell(0, row).setText(categories[row % 5]);
+            table.cell(1, row).setLong(row);
+            table.cell(2, row).setLong((row * 7919L) % 100000);
+            table.cell(3, row).setDouble(row * 0.25);
+            table.cell(4, row).setDouble((row % 1000) / 7.0);
+            table.cell(5, row).setDouble(row * 1.5 + t);
+            table.cell(6, row).setDate(splib::Date(2009, 1 + row % 12,
+                                                   1 + row % 28));
+            table.cell(7, row).setText(categories[(row / 5) % 5]);
+        }
+    }
+}
+
+/**
+ * Writes the workbook with a profile and prints the measurements.
+ * @param stored the size of the stored package, or 0 to measure it
+ * @return the size of the package
+ */
+unsigned long measure(splib::Spreadsheet& sp, const char* format,
+                      const Profile& profile, unsigned long stored) {
+    splib::CompressionOptions options(profile.level);
+    if (profile.sheetLevel != -2) {
+        options.setEntryLevel("xl/worksheets/", profile.sheetLevel);
+        options.setEntryLevel("content.xml", profile.sheetLevel);
+    }
+    splib::MemorySink sink;
+    clock_t start = clock();
+    if (format[0] == 'x') {
+        splib::XlsxWriter writer;
+        writer.setCompression(options);
+        writer.setSharedStrings(strcmp(format, "xlsx-sst") == 0);
+        writer.setCompact(strcmp(format, "xlsx-compact") == 0);
+        writer.write(sp, sink);
+    } else {
+        splib::OdsWriter writer;
+        writer.setCompression(options);
+        writer.write(sp, sink);
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    unsigned long size = sink.getSize();
+    if (stored == 0) {
+        stored = size;
+    }
+    printf("%-12s %-22s %8.3f s %8.1f MB/s %11lu bytes %6.1f %%\n",
+           format, profile.name, seconds,
+           seconds > 0 ? stored / seconds / 1e6 : 0.0, size,
+           100.0 * size / stored);
+    return size;
+}
+
+/**
+ * Program entry point.
+ */
+int _tmain(int argc, _TCHAR* argv[]) {
+    int rows = argc > 1 ? _ttoi(argv[1]) : 50000;
+    if (rows <= 0) {
+        fprintf(stderr, "usage: compression [rows]\n");
+        return 1;
+    }
+    splib::SpreadsheetImpl sp;
+    setupWorkbook(sp, rows);
+    const Profile profiles[] = {
+        {"store", splib::CompressionOptions::STORE, -2},
+        {"level 1", splib::CompressionOptions::BEST_SPEED, -2},
+        {"default", splib::CompressionOptions::DEFAULT_LEVEL, -2},
+        {"level 9", splib::CompressionOptions::BEST_COMPRESSION, -2},
+        {"sheets 1, others 9", splib::CompressionOptions::BEST_COMPRESSION,
+         splib::CompressionOptions::BEST_SPEED}
+    };
+    int count = sizeof(profiles) / sizeof(profiles[0]);
+    printf("4 sheets of %d rows and 8 columns\n", rows);
+    printf("%-12s %-22s %10s %13s %17s %8s\n",
+           "", "profile", "time", "throughput", "size", "stored");
+    const char* formats[] = {"xlsx", "xlsx-sst", "xlsx-compact", "ods"};
+    for (int f = 0; f < 4; f++) {
+        unsigned long stored = 0;
+        for (int i = 0; i < count; i++) {
+            unsigned long size = measure(sp, formats[f], profiles[i], stored);
+            if (i == 0) {
+                stored = size;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+// xmlescape.cpp : measures the escaping of cell text for XML by the
+// kernels of XmlText, against the former Strings::xmlize.
+//
+// Usage: xmlescape [megabytes]
+//
+// Each workload is a set of texts of about the size given, escaped a few
+// times; the time is the best processor time, and the throughput that of
+// the input. The output of each kernel is checked against xmlize first.
+
+#include "XmlText.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+using splib::XmlText;
+
+/** Texts to escape */
+typedef std::vector<std::string> Texts;
+
+/** Replaces all occurrences of a substring, as Strings::replace did. */
+std::string replace(const char* str, const char* substring,
+                    const char* replacement) {
+    std::string res = str;
+    std::string::size_type pos = 0;
+    size_t substringlen = strlen(substring);
+    size_t replacementlen = strlen(replacement);
+    for (;;) {
+        pos = res.find(substring, pos);
+        if (pos == std::string::npos) {
+            break;
+        }
+        res.replace(pos, substringlen, replacement);
+        pos += replacementlen;
+    }
+    return res;
+}
+
+/** Escapes text as Strings::xmlize did, one pass per character. */
+std::string xmlize(const char* str) {
+    std::string res = str;
+    res = replace(res.c_str(), "&", "&amp;");
+    res = replace(res.c_str(), "<", "&lt;");
+    res = replace(res.c_str(), ">", "&gt;");
+    res = replace(res.c_str(), "\"", "&quot;");
+    return res;
+}
+
+/** Escapes texts with xmlize into an output. */
+void escapeXmlize(const Texts& texts, std::string& out) {
+    out.clear();
+    for (size_t i = 0; i < texts.size(); i++) {
+        out += xmlize(texts[i].c_str());
+    }
+}
+
+/** Escapes texts with XmlText into an output, through a buffer. */
+void escapeXmlText(const Texts& texts, std::string& out) {
+    out.clear();
+    char buffer[16384];
+    char* used = buffer;
+    for (size_t i = 0; i < texts.size(); i++) {
+        const char* text = texts[i].data();
+        const char* end = text + texts[i].size();
+        for (;;) {
+            XmlText::escape(text, end, used, buffer + sizeof(buffer));
+            if (text == end) {
+                break;
+            }
+            out.append(buffer, used - buffer);
+            used = buffer;
+        }
+    }
+    out.append(buffer, used - buffer);
+}
+
+/**
+ * Builds texts from pieces, picked in turn, until their total size is
+ * reached.
+ */
+Texts workload(const char* const* pieces, int count, size_t size) {
+    Texts texts;
+    size_t total = 0;
+    for (int i = 0; total < size; i++) {
+        texts.push_back(pieces[i % count]);
+        total += texts.back().size();
+    }
+    return texts;
+}
+
+/** Retrieves the total size of texts. */
+size_t totalSize(const Texts& texts) {
+    size_t total = 0;
+    for (size_t i = 0; i < texts.size(); i++) {
+        total += texts[i].size();
+    }
+    return total;
+}
+
+/** Measures an escaping function and prints the results. */
+void measure(const char* name, void (*escape)(const Texts&, std::string&),
+             const Texts& texts, std::string& out) {
+    double best = -1;
+    for (int run = 0; run < 5; run++) {
+        clock_t start = clock();
+        escape(texts, out);
+        double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+        if (best < 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    printf("  %-8s %8.3f s %9.1f MB/s\n", name, best,
+           best > 0 ? totalSize(texts) / best / 1e6 : 0.0);
+}
+
+/**
+ * Program entry point.
+ */
+int main(int argc, char* argv[]) {
+    int megabytes = argc > 1 ? atoi(argv[1]) : 32;
+    if (megabytes <= 0) {
+        fprintf(stderr, "usage: xmlescape [megabytes]\n");
+        return 1;
+    }
+    size_t size = (size_t)megabytes * 1000000;
+    const char* shortCells[] = {
+        "North", "South", "Central", "Quarterly total", "2009-01-31",
+        "n/a", "Product A", "Customer 1042"};
+    const char* longCells[] = {
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+        "eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim "
+        "ad minim veniam, quis nostrud exercitation ullamco laboris."};
+    const char* markupCells[] = {
+        "Smith & Sons", "a < b", "\"quoted\"", "x > 0 && y < 1",
+        "Research & Development department <internal>"};
+    const char* utf8Cells[] = {
+        "Caf\xC3\xA9 cr\xC3\xA8me br\xC3\xBBl\xC3\xA9\x65",
+        "M\xC3\xBCnchen, Stra\xC3\x9F\x65 12",
+        "\xE6\x9D\xB1\xE4\xBA\xAC\xE9\x83\xBD \xE5\x8D\x83\xE4\xBB\xA3\xE7\x94\xB0",
+        "Price: 12 \xE2\x82\xAC"};
+    struct {
+        const char* name;
+        const char* const* pieces;
+        int count;
+    } workloads[] = {
+        {"short ASCII cells", shortCells, 8},
+        {"long ASCII cells", longCells, 1},
+        {"cells with markup", markupCells, 5},
+        {"UTF-8 cells", utf8Cells, 4}
+    };
+    const XmlText::Kernel kernels[] = {
+        XmlText::SCALAR, XmlText::SSE2, XmlText::AVX2};
+    const char* kernelNames[] = {"scalar", "SSE2", "AVX2"};
+    XmlText::Kernel best = XmlText::getKernel();
+    printf("%d MB per workload, kernel chosen: %s\n", megabytes,
+           kernelNames[best]);
+    for (int w = 0; w < 4; w++) {
+        Texts texts = workload(workloads[w].pieces, workloads[w].count, size);
+        printf("%s\n", workloads[w].name);
+        std::string expected;
+        std::string out;
+        escapeXmlize(texts, expected);
+        measure("xmlize", escapeXmlize, texts, out);
+        for (int k = 0; k < 3; k++) {
+            if (!XmlText::setKernel(kernels[k])) {
+                continue;
+            }
+            escapeXmlText(texts, out);
+            if (out != expected) {
+                fprintf(stderr, "%s: wrong output\n", kernelNames[k]);
+                return 1;
+            }
+            measure(kernelNames[k], escapeXmlText, texts, out);
+        }
+        XmlText::setKernel(best);
+    }
+    return 0;
+}
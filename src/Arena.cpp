@@ -0,0 +1,105 @@
+// File: Arena.cpp
+// Arena implementation file
+//
+
+#include "Arena.h"
+#include "splib.h"
+#include "splibint.h"
+
+#include <stdlib.h>
+#include <new>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace splib {
+
+Arena::Arena() : top(0), end(0), owner(0), closed(false) {
+    for (int i = 0; i < CLASS_COUNT; i++) {
+        freeLists[i] = 0;
+    }
+}
+
+Arena::~Arena() {
+    for (std::vector<Page*>::size_type i = 0; i < pages.size(); i++) {
+#ifdef _MSC_VER
+        _aligned_free(pages[i]);
+#else
+        ::free(pages[i]);
+#endif
+    }
+}
+
+void* Arena::allocate(size_t size) {
+    if (size == 0 || size > MAX_SIZE) {
+        throw IllegalArgumentException();
+    }
+    int c = sizeClass(size);
+    if (freeLists[c] != 0) {
+        Free* f = freeLists[c];
+        freeLists[c] = f->next;
+        return f;
+    }
+    size_t rounded = (c + 1) * GRANULE;
+    if (top == 0 || (size_t)(end - top) < rounded) {
+        newPage();
+    }
+    void* p = top;
+    top += rounded;
+    return p;
+}
+
+void Arena::release(void* p, size_t size) {
+    int c = sizeClass(size);
+    Free* f = (Free*)p;
+    f->next = freeLists[c];
+    freeLists[c] = f;
+}
+
+int Arena::pageCount() const {
+    return (int)pages.size();
+}
+
+void* Arena::getOwner() const {
+    return owner;
+}
+
+void Arena::setOwner(void* o) {
+    owner = o;
+}
+
+void Arena::close() {
+    closed = true;
+}
+
+bool Arena::isClosed() const {
+    return closed;
+}
+
+Arena& Arena::of(const void* p) {
+    size_t address = (size_t)p & ~(size_t)(PAGE_SIZE - 1);
+    return *((Page*)address)->arena;
+}
+
+void Arena::newPage() {
+    pages.push_back(0);
+    void* p;
+#ifdef _MSC_VER
+    p = _aligned_malloc(PAGE_SIZE, PAGE_SIZE);
+#else
+    if (posix_memalign(&p, PAGE_SIZE, PAGE_SIZE) != 0) {
+        p = 0;
+    }
+#endif
+    if (p == 0) {
+        pages.pop_back();
+        throw std::bad_alloc();
+    }
+    pages.back() = (Page*)p;
+    Page* page = (Page*)p;
+    page->arena = this;
+    top = (char*)p + GRANULE;
+    end = (char*)p + PAGE_SIZE;
+}
+
+}
@@ -0,0 +1,136 @@
+// File: Arena.h
+// Arena declaration file
+//
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <stddef.h>
+
+namespace splib {
+
+/**
+ * A memory allocator for small objects that all share the lifetime of
+ * a table. Memory is carved from large pages aligned to their own size;
+ * released blocks are kept in free lists, one per size class, and reused
+ * by subsequent allocations. All pages are returned to the system at once
+ * when the arena is destroyed, so individual objects do not need to be
+ * released if the arena goes away with them.
+ * <p>
+ * Since the pages are aligned, the arena that owns a block can be found
+ * from the address of the block alone (see <code>of()</code>). Objects
+ * use this to reach the owner of the arena without storing a pointer.
+ */
+class Arena {
+    public:
+        /** The size and alignment of a page in bytes. */
+        enum {PAGE_SIZE = 65536};
+
+        /** The largest block that can be allocated from the arena. */
+        enum {MAX_SIZE = 1024};
+
+    public:
+        /** Creates a new, empty arena. */
+        Arena();
+
+        /** Returns all pages to the system. */
+        ~Arena();
+
+        /**
+         * Allocates a block of memory.
+         * @param size the size of the block; must not be greater than
+         *        <code>MAX_SIZE</code>
+         * @return a pointer to the block, aligned to 8 bytes
+         */
+        void* allocate(size_t size);
+
+        /**
+         * Releases a block of memory for reuse by the arena.
+         * @param p a pointer to the block
+         * @param size the size that was passed to <code>allocate()</code>
+         */
+        void release(void* p, size_t size);
+
+        /** Returns the number of pages allocated by the arena. */
+        int pageCount() const;
+
+        /** Retrieves the object that owns the arena. */
+        void* getOwner() const;
+
+        /** Sets the object that owns the arena. */
+        void setOwner(void* owner);
+
+        /**
+         * Announces that the arena is about to be destroyed together
+         * with everything allocated from it. Objects that hold no
+         * resources outside the arena may then be dropped without
+         * being destroyed one by one.
+         */
+        void close();
+
+        /** Checks whether <code>close()</code> has been called. */
+        bool isClosed() const;
+
+        /**
+         * Returns the arena that owns a block.
+         * @param p a pointer to the block or into it
+         */
+        static Arena& of(const void* p);
+
+    private:
+        /** The header stored at the start of each page */
+        struct Page {
+            /** The arena that owns the page */
+            Arena* arena;
+        };
+
+        /** A released block, linked into the free list of its size class */
+        struct Free {
+            /** The next block in the list */
+            Free* next;
+        };
+
+        /** The alignment and the granularity of block sizes */
+        enum {GRANULE = 8};
+
+        /** The number of size classes */
+        enum {CLASS_COUNT = MAX_SIZE / GRANULE};
+
+        /** Returns the size class of a block size. */
+        static int sizeClass(size_t size) {
+            return (int)((size + GRANULE - 1) / GRANULE) - 1;
+        }
+
+        /** Allocates a new page and makes it the current one. */
+        void newPage();
+
+        /** Copying is not supported. */
+        Arena(const Arena&);
+
+        /** Assignment is not supported. */
+        Arena& operator = (const Arena&);
+
+    private:
+        /** All pages of the arena */
+        std::vector<Page*> pages;
+
+        /** The first unused byte of the current page */
+        char* top;
+
+        /** The end of the current page */
+        char* end;
+
+        /** The object that owns the arena */
+        void* owner;
+
+        /** Whether the arena is about to be destroyed */
+        bool closed;
+
+        /** The free lists, one per size class */
+        Free* freeLists[CLASS_COUNT];
+};
+
+}
+
+#endif // ARENA_H
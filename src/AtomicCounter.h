@@ -0,0 +1,42 @@
+// File: AtomicCounter.h
+// AtomicCounter declaration file
+//
+
+#ifndef ATOMICCOUNTER_H
+#define ATOMICCOUNTER_H
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace splib {
+
+/**
+ * A counter that threads can increment at the same time. Each call of
+ * <code>next()</code> returns a different value.
+ */
+class AtomicCounter {
+    public:
+        /**
+         * Creates a new instance of <code>AtomicCounter</code>.
+         * @param value the first value to return
+         */
+        explicit AtomicCounter(long value = 0) : counter(value) {}
+
+        /** Increments the counter and returns its previous value. */
+        long next() {
+#ifdef _MSC_VER
+            return _InterlockedIncrement(&counter) - 1;
+#else
+            return __sync_fetch_and_add(&counter, 1);
+#endif
+        }
+
+    private:
+        /** The next value to return */
+        volatile long counter;
+};
+
+}
+
+#endif // ATOMICCOUNTER_H
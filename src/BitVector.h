@@ -0,0 +1,121 @@
+// File: BitVector.h
+// BitVector declaration file
+//
+
+#ifndef BITVECTOR_H
+#define BITVECTOR_H
+
+#include "Bits.h"
+
+#include <vector>
+
+namespace splib {
+
+/**
+ * A growable set of non-negative integers stored as a bitmap. The bitmap
+ * grows on demand when bits are set; testing or resetting bits beyond its
+ * end is allowed.
+ */
+class BitVector {
+    public:
+        /**
+         * Checks whether a bit is set.
+         * @param index the index of the bit
+         */
+        bool test(int index) const {
+            int word = index >> 6;
+            if (word >= (int)words.size()) {
+                return false;
+            }
+            return (words[word] >> (index & 63)) & 1;
+        }
+
+        /**
+         * Sets a bit, growing the bitmap if necessary.
+         * @param index the index of the bit
+         */
+        void set(int index) {
+            int word = index >> 6;
+            if (word >= (int)words.size()) {
+                words.resize(word + 1, 0);
+            }
+            words[word] |= ((Bits::Mask)1) << (index & 63);
+        }
+
+        /**
+         * Resets a bit.
+         * @param index the index of the bit
+         */
+        void reset(int index) {
+            int word = index >> 6;
+            if (word < (int)words.size()) {
+                words[word] &= ~(((Bits::Mask)1) << (index & 63));
+            }
+        }
+
+        /**
+         * Finds the first bit set at or after a specific index.
+         * @param index the index to start from
+         * @return the index of the bit found or <code>-1</code>
+         */
+        int next(int index) const {
+            int word = index >> 6;
+            if (index < 0 || word >= (int)words.size()) {
+                return -1;
+            }
+            Bits::Mask m = words[word] & ~Bits::below(index & 63);
+            while (m == 0) {
+                if (++word == (int)words.size()) {
+                    return -1;
+                }
+                m = words[word];
+            }
+            return (word << 6) + Bits::lowest(m);
+        }
+
+        /**
+         * Finds the last bit set at or before a specific index.
+         * @param index the index to start from
+         * @return the index of the bit found or <code>-1</code>
+         */
+        int previous(int index) const {
+            if (index < 0 || words.empty()) {
+                return -1;
+            }
+            int word = index >> 6;
+            Bits::Mask m;
+            if (word >= (int)words.size()) {
+                word = (int)words.size() - 1;
+                m = words[word];
+            } else if ((index & 63) == 63) {
+                m = words[word];
+            } else {
+                m = words[word] & Bits::below((index & 63) + 1);
+            }
+            while (m == 0) {
+                if (--word < 0) {
+                    return -1;
+                }
+                m = words[word];
+            }
+            return (word << 6) + Bits::highest(m);
+        }
+
+        /** Returns the index of the first bit set or <code>-1</code>. */
+        int first() const {
+            return next(0);
+        }
+
+        /** Returns the index of the last bit set or <code>-1</code>. */
+        int last() const {
+            return previous((int)words.size() * 64 - 1);
+        }
+
+    private:
+        /** The words of the bitmap */
+        std::vector<Bits::Mask> words;
+};
+
+}
+
+#endif // BITVECTOR_H
@@ -0,0 +1,90 @@
+// File: Bits.h
+// Bits declaration file
+//
+
+#ifndef BITS_H
+#define BITS_H
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace splib {
+
+/** Static methods for manipulating 64-bit masks. */
+class Bits {
+    public:
+        /** A 64-bit mask. */
+        typedef unsigned long long Mask;
+
+        /** Returns the number of bits set in a mask. */
+        static int count(Mask m) {
+#if defined(__GNUC__)
+            return __builtin_popcountll(m);
+#else
+            m = m - ((m >> 1) & 0x5555555555555555ULL);
+            m = (m & 0x3333333333333333ULL) + ((m >> 2) & 0x3333333333333333ULL);
+            m = (m + (m >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return (int)((m * 0x0101010101010101ULL) >> 56);
+#endif
+        }
+
+        /**
+         * Returns the position of the lowest bit set in a mask.
+         * The mask must not be 0.
+         */
+        static int lowest(Mask m) {
+#if defined(__GNUC__)
+            return __builtin_ctzll(m);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long res;
+            _BitScanForward64(&res, m);
+            return (int)res;
+#else
+            int res = 0;
+            while ((m & 1) == 0) {
+                m >>= 1;
+                res++;
+            }
+            return res;
+#endif
+        }
+
+        /**
+         * Returns the position of the highest bit set in a mask.
+         * The mask must not be 0.
+         */
+        static int highest(Mask m) {
+#if defined(__GNUC__)
+            return 63 - __builtin_clzll(m);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long res;
+            _BitScanReverse64(&res, m);
+            return (int)res;
+#else
+            int res = 0;
+            while (m >>= 1) {
+                res++;
+            }
+            return res;
+#endif
+        }
+
+        /** Returns a mask with all bits below the specified position set. */
+        static Mask below(int bit) {
+            return (((Mask)1) << bit) - 1;
+        }
+
+        /**
+         * Returns a mask with the bits from position <code>from</code>
+         * up to but not including position <code>to</code> set.
+         */
+        static Mask range(int from, int to) {
+            Mask upper = to == 64 ? ~(Mask)0 : below(to);
+            return upper & ~below(from);
+        }
+};
+
+}
+
+#endif // BITS_H
@@ -43,12 +43,18 @@ int ByteArray::size() const {
     return arraySize;
 }
 
+void ByteArray::reserve(int s) {
+    if (s > bufferSize) {
+        unsigned char* tmp = new unsigned char[s];
+        memcpy(tmp, buffer, arraySize);
+        delete [] buffer;
+        buffer = tmp;
+        bufferSize = s;
+    }
+}
+
 void ByteArray::extend(int s) {
-    bufferSize = s * 2;
-    unsigned char* tmp = new unsigned char[bufferSize];
-    memcpy(tmp, buffer, arraySize);
-    delete [] buffer;
-    buffer = tmp;
+    reserve(s * 2);
 }
 
 }
@@ -47,6 +47,13 @@ class ByteArray {
          */
         int size() const;
 
+        /**
+         * Makes sure the array can grow to a number of bytes without
+         * reallocating its buffer.
+         * @param s the number of bytes
+         */
+        void reserve(int s);
+
     private:
         /** Extends the internal buffer to the given number of bytes. */
         void extend(int s);
@@ -0,0 +1,23 @@
+// File: CallbackSink.cpp
+// CallbackSink implementation file
+//
+
+#include "splib.h"
+#include "splibint.h"
+
+namespace splib {
+
+CallbackSink::CallbackSink(Callback callback, void* context)
+        : callback(callback), context(context) {
+    if (callback == 0) {
+        throw IllegalArgumentException();
+    }
+}
+
+void CallbackSink::write(const void* data, unsigned length) {
+    if (length > 0 && !callback(context, data, length)) {
+        throw IOException(_T("error writing to callback"));
+    }
+}
+
+}
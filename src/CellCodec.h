@@ -0,0 +1,76 @@
+// File: CellCodec.h
+// CellCodec declaration file
+//
+
+#ifndef CELLCODEC_H
+#define CELLCODEC_H
+
+#include "splib.h"
+
+namespace splib {
+
+/**
+ * Static methods for packing cell attributes into compact integers.
+ * A cell tag holds the cell type in bits 0-2, the horizontal alignment
+ * in bits 3-5, and the vertical alignment in bits 6-7. Dates and times
+ * are packed into a single <code>int</code> each.
+ */
+class CellCodec {
+    public:
+        /** Extracts the cell type from a tag. */
+        static Cell::Type type(int tag) {
+            return (Cell::Type)(tag & 7);
+        }
+
+        /** Extracts the horizontal alignment from a tag. */
+        static Cell::HAlignment hAlignment(int tag) {
+            return (Cell::HAlignment)((tag >> 3) & 7);
+        }
+
+        /** Extracts the vertical alignment from a tag. */
+        static Cell::VAlignment vAlignment(int tag) {
+            return (Cell::VAlignment)((tag >> 6) & 3);
+        }
+
+        /** Returns a copy of a tag with the cell type replaced. */
+        static int withType(int tag, Cell::Type type) {
+            return (tag & ~7) | type;
+        }
+
+        /** Returns a copy of a tag with the horizontal alignment replaced. */
+        static int withHAlignment(int tag, Cell::HAlignment h) {
+            return (tag & ~(7 << 3)) | (h << 3);
+        }
+
+        /** Returns a copy of a tag with the vertical alignment replaced. */
+        static int withVAlignment(int tag, Cell::VAlignment v) {
+            return (tag & ~(3 << 6)) | (v << 6);
+        }
+
+        /** Packs a date into an integer. */
+        static int packDate(const Date& date) {
+            return (date.getYear() << 9) | (date.getMonth() << 5) |
+                   date.getDay();
+        }
+
+        /** Unpacks a date packed with <code>packDate()</code>. */
+        static Date unpackDate(int packed) {
+            return Date(packed >> 9, (packed >> 5) & 15, packed & 31);
+        }
+
+        /** Packs a time into the number of milliseconds since midnight. */
+        static int packTime(const Time& time) {
+            return ((time.getHours() * 60 + time.getMinutes()) * 60 +
+                    time.getSeconds()) * 1000 + time.getMillis();
+        }
+
+        /** Unpacks a time packed with <code>packTime()</code>. */
+        static Time unpackTime(int packed) {
+            return Time(packed / 3600000, packed / 60000 % 60,
+                        packed / 1000 % 60, packed % 1000);
+        }
+};
+
+}
+
+#endif // CELLCODEC_H
@@ -3,6 +3,8 @@
 //
 
 #include "CellImpl.h"
+#include "TableImpl.h"
+#include "CellCodec.h"
 #include "Formulas.h"
 #include "IndexLimits.h"
 #include "splibint.h"
@@ -10,79 +12,90 @@
 namespace splib {
 
 CellImpl::CellImpl() {
-    type = NONE;
-    hAlignment = HADEFAULT;
-    vAlignment = VADEFAULT;
+    tag = CellCodec::withType(0, NONE);
+    value.doubleValue = 0;
 }
 
 CellImpl::~CellImpl() {
+    // the collection records the removal in the statistics
+    Type type = getType();
+    if (type == TEXT || type == FORMULA) {
+        table().releaseString(value.intValue);
+    }
 }
 
 const _TCHAR* CellImpl::getText() const {
-    if (type != TEXT) {
+    if (getType() != TEXT) {
         throw IllegalStateException();
     }
-    return text.c_str();
+    return table().string(value.intValue);
 }
 
 void CellImpl::setText(const _TCHAR* t) {
-    type = TEXT;
-    text = t ? t : _T("");
+    // the new text is added first, since it may be the text of the cell
+    int id = table().addString(t ? t : _T(""));
+    releaseString();
+    value.intValue = id;
+    setType(TEXT);
 }
 
 long CellImpl::getLong() const  {
-    if (type != LONG) {
+    if (getType() != LONG) {
         throw IllegalStateException();
     }
     return value.longValue;
 }
 
 void CellImpl::setLong(long l)  {
-    type = LONG;
+    releaseString();
     value.longValue = l;
+    setType(LONG);
 }
 
 double CellImpl::getDouble() const {
-    if (type != DOUBLE) {
+    if (getType() != DOUBLE) {
         throw IllegalStateException();
     }
     return value.doubleValue;
 }
 
 void CellImpl::setDouble(double d) {
-    type = DOUBLE;
+    releaseString();
     value.doubleValue = d;
+    setType(DOUBLE);
 }
 
-const Date& CellImpl::getDate() const {
-    if (type != DATE) {
+Date CellImpl::getDate() const {
+    if (getType() != DATE) {
         throw IllegalStateException();
     }
-    return date;
+    return CellCodec::unpackDate(value.intValue);
 }
 
 void CellImpl::setDate(const Date& d) {
-    type = DATE;
-    date = d;
+    releaseString();
+    value.intValue = CellCodec::packDate(d);
+    setType(DATE);
 }
 
-const Time& CellImpl::getTime() const {
-    if (type != TIME) {
+Time CellImpl::getTime() const {
+    if (getType() != TIME) {
         throw IllegalStateException();
     }
-    return time;
+    return CellCodec::unpackTime(value.intValue);
 }
 
 void CellImpl::setTime(const Time& t) {
-    type = TIME;
-    time = t;
+    releaseString();
+    value.intValue = CellCodec::packTime(t);
+    setType(TIME);
 }
 
 const _TCHAR* CellImpl::getFormula() const {
-    if (type != FORMULA) {
+    if (getType() != FORMULA) {
         throw IllegalStateException();
     }
-    return formula.c_str();
+    return table().string(value.intValue);
 }
 
 void CellImpl::setFormula(const _TCHAR* f) {
@@ -96,32 +109,78 @@ void CellImpl::setFormula(const _TCHAR* f) {
     if (!IndexLimits::validate(c2, r2)) {
         throw IllegalArgumentException();
     }
-    type = FORMULA;
-    formula = f;
+    int id = table().addString(f);
+    releaseString();
+    value.intValue = id;
+    setType(FORMULA);
 }
 
 void CellImpl::clear() {
-    type = NONE;
+    releaseString();
+    setType(NONE);
+}
+
+void CellImpl::setValue(const CellValue& v) {
+    switch (v.getType()) {
+        case TEXT:
+            CellImpl::setText(v.getText());
+            break;
+        case LONG:
+            CellImpl::setLong(v.getLong());
+            break;
+        case DOUBLE:
+            CellImpl::setDouble(v.getDouble());
+            break;
+        case DATE:
+            CellImpl::setDate(v.getDate());
+            break;
+        case TIME:
+            CellImpl::setTime(v.getTime());
+            break;
+        case FORMULA:
+            CellImpl::setFormula(v.getFormula());
+            break;
+        default:
+            break;
+    }
 }
 
 Cell::Type CellImpl::getType() const {
-    return type;
+    return CellCodec::type(tag);
 }
 
 CellImpl::HAlignment CellImpl::getHAlignment() const {
-    return hAlignment;
+    return CellCodec::hAlignment(tag);
 }
 
 void CellImpl::setHAlignment(HAlignment h) {
-    hAlignment = h;
+    tag = CellCodec::withHAlignment(tag, h);
 }
 
 CellImpl::VAlignment CellImpl::getVAlignment() const {
-    return vAlignment;
+    return CellCodec::vAlignment(tag);
 }
 
 void CellImpl::setVAlignment(VAlignment v) {
-    vAlignment = v;
+    tag = CellCodec::withVAlignment(tag, v);
+}
+
+TableImpl& CellImpl::table() const {
+    return *(TableImpl*)Arena::of(this).getOwner();
+}
+
+void CellImpl::releaseString() {
+    Type type = getType();
+    if (type == TEXT || type == FORMULA) {
+        table().releaseString(value.intValue);
+        // keep the cell consistent in case adding a new string fails
+        setType(NONE);
+    }
+}
+
+void CellImpl::setType(Type type) {
+    table().cellStatistics().typeChanged(getType(), type);
+    tag = CellCodec::withType(tag, type);
 }
 
 }
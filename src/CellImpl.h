@@ -9,7 +9,19 @@
 
 namespace splib {
 
-/** Default implementation of the <code>Cell</code> interface. */
+// forward declarations
+class TableImpl;
+
+/**
+ * Default implementation of the <code>Cell</code> interface.
+ * <p>
+ * The cell is stored as an 8-byte payload and a tag that packs the cell
+ * type and the alignments (see <code>CellCodec</code>). Longs and doubles
+ * are kept in the payload as they are, dates and times in packed form,
+ * and texts and formulas as ids in the string pool of the spreadsheet.
+ * The cell must be allocated from the <code>Arena</code> of its table,
+ * which is how it finds the table without storing a pointer to it.
+ */
 class CellImpl : public Cell {
     public:
         /** Creates a new instance of <code>CellImpl</code>. */
@@ -37,13 +49,13 @@ class CellImpl : public Cell {
         virtual void setDouble(double d);
 
         // inherit doc
-        virtual const Date& getDate() const;
+        virtual Date getDate() const;
 
         // inherit doc
         virtual void setDate(const Date& date);
 
         // inherit doc
-        virtual const Time& getTime() const;
+        virtual Time getTime() const;
 
         // inherit doc
         virtual void setTime(const Time& time);
@@ -72,36 +84,36 @@ class CellImpl : public Cell {
         // inherit doc
         virtual void setVAlignment(VAlignment vAlignment);
 
+        /**
+         * Sets the cell to a value of any type. A value of type
+         * <code>NONE</code> leaves the cell untouched.
+         * @param value the value
+         */
+        void setValue(const CellValue& value);
+
     private:
-        /** The cell type */
-        Type type;
+        /** Returns the table that owns the cell. */
+        TableImpl& table() const;
+
+        /** Releases the string held by the cell, if any. */
+        void releaseString();
 
-        /** The cell text */
-        std::basic_string<_TCHAR> text;
+        /** Sets the cell type, keeping the alignments. */
+        void setType(Type type);
 
-        /** The set of possible simple values of the cell */
+    private:
+        /** The set of possible values of the cell */
         union Value {
             long longValue;
             double doubleValue;
+            int intValue;
         };
 
-        /** The union of simple values of the cell */
+        /** The value of the cell */
         Value value;
 
-        /** The cell date */
-        Date date;
-
-        /** The cell time */
-        Time time;
-
-        /** The cell formula */
-        std::basic_string<_TCHAR> formula;
-
-        /** The horizontal alignment of the cell */
-        HAlignment hAlignment;
-
-        /** The vertical alignment of the cell */
-        VAlignment vAlignment;
+        /** The cell type and alignments */
+        int tag;
 };
 
 }
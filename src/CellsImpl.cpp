@@ -3,31 +3,99 @@
 //
 
 #include "CellsImpl.h"
+#include "TableImpl.h"
 #include "IndexLimits.h"
 #include "Util.h"
 #include "splibint.h"
 
 namespace splib {
 
+class CellsImpl::Added {
+    public:
+        Added(TableStatisticsImpl& stats) : stats(stats) {}
+
+        void operator () (int column) {
+            stats.cellAdded(column);
+        }
+
+    private:
+        /** The statistics to update */
+        TableStatisticsImpl& stats;
+};
+
+class CellsImpl::Removed {
+    public:
+        Removed(TableStatisticsImpl& stats) : stats(stats) {}
+
+        void operator () (int column, Cell& cell) {
+            stats.cellRemoved(column, cell.getType());
+        }
+
+    private:
+        /** The statistics to update */
+        TableStatisticsImpl& stats;
+};
+
+CellsImpl::CellsImpl(Arena& arena) : collection(arena, true) {
+}
+
+CellsImpl::~CellsImpl() {
+    // the statistics go away with the table once the arena is closed
+    if (!Arena::of(this).isClosed()) {
+        Removed removed(statistics());
+        collection.forEach(removed);
+    }
+}
+
 Cell& CellsImpl::get(int index) {
     if (!IndexLimits::validateColumn(index)) {
         throw IllegalArgumentException();
     }
-    return collection.get(index);
+    int n = collection.size();
+    Cell& cell = collection.get(index);
+    if (collection.size() != n) {
+        statistics().cellAdded(index);
+    }
+    return cell;
+}
+
+void CellsImpl::getRange(int first, int n, Cell** out) {
+    Added added(statistics());
+    collection.getRange(first, n, out, added);
 }
 
-bool CellsImpl::contains(int index) {
+bool CellsImpl::contains(int index) const {
     if (!IndexLimits::validateColumn(index)) {
         throw IllegalArgumentException();
     }
     return collection.contains(index);
 }
 
+const Cell* CellsImpl::find(int index) const {
+    if (!IndexLimits::validateColumn(index)) {
+        throw IllegalArgumentException();
+    }
+    return collection.find(index);
+}
+
+int CellsImpl::next(int index) const {
+    return collection.next(index);
+}
+
 void CellsImpl::remove(int index) {
     if (!IndexLimits::validateColumn(index)) {
         throw IllegalArgumentException();
     }
-    return collection.remove(index);
+    Cell* cell = collection.lookup(index);
+    if (cell != 0) {
+        statistics().cellRemoved(index, cell->getType());
+        collection.remove(index);
+    }
+}
+
+void CellsImpl::removeRange(int first, int last) {
+    Removed removed(statistics());
+    collection.removeRange(first, last, removed);
 }
 
 int CellsImpl::size() const {
@@ -50,4 +118,8 @@ CellsImpl::Entry CellsImpl::last() {
     return collection.last();
 }
 
+TableStatisticsImpl& CellsImpl::statistics() {
+    return ((TableImpl*)Arena::of(this).getOwner())->cellStatistics();
+}
+
 }
@@ -8,17 +8,36 @@
 #include "splib.h"
 #include "IndexedCollectionImpl.h"
 #include "CellImpl.h"
+#include "TableStatisticsImpl.h"
 
 namespace splib {
 
-/** Default implementation of the <code>Cells</code> interface. */
+/**
+ * Default implementation of the <code>Cells</code> interface. The cells
+ * are reported to the statistics of the table that owns the arena.
+ */
 class CellsImpl : public Cells {
     public:
+        /**
+         * Creates a new instance of <code>CellsImpl</code>.
+         * @param arena the arena to allocate the cells from
+         */
+        CellsImpl(Arena& arena);
+
+        /** Destructor */
+        virtual ~CellsImpl();
+
         // inherit doc
         virtual Cell& get(int index);
 
         // inherit doc
-        virtual bool contains(int index);
+        virtual bool contains(int index) const;
+
+        // inherit doc
+        virtual const Cell* find(int index) const;
+
+        // inherit doc
+        virtual int next(int index) const;
 
         // inherit doc
         virtual void remove(int index);
@@ -38,6 +57,42 @@ class CellsImpl : public Cells {
         // inherit doc
         virtual Entry last();
 
+        /**
+         * Retrieves the cells with consecutive column indices, creating
+         * the missing ones. The indices are not validated.
+         * @param first the column index of the first cell
+         * @param n the number of cells
+         * @param out an array that receives the <code>n</code> cells
+         */
+        void getRange(int first, int n, Cell** out);
+
+        /**
+         * Removes the cells with column indices in a range. The indices
+         * are not validated.
+         * @param first the first column index
+         * @param last the last column index
+         */
+        void removeRange(int first, int last);
+
+        /**
+         * Calls a function for each cell in the order of the column
+         * indices, as <code>f(column, cell)</code>.
+         */
+        template<class F>
+        void forEach(F& f) {
+            collection.forEach(f);
+        }
+
+    private:
+        /** Records the creation of cells in the statistics. */
+        class Added;
+
+        /** Records the removal of cells from the statistics. */
+        class Removed;
+
+        /** Returns the statistics of the table that owns the cells. */
+        TableStatisticsImpl& statistics();
+
     private:
         /** The object used to manage the collection of cells */
         IndexedCollectionImpl<Cell,CellImpl> collection;
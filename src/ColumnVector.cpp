@@ -0,0 +1,34 @@
+// File: ColumnVector.cpp
+// ColumnVector implementation file
+//
+
+#include "ColumnVector.h"
+#include "splibint.h"
+
+namespace splib {
+
+ColumnVector::ColumnVector() : count(0) {
+}
+
+bool ColumnVector::insert(int row) {
+    if (valid.test(row)) {
+        return false;
+    }
+    valid.set(row);
+    tags.at(row) = 0;
+    values.at(row).doubleValue = 0;
+    count++;
+    return true;
+}
+
+bool ColumnVector::remove(int row) {
+    if (!valid.test(row)) {
+        return false;
+    }
+    valid.reset(row);
+    tags[row] = 0;
+    count--;
+    return true;
+}
+
+}
@@ -0,0 +1,119 @@
+// File: ColumnVector.h
+// ColumnVector declaration file
+//
+
+#ifndef COLUMNVECTOR_H
+#define COLUMNVECTOR_H
+
+#include "BitVector.h"
+#include "PagedArray.h"
+
+namespace splib {
+
+/**
+ * The storage of a single column of a columnar table. The column keeps
+ * an array of 8-byte values and an array of one-byte cell tags (see
+ * <code>CellCodec</code>), both indexed by row, plus a validity bitmap
+ * that tells which rows hold a cell. The arrays are paged, so a sparse
+ * column only stores the pages of rows that have held a cell.
+ */
+class ColumnVector {
+    public:
+        /** The set of values a cell can hold. */
+        union Value {
+            /** A long integer */
+            long longValue;
+            /** A double precision floating point number */
+            double doubleValue;
+            /** A packed date or time, or a string handle */
+            int intValue;
+        };
+
+    public:
+        /** Creates a new, empty instance of <code>ColumnVector</code>. */
+        ColumnVector();
+
+        /**
+         * Checks whether the column has a cell at a specific row.
+         * @param row the row index
+         */
+        bool contains(int row) const {
+            return valid.test(row);
+        }
+
+        /**
+         * Creates an empty cell at a specific row unless it exists.
+         * @param row the row index
+         * @return <code>true</code> if a new cell has been created
+         */
+        bool insert(int row);
+
+        /**
+         * Removes the cell at a specific row if it exists. The caller
+         * is responsible for releasing the resources of the cell.
+         * @param row the row index
+         * @return <code>true</code> if a cell has been removed
+         */
+        bool remove(int row);
+
+        /**
+         * Retrieves the tag of a cell. Rows that do not hold a cell
+         * have a tag of <code>0</code>.
+         * @param row the row index; the row must have held a cell
+         */
+        int tag(int row) const {
+            return tags[row];
+        }
+
+        /**
+         * Sets the tag of a cell.
+         * @param row the row index; the row must have held a cell
+         * @param tag the new tag
+         */
+        void setTag(int row, int tag) {
+            tags[row] = (unsigned char)tag;
+        }
+
+        /**
+         * Provides access to the value of a cell.
+         * @param row the row index; the row must have held a cell
+         */
+        Value& value(int row) {
+            return values[row];
+        }
+
+        /**
+         * Provides read-only access to the value of a cell.
+         * @param row the row index; the row must have held a cell
+         */
+        const Value& value(int row) const {
+            return values[row];
+        }
+
+        /** Returns the number of cells in the column. */
+        int size() const {
+            return count;
+        }
+
+        /** Returns the validity bitmap of the column. */
+        const BitVector& validity() const {
+            return valid;
+        }
+
+    private:
+        /** The validity bitmap */
+        BitVector valid;
+
+        /** The cell tags */
+        PagedArray<unsigned char> tags;
+
+        /** The cell values */
+        PagedArray<Value> values;
+
+        /** The number of cells */
+        int count;
+};
+
+}
+
+#endif // COLUMNVECTOR_H
@@ -0,0 +1,159 @@
+// File: ColumnarCell.cpp
+// ColumnarCell implementation file
+//
+
+#include "ColumnarCell.h"
+#include "ColumnarTableImpl.h"
+#include "CellCodec.h"
+#include "Formulas.h"
+#include "IndexLimits.h"
+#include "splibint.h"
+
+namespace splib {
+
+ColumnarCell::ColumnarCell() : table(0), column(0), row(0) {
+}
+
+void ColumnarCell::bind(ColumnarTableImpl* t, int c, int r) {
+    table = t;
+    column = c;
+    row = r;
+}
+
+const _TCHAR* ColumnarCell::getText() const {
+    if (getType() != TEXT) {
+        throw IllegalStateException();
+    }
+    int handle = table->columnVector(column).value(row).intValue;
+    return table->string(handle);
+}
+
+void ColumnarCell::setText(const _TCHAR* t) {
+    // the new text is added first, since it may be the text of the cell
+    int id = table->addString(t ? t : _T(""));
+    releaseString();
+    ColumnVector& v = table->columnVector(column);
+    v.value(row).intValue = id;
+    table->setType(column, row, TEXT);
+}
+
+long ColumnarCell::getLong() const {
+    if (getType() != LONG) {
+        throw IllegalStateException();
+    }
+    return table->columnVector(column).value(row).longValue;
+}
+
+void ColumnarCell::setLong(long l) {
+    releaseString();
+    ColumnVector& v = table->columnVector(column);
+    v.value(row).longValue = l;
+    table->setType(column, row, LONG);
+}
+
+double ColumnarCell::getDouble() const {
+    if (getType() != DOUBLE) {
+        throw IllegalStateException();
+    }
+    return table->columnVector(column).value(row).doubleValue;
+}
+
+void ColumnarCell::setDouble(double d) {
+    releaseString();
+    ColumnVector& v = table->columnVector(column);
+    v.value(row).doubleValue = d;
+    table->setType(column, row, DOUBLE);
+}
+
+Date ColumnarCell::getDate() const {
+    if (getType() != DATE) {
+        throw IllegalStateException();
+    }
+    return CellCodec::unpackDate(
+        table->columnVector(column).value(row).intValue);
+}
+
+void ColumnarCell::setDate(const Date& d) {
+    releaseString();
+    ColumnVector& v = table->columnVector(column);
+    v.value(row).intValue = CellCodec::packDate(d);
+    table->setType(column, row, DATE);
+}
+
+Time ColumnarCell::getTime() const {
+    if (getType() != TIME) {
+        throw IllegalStateException();
+    }
+    return CellCodec::unpackTime(
+        table->columnVector(column).value(row).intValue);
+}
+
+void ColumnarCell::setTime(const Time& t) {
+    releaseString();
+    ColumnVector& v = table->columnVector(column);
+    v.value(row).intValue = CellCodec::packTime(t);
+    table->setType(column, row, TIME);
+}
+
+const _TCHAR* ColumnarCell::getFormula() const {
+    if (getType() != FORMULA) {
+        throw IllegalStateException();
+    }
+    int handle = table->columnVector(column).value(row).intValue;
+    return table->string(handle);
+}
+
+void ColumnarCell::setFormula(const _TCHAR* f) {
+    int c1, r1, c2, r2;
+    if (!Formulas::parse(f, c1, r1, c2, r2)) {
+        throw IllegalArgumentException();
+    }
+    if (!IndexLimits::validate(c1, r1)) {
+        throw IllegalArgumentException();
+    }
+    if (!IndexLimits::validate(c2, r2)) {
+        throw IllegalArgumentException();
+    }
+    int id = table->addString(f);
+    releaseString();
+    ColumnVector& v = table->columnVector(column);
+    v.value(row).intValue = id;
+    table->setType(column, row, FORMULA);
+}
+
+void ColumnarCell::clear() {
+    releaseString();
+    table->setType(column, row, NONE);
+}
+
+Cell::Type ColumnarCell::getType() const {
+    return CellCodec::type(table->columnVector(column).tag(row));
+}
+
+Cell::HAlignment ColumnarCell::getHAlignment() const {
+    return CellCodec::hAlignment(table->columnVector(column).tag(row));
+}
+
+void ColumnarCell::setHAlignment(HAlignment h) {
+    ColumnVector& v = table->columnVector(column);
+    v.setTag(row, CellCodec::withHAlignment(v.tag(row), h));
+}
+
+Cell::VAlignment ColumnarCell::getVAlignment() const {
+    return CellCodec::vAlignment(table->columnVector(column).tag(row));
+}
+
+void ColumnarCell::setVAlignment(VAlignment v) {
+    ColumnVector& cv = table->columnVector(column);
+    cv.setTag(row, CellCodec::withVAlignment(cv.tag(row), v));
+}
+
+void ColumnarCell::releaseString() {
+    ColumnVector& v = table->columnVector(column);
+    Type type = CellCodec::type(v.tag(row));
+    if (type == TEXT || type == FORMULA) {
+        table->releaseString(v.value(row).intValue);
+    }
+}
+
+}
@@ -0,0 +1,104 @@
+// File: ColumnarCell.h
+// ColumnarCell declaration file
+//
+
+#ifndef COLUMNARCELL_H
+#define COLUMNARCELL_H
+
+#include "splib.h"
+
+namespace splib {
+
+// forward declarations
+class ColumnarTableImpl;
+
+/**
+ * Implementation of the <code>Cell</code> interface for columnar tables.
+ * The object does not store the cell contents; it is a view that
+ * forwards all calls to the column storage of the table.
+ */
+class ColumnarCell : public Cell {
+    public:
+        /** Creates a new, unbound instance of <code>ColumnarCell</code>. */
+        ColumnarCell();
+
+        /**
+         * Binds the view to a cell.
+         * @param table a pointer to the table that stores the cell
+         * @param column the column index of the cell
+         * @param row the row index of the cell
+         */
+        void bind(ColumnarTableImpl* table, int column, int row);
+
+        // inherit doc
+        virtual const _TCHAR* getText() const;
+
+        // inherit doc
+        virtual void setText(const _TCHAR* text);
+
+        // inherit doc
+        virtual long getLong() const;
+
+        // inherit doc
+        virtual void setLong(long l);
+
+        // inherit doc
+        virtual double getDouble() const;
+
+        // inherit doc
+        virtual void setDouble(double d);
+
+        // inherit doc
+        virtual Date getDate() const;
+
+        // inherit doc
+        virtual void setDate(const Date& date);
+
+        // inherit doc
+        virtual Time getTime() const;
+
+        // inherit doc
+        virtual void setTime(const Time& time);
+
+        // inherit doc
+        virtual const _TCHAR* getFormula() const;
+
+        // inherit doc
+        virtual void setFormula(const _TCHAR* formula);
+
+        // inherit doc
+        virtual void clear();
+
+        // inherit doc
+        virtual Type getType() const;
+
+        // inherit doc
+        virtual HAlignment getHAlignment() const;
+
+        // inherit doc
+        virtual void setHAlignment(HAlignment hAlignment);
+
+        // inherit doc
+        virtual VAlignment getVAlignment() const;
+
+        // inherit doc
+        virtual void setVAlignment(VAlignment vAlignment);
+
+    private:
+        /** Releases the string held by the cell, if any. */
+        void releaseString();
+
+    private:
+        /** The table that stores the cell */
+        ColumnarTableImpl* table;
+
+        /** The column index of the cell */
+        int column;
+
+        /** The row index of the cell */
+        int row;
+};
+
+}
+
+#endif // COLUMNARCELL_H
@@ -0,0 +1,100 @@
+// File: ColumnarCells.cpp
+// ColumnarCells implementation file
+//
+
+#include "ColumnarCells.h"
+#include "ColumnarTableImpl.h"
+#include "IndexLimits.h"
+#include "splibint.h"
+
+namespace splib {
+
+ColumnarCells::CellIterator::CellIterator(ColumnarTableImpl* t, int r)
+        : table(t), row(r) {
+    column = table->nextCell(row, 0);
+}
+
+bool ColumnarCells::CellIterator::hasNext() const {
+    return column != -1;
+}
+
+ColumnarCells::Entry ColumnarCells::CellIterator::next() {
+    if (column == -1) {
+        throw IllegalStateException();
+    }
+    int index = column;
+    view.bind(table, index, row);
+    column = table->nextCell(row, index + 1);
+    return Entry(view, index);
+}
+
+ColumnarCells::ColumnarCells() : table(0), row(0) {
+}
+
+void ColumnarCells::bind(ColumnarTableImpl* t, int r) {
+    table = t;
+    row = r;
+}
+
+Cell& ColumnarCells::get(int index) {
+    if (!IndexLimits::validateColumn(index)) {
+        throw IllegalArgumentException();
+    }
+    table->insertCell(index, row);
+    return table->cellView(index, row);
+}
+
+bool ColumnarCells::contains(int index) const {
+    if (!IndexLimits::validateColumn(index)) {
+        throw IllegalArgumentException();
+    }
+    return table->containsCell(index, row);
+}
+
+const Cell* ColumnarCells::find(int index) const {
+    if (!IndexLimits::validateColumn(index)) {
+        throw IllegalArgumentException();
+    }
+    return table->containsCell(index, row) ? &table->cellView(index, row) : 0;
+}
+
+int ColumnarCells::next(int index) const {
+    return table->nextCell(row, index < 0 ? 0 : index);
+}
+
+void ColumnarCells::remove(int index) {
+    if (!IndexLimits::validateColumn(index)) {
+        throw IllegalArgumentException();
+    }
+    table->removeCell(index, row);
+}
+
+int ColumnarCells::size() const {
+    return table->cellCount(row);
+}
+
+bool ColumnarCells::isEmpty() const {
+    return table->cellCount(row) == 0;
+}
+
+ColumnarCells::Iterator* ColumnarCells::iterator() {
+    return new CellIterator(table, row);
+}
+
+ColumnarCells::Entry ColumnarCells::first() {
+    int index = table->nextCell(row, 0);
+    if (index == -1) {
+        throw IllegalStateException();
+    }
+    return Entry(table->cellView(index, row), index);
+}
+
+ColumnarCells::Entry ColumnarCells::last() {
+    int index = table->lastCell(row);
+    if (index == -1) {
+        throw IllegalStateException();
+    }
+    return Entry(table->cellView(index, row), index);
+}
+
+}
@@ -0,0 +1,100 @@
+// File: ColumnarCells.h
+// ColumnarCells declaration file
+//
+
+#ifndef COLUMNARCELLS_H
+#define COLUMNARCELLS_H
+
+#include "splib.h"
+#include "ColumnarCell.h"
+
+namespace splib {
+
+/**
+ * Implementation of the <code>Cells</code> interface for columnar
+ * tables. The object is a view of a single row of the table.
+ */
+class ColumnarCells : public Cells {
+    public:
+        /** An iterator over the cells of a row of a columnar table. */
+        class CellIterator : public Iterator {
+            public:
+                /**
+                 * Creates a new instance of <code>CellIterator</code>.
+                 * @param table a pointer to the table
+                 * @param row the row index
+                 */
+                CellIterator(ColumnarTableImpl* table, int row);
+
+                // inherit doc
+                virtual bool hasNext() const;
+
+                // inherit doc
+                virtual Entry next();
+
+            private:
+                /** The table */
+                ColumnarTableImpl* table;
+
+                /** The row index */
+                int row;
+
+                /** The index of the next cell or <code>-1</code> */
+                int column;
+
+                /** The view returned by the last call to next() */
+                ColumnarCell view;
+        };
+
+    public:
+        /** Creates a new, unbound instance of <code>ColumnarCells</code>. */
+        ColumnarCells();
+
+        /**
+         * Binds the view to a row.
+         * @param table a pointer to the table that stores the row
+         * @param row the row index
+         */
+        void bind(ColumnarTableImpl* table, int row);
+
+        // inherit doc
+        virtual Cell& get(int index);
+
+        // inherit doc
+        virtual bool contains(int index) const;
+
+        // inherit doc
+        virtual const Cell* find(int index) const;
+
+        // inherit doc
+        virtual int next(int index) const;
+
+        // inherit doc
+        virtual void remove(int index);
+
+        // inherit doc
+        virtual int size() const;
+
+        // inherit doc
+        virtual bool isEmpty() const;
+
+        // inherit doc
+        virtual Iterator* iterator();
+
+        // inherit doc
+        virtual Entry first();
+
+        // inherit doc
+        virtual Entry last();
+
+    private:
+        /** The table that stores the row */
+        ColumnarTableImpl* table;
+
+        /** The row index */
+        int row;
+};
+
+}
+
+#endif // COLUMNARCELLS_H
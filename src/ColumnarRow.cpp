@@ -0,0 +1,36 @@
+// File: ColumnarRow.cpp
+// ColumnarRow implementation file
+//
+
+#include "ColumnarRow.h"
+#include "ColumnarTableImpl.h"
+#include "splibint.h"
+
+namespace splib {
+
+ColumnarRow::ColumnarRow() : table(0), row(0) {
+}
+
+void ColumnarRow::bind(ColumnarTableImpl* t, int r) {
+    table = t;
+    row = r;
+    cellsView.bind(t, r);
+}
+
+double ColumnarRow::getHeight() const {
+    return table->getHeight(row);
+}
+
+void ColumnarRow::setHeight(double h) {
+    table->setHeight(row, h);
+}
+
+Cells& ColumnarRow::cells() {
+    return cellsView;
+}
+
+const Cells& ColumnarRow::cells() const {
+    return cellsView;
+}
+
+}
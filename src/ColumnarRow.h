@@ -0,0 +1,54 @@
+// File: ColumnarRow.h
+// ColumnarRow declaration file
+//
+
+#ifndef COLUMNARROW_H
+#define COLUMNARROW_H
+
+#include "splib.h"
+#include "ColumnarCells.h"
+
+namespace splib {
+
+/**
+ * Implementation of the <code>Row</code> interface for columnar tables.
+ * The object is a view that forwards all calls to the table.
+ */
+class ColumnarRow : public Row {
+    public:
+        /** Creates a new, unbound instance of <code>ColumnarRow</code>. */
+        ColumnarRow();
+
+        /**
+         * Binds the view to a row.
+         * @param table a pointer to the table that stores the row
+         * @param row the row index
+         */
+        void bind(ColumnarTableImpl* table, int row);
+
+        // inherit doc
+        virtual double getHeight() const;
+
+        // inherit doc
+        virtual void setHeight(double height);
+
+        // inherit doc
+        virtual Cells& cells();
+
+        // inherit doc
+        virtual const Cells& cells() const;
+
+    private:
+        /** The table that stores the row */
+        ColumnarTableImpl* table;
+
+        /** The row index */
+        int row;
+
+        /** The view of the cells of the row */
+        ColumnarCells cellsView;
+};
+
+}
+
+#endif // COLUMNARROW_H
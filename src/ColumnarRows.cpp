@@ -0,0 +1,94 @@
+// File: ColumnarRows.cpp
+// ColumnarRows implementation file
+//
+
+#include "ColumnarRows.h"
+#include "ColumnarTableImpl.h"
+#include "IndexLimits.h"
+#include "splibint.h"
+
+namespace splib {
+
+ColumnarRows::RowIterator::RowIterator(ColumnarTableImpl* t) : table(t) {
+    row = table->nextRow(0);
+}
+
+bool ColumnarRows::RowIterator::hasNext() const {
+    return row != -1;
+}
+
+ColumnarRows::Entry ColumnarRows::RowIterator::next() {
+    if (row == -1) {
+        throw IllegalStateException();
+    }
+    int index = row;
+    view.bind(table, index);
+    row = table->nextRow(index + 1);
+    return Entry(view, index);
+}
+
+ColumnarRows::ColumnarRows(ColumnarTableImpl* t) : table(t) {
+}
+
+Row& ColumnarRows::get(int index) {
+    if (!IndexLimits::validateRow(index)) {
+        throw IllegalArgumentException();
+    }
+    table->insertRow(index);
+    return table->rowView(index);
+}
+
+bool ColumnarRows::contains(int index) const {
+    if (!IndexLimits::validateRow(index)) {
+        throw IllegalArgumentException();
+    }
+    return table->containsRow(index);
+}
+
+const Row* ColumnarRows::find(int index) const {
+    if (!IndexLimits::validateRow(index)) {
+        throw IllegalArgumentException();
+    }
+    return table->containsRow(index) ? &table->rowView(index) : 0;
+}
+
+int ColumnarRows::next(int index) const {
+    return table->nextRow(index < 0 ? 0 : index);
+}
+
+void ColumnarRows::remove(int index) {
+    if (!IndexLimits::validateRow(index)) {
+        throw IllegalArgumentException();
+    }
+    table->removeRow(index);
+}
+
+int ColumnarRows::size() const {
+    return table->rowCount();
+}
+
+bool ColumnarRows::isEmpty() const {
+    return table->rowCount() == 0;
+}
+
+ColumnarRows::Iterator* ColumnarRows::iterator() {
+    return new RowIterator(table);
+}
+
+ColumnarRows::Entry ColumnarRows::first() {
+    int index = table->nextRow(0);
+    if (index == -1) {
+        throw IllegalStateException();
+    }
+    return Entry(table->rowView(index), index);
+}
+
+ColumnarRows::Entry ColumnarRows::last() {
+    int index = table->lastRow();
+    if (index == -1) {
+        throw IllegalStateException();
+    }
+    return Entry(table->rowView(index), index);
+}
+
+}
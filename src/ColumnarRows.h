@@ -0,0 +1,86 @@
+// File: ColumnarRows.h
+// ColumnarRows declaration file
+//
+
+#ifndef COLUMNARROWS_H
+#define COLUMNARROWS_H
+
+#include "splib.h"
+#include "ColumnarRow.h"
+
+namespace splib {
+
+/** Implementation of the <code>Rows</code> interface for columnar tables. */
+class ColumnarRows : public Rows {
+    public:
+        /** An iterator over the rows of a columnar table. */
+        class RowIterator : public Iterator {
+            public:
+                /**
+                 * Creates a new instance of <code>RowIterator</code>.
+                 * @param table a pointer to the table
+                 */
+                RowIterator(ColumnarTableImpl* table);
+
+                // inherit doc
+                virtual bool hasNext() const;
+
+                // inherit doc
+                virtual Entry next();
+
+            private:
+                /** The table */
+                ColumnarTableImpl* table;
+
+                /** The index of the next row or <code>-1</code> */
+                int row;
+
+                /** The view returned by the last call to next() */
+                ColumnarRow view;
+        };
+
+    public:
+        /**
+         * Creates a new instance of <code>ColumnarRows</code>.
+         * @param table a pointer to the table that stores the rows
+         */
+        ColumnarRows(ColumnarTableImpl* table);
+
+        // inherit doc
+        virtual Row& get(int index);
+
+        // inherit doc
+        virtual bool contains(int index) const;
+
+        // inherit doc
+        virtual const Row* find(int index) const;
+
+        // inherit doc
+        virtual int next(int index) const;
+
+        // inherit doc
+        virtual void remove(int index);
+
+        // inherit doc
+        virtual int size() const;
+
+        // inherit doc
+        virtual bool isEmpty() const;
+
+        // inherit doc
+        virtual Iterator* iterator();
+
+        // inherit doc
+        virtual Entry first();
+
+        // inherit doc
+        virtual Entry last();
+
+    private:
+        /** The table that stores the rows */
+        ColumnarTableImpl* table;
+};
+
+}
+
+#endif // COLUMNARROWS_H
@@ -0,0 +1,365 @@
+// File: ColumnarTableImpl.cpp
+// ColumnarTableImpl implementation file
+//
+
+#include "ColumnarTableImpl.h"
+#include "CellCodec.h"
+#include "IndexLimits.h"
+#include "Thread.h"
+#include "splibint.h"
+
+#include <new>
+
+namespace splib {
+
+/**
+ * The raw storage of a ring of views. Thread-local data must be POD, so
+ * the views are constructed in place when they are bound.
+ */
+template<class T>
+union ViewRing {
+    /** The storage of the views */
+    char bytes[ColumnarTableImpl::VIEW_COUNT * sizeof(T)];
+
+    /** Members that align the storage for any view */
+    double alignDouble;
+    void* alignPointer;
+    long long alignLong;
+};
+
+/** The ring of cell views of the calling thread */
+static SPLIB_THREAD_LOCAL ViewRing<ColumnarCell> cellViewRing;
+
+/** The index of the next cell view of the calling thread */
+static SPLIB_THREAD_LOCAL unsigned nextCellView;
+
+/** The ring of row views of the calling thread */
+static SPLIB_THREAD_LOCAL ViewRing<ColumnarRow> rowViewRing;
+
+/** The index of the next row view of the calling thread */
+static SPLIB_THREAD_LOCAL unsigned nextRowView;
+
+ColumnarTableImpl::ColumnarTableImpl(Spreadsheet* sp, StringPool& strings)
+        : TableBase(sp, strings), rowTotal(0), rowsView(this), columnsImpl(arena) {
+}
+
+ColumnarTableImpl::~ColumnarTableImpl() {
+    for (std::vector<ColumnVector*>::size_type i = 0; i < data.size(); i++) {
+        delete data[i];
+    }
+}
+
+Cell& ColumnarTableImpl::cell(int column, int row) {
+    if (!IndexLimits::validate(column, row)) {
+        throw IllegalArgumentException();
+    }
+    insertCell(column, row);
+    return cellView(column, row);
+}
+
+void ColumnarTableImpl::clearCell(int column, int row) {
+    if (!IndexLimits::validate(column, row)) {
+        throw IllegalArgumentException();
+    }
+    if (containsRow(row)) {
+        removeCell(column, row);
+        if (cellCount(row) == 0 && getHeight(row) < 0) {
+            removeRow(row);
+        }
+    }
+}
+
+void ColumnarTableImpl::storeRow(int row, int first,
+                                 const CellValue* values, int count) {
+    insertRow(row);
+    for (int i = 0; i < count; i++) {
+        setValue(first + i, row, values[i]);
+    }
+}
+
+void ColumnarTableImpl::eraseRange(int left, int top, int right,
+                                   int bottom) {
+    for (int c = left; c <= right && c < (int)data.size(); c++) {
+        if (data[c] == 0) {
+            continue;
+        }
+        const BitVector& valid = data[c]->validity();
+        for (int r = valid.next(top); r != -1 && r <= bottom;
+             r = valid.next(r + 1)) {
+            removeCell(c, r);
+        }
+    }
+    for (int r = rowSet.next(top); r != -1 && r <= bottom;
+         r = rowSet.next(r + 1)) {
+        if (cellCount(r) == 0 && getHeight(r) < 0) {
+            removeRow(r);
+        }
+    }
+}
+
+void ColumnarTableImpl::eraseRows(int first, int last) {
+    for (int r = rowSet.next(first); r != -1 && r <= last;
+         r = rowSet.next(r + 1)) {
+        removeRow(r);
+    }
+}
+
+void ColumnarTableImpl::eraseColumns(int first, int last) {
+    columnsImpl.removeRange(first, last);
+}
+
+bool ColumnarTableImpl::isEmptyCell(int column, int row) const {
+    if (!IndexLimits::validate(column, row)) {
+        throw IllegalArgumentException();
+    }
+    return !containsCell(column, row);
+}
+
+const Cell* ColumnarTableImpl::findCell(int column, int row) const {
+    if (!IndexLimits::validate(column, row)) {
+        throw IllegalArgumentException();
+    }
+    return containsCell(column, row) ? &cellView(column, row) : 0;
+}
+
+int ColumnarTableImpl::firstColumn() const {
+    return cellStatistics().firstColumn();
+}
+
+int ColumnarTableImpl::lastColumn() const {
+    return cellStatistics().lastColumn();
+}
+
+int ColumnarTableImpl::firstRow() const {
+    return rowSet.first();
+}
+
+int ColumnarTableImpl::lastRow() const {
+    return rowSet.last();
+}
+
+Rows& ColumnarTableImpl::rows() {
+    return rowsView;
+}
+
+const Rows& ColumnarTableImpl::rows() const {
+    return rowsView;
+}
+
+Columns& ColumnarTableImpl::columns() {
+    return columnsImpl;
+}
+
+const Columns& ColumnarTableImpl::columns() const {
+    return columnsImpl;
+}
+
+bool ColumnarTableImpl::containsRow(int row) const {
+    return rowSet.test(row);
+}
+
+void ColumnarTableImpl::insertRow(int row) {
+    if (!rowSet.test(row)) {
+        rowSet.set(row);
+        rowTotal++;
+        rowCells.at(row) = 0;
+    }
+}
+
+void ColumnarTableImpl::removeRow(int row) {
+    if (!rowSet.test(row)) {
+        return;
+    }
+    for (int i = 0; i < (int)data.size() && rowCells[row] > 0; i++) {
+        removeCell(i, row);
+    }
+    heights.erase(row);
+    rowSet.reset(row);
+    rowTotal--;
+}
+
+int ColumnarTableImpl::rowCount() const {
+    return rowTotal;
+}
+
+int ColumnarTableImpl::nextRow(int row) const {
+    return rowSet.next(row);
+}
+
+bool ColumnarTableImpl::containsCell(int column, int row) const {
+    const ColumnVector* v = findColumnVector(column);
+    return v != 0 && v->contains(row);
+}
+
+void ColumnarTableImpl::insertCell(int column, int row) {
+    insertRow(row);
+    if (columnVector(column).insert(row)) {
+        rowCells[row]++;
+        cellStatistics().cellAdded(column);
+    }
+}
+
+void ColumnarTableImpl::setValue(int column, int row, const CellValue& value) {
+    Cell::Type type = value.getType();
+    if (type == Cell::NONE) {
+        return;
+    }
+    if (type == Cell::FORMULA) {
+        // validated by the cell
+        insertCell(column, row);
+        ColumnarCell view;
+        view.bind(this, column, row);
+        view.setFormula(value.getFormula());
+        return;
+    }
+    insertCell(column, row);
+    // the new text is added first, since it may be the text of the cell
+    int id = 0;
+    if (type == Cell::TEXT) {
+        id = addString(value.getText() ? value.getText() : _T(""));
+    }
+    ColumnVector& v = *data[column];
+    Cell::Type old = CellCodec::type(v.tag(row));
+    if (old == Cell::TEXT || old == Cell::FORMULA) {
+        releaseString(v.value(row).intValue);
+    }
+    ColumnVector::Value& val = v.value(row);
+    switch (type) {
+        case Cell::TEXT:
+            val.intValue = id;
+            break;
+        case Cell::LONG:
+            val.longValue = value.getLong();
+            break;
+        case Cell::DOUBLE:
+            val.doubleValue = value.getDouble();
+            break;
+        case Cell::DATE:
+            val.intValue = CellCodec::packDate(value.getDate());
+            break;
+        case Cell::TIME:
+            val.intValue = CellCodec::packTime(value.getTime());
+            break;
+        default:
+            break;
+    }
+    setType(column, row, type);
+}
+
+void ColumnarTableImpl::removeCell(int column, int row) {
+    if (column >= (int)data.size() || data[column] == 0) {
+        return;
+    }
+    ColumnVector& v = *data[column];
+    if (!v.contains(row)) {
+        return;
+    }
+    Cell::Type type = CellCodec::type(v.tag(row));
+    if (type == Cell::TEXT || type == Cell::FORMULA) {
+        releaseString(v.value(row).intValue);
+    }
+    v.remove(row);
+    rowCells[row]--;
+    cellStatistics().cellRemoved(column, type);
+}
+
+void ColumnarTableImpl::setType(int column, int row, Cell::Type type) {
+    ColumnVector& v = *data[column];
+    int tag = v.tag(row);
+    cellStatistics().typeChanged(CellCodec::type(tag), type);
+    v.setTag(row, CellCodec::withType(tag, type));
+}
+
+int ColumnarTableImpl::cellCount(int row) const {
+    return rowCells.get(row);
+}
+
+int ColumnarTableImpl::nextCell(int row, int column) const {
+    if (cellCount(row) == 0) {
+        return -1;
+    }
+    for (int i = column; i < (int)data.size(); i++) {
+        if (data[i] != 0 && data[i]->contains(row)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int ColumnarTableImpl::lastCell(int row) const {
+    if (cellCount(row) == 0) {
+        return -1;
+    }
+    for (int i = (int)data.size() - 1; i >= 0; i--) {
+        if (data[i] != 0 && data[i]->contains(row)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+double ColumnarTableImpl::getHeight(int row) const {
+    std::map<int, double>::const_iterator i = heights.find(row);
+    return i != heights.end() ? i->second : -1;
+}
+
+void ColumnarTableImpl::setHeight(int row, double height) {
+    if (height < 0) {
+        heights.erase(row);
+    } else {
+        heights[row] = height;
+    }
+}
+
+ColumnVector& ColumnarTableImpl::columnVector(int column) {
+    if (column >= (int)data.size()) {
+        data.resize(column + 1, 0);
+    }
+    if (data[column] == 0) {
+        data[column] = new ColumnVector();
+    }
+    return *data[column];
+}
+
+Cell& ColumnarTableImpl::cellView(int column, int row) {
+    return bindCellView(column, row);
+}
+
+const Cell& ColumnarTableImpl::cellView(int column, int row) const {
+    return bindCellView(column, row);
+}
+
+Row& ColumnarTableImpl::rowView(int row) {
+    return bindRowView(row);
+}
+
+const Row& ColumnarTableImpl::rowView(int row) const {
+    return bindRowView(row);
+}
+
+ColumnarCell& ColumnarTableImpl::bindCellView(int column, int row) const {
+    void* slot = cellViewRing.bytes
+                 + nextCellView++ % VIEW_COUNT * sizeof(ColumnarCell);
+    // a view holds no resources, so the one that was in the slot
+    // needs no destruction
+    ColumnarCell* view = new (slot) ColumnarCell();
+    view->bind((ColumnarTableImpl*)this, column, row);
+    return *view;
+}
+
+ColumnarRow& ColumnarTableImpl::bindRowView(int row) const {
+    void* slot = rowViewRing.bytes
+                 + nextRowView++ % VIEW_COUNT * sizeof(ColumnarRow);
+    ColumnarRow* view = new (slot) ColumnarRow();
+    view->bind((ColumnarTableImpl*)this, row);
+    return *view;
+}
+
+const ColumnVector* ColumnarTableImpl::findColumnVector(int column) const {
+    if (column < 0 || column >= (int)data.size()) {
+        return 0;
+    }
+    return data[column];
+}
+
+}
@@ -0,0 +1,231 @@
+// File: ColumnarTableImpl.h
+// ColumnarTableImpl declaration file
+//
+
+#ifndef COLUMNARTABLEIMPL_H
+#define COLUMNARTABLEIMPL_H
+
+#include "splib.h"
+#include "TableBase.h"
+#include "BitVector.h"
+#include "ColumnVector.h"
+#include "PagedArray.h"
+#include "ColumnarCell.h"
+#include "ColumnarRow.h"
+#include "ColumnarRows.h"
+#include "ColumnsImpl.h"
+#include "Arena.h"
+
+#include <map>
+
+namespace splib {
+
+/**
+ * Implementation of the <code>Table</code> interface that stores
+ * the cells column by column. Each column keeps its values in a
+ * <code>ColumnVector</code>, so a numeric cell takes about 9 bytes.
+ * Texts and formulas are kept in the string pool of the spreadsheet and
+ * referenced from the columns by their ids.
+ * <p>
+ * The <code>Cell</code> and <code>Row</code> references returned by
+ * <code>cell()</code>, <code>findCell()</code>, and the <code>get()</code>
+ * and <code>find()</code> methods of the collections are views bound on
+ * demand. Each thread takes them in turn from its own ring of
+ * <code>VIEW_COUNT</code> views, so a reference is valid only until the
+ * same thread has looked up <code>VIEW_COUNT</code> more cells or rows,
+ * like the views passed to a <code>TableWalker</code> visitor; it must
+ * not be kept longer. References returned by iterators stay valid until
+ * the next call to <code>next()</code>. The views take no memory per
+ * cell, and since a lookup neither allocates nor changes the table,
+ * several threads can read the table at once.
+ */
+class ColumnarTableImpl : public TableBase {
+    public:
+        /** The number of views a thread looks up before reusing them. */
+        enum {VIEW_COUNT = 64};
+
+    public:
+        /**
+         * Creates a new instance of <code>ColumnarTableImpl</code>.
+         * @param spreadsheet a pointer to the parent spreadsheet;
+         *        used to protect against table name duplications
+         * @param strings the string pool of the spreadsheet
+         */
+        ColumnarTableImpl(Spreadsheet* spreadsheet, StringPool& strings);
+
+        /** Destructor */
+        virtual ~ColumnarTableImpl();
+
+        using TableBase::cell;
+        using TableBase::clearCell;
+        using TableBase::isEmptyCell;
+        using TableBase::findCell;
+
+        // inherit doc
+        virtual Cell& cell(int column, int row);
+
+        // inherit doc
+        virtual void clearCell(int column, int row);
+
+        // inherit doc
+        virtual bool isEmptyCell(int column, int row) const;
+
+        // inherit doc
+        virtual const Cell* findCell(int column, int row) const;
+
+        // inherit doc
+        virtual int firstColumn() const;
+
+        // inherit doc
+        virtual int lastColumn() const;
+
+        // inherit doc
+        virtual int firstRow() const;
+
+        // inherit doc
+        virtual int lastRow() const;
+
+        // inherit doc
+        virtual Rows& rows();
+
+        // inherit doc
+        virtual const Rows& rows() const;
+
+        // inherit doc
+        virtual Columns& columns();
+
+        // inherit doc
+        virtual const Columns& columns() const;
+
+        /** Checks whether a row exists. */
+        bool containsRow(int row) const;
+
+        /** Creates an empty row unless it exists. */
+        void insertRow(int row);
+
+        /** Removes a row together with its cells. */
+        void removeRow(int row);
+
+        /** Returns the number of rows. */
+        int rowCount() const;
+
+        /**
+         * Finds the first existing row at or after a specific index.
+         * @return the row index or <code>-1</code>
+         */
+        int nextRow(int row) const;
+
+        /** Checks whether a cell exists. */
+        bool containsCell(int column, int row) const;
+
+        /** Creates an empty cell, and its row, unless it exists. */
+        void insertCell(int column, int row);
+
+        /**
+         * Sets a cell to a value of any type, creating the cell and its
+         * row if necessary. A value of type <code>Cell::NONE</code>
+         * leaves the cell untouched.
+         */
+        void setValue(int column, int row, const CellValue& value);
+
+        /**
+         * Changes the type of an existing cell, keeping its value and
+         * alignments.
+         */
+        void setType(int column, int row, Cell::Type type);
+
+        /** Removes a cell. The row of the cell is kept. */
+        void removeCell(int column, int row);
+
+        /** Returns the number of cells in a row. */
+        int cellCount(int row) const;
+
+        /**
+         * Finds the first cell of a row at or after a specific column.
+         * @return the column index or <code>-1</code>
+         */
+        int nextCell(int row, int column) const;
+
+        /**
+         * Finds the last cell of a row.
+         * @return the column index or <code>-1</code>
+         */
+        int lastCell(int row) const;
+
+        /** Retrieves the height of a row. */
+        double getHeight(int row) const;
+
+        /** Sets the height of a row. */
+        void setHeight(int row, double height);
+
+        /**
+         * Provides access to the storage of a column, creating it
+         * if necessary.
+         */
+        ColumnVector& columnVector(int column);
+
+        /** Binds a view of the calling thread to a cell. */
+        Cell& cellView(int column, int row);
+
+        /** Binds a view of the calling thread to a cell. */
+        const Cell& cellView(int column, int row) const;
+
+        /** Binds a view of the calling thread to a row. */
+        Row& rowView(int row);
+
+        /** Binds a view of the calling thread to a row. */
+        const Row& rowView(int row) const;
+
+    protected:
+        // inherit doc
+        virtual void storeRow(int row, int first, const CellValue* values,
+                              int count);
+
+        // inherit doc
+        virtual void eraseRange(int left, int top, int right, int bottom);
+
+        // inherit doc
+        virtual void eraseRows(int first, int last);
+
+        // inherit doc
+        virtual void eraseColumns(int first, int last);
+
+    private:
+        /** Binds the next cell view of the calling thread. */
+        ColumnarCell& bindCellView(int column, int row) const;
+
+        /** Binds the next row view of the calling thread. */
+        ColumnarRow& bindRowView(int row) const;
+
+        /** Retrieves the storage of a column, or 0 if it does not exist */
+        const ColumnVector* findColumnVector(int column) const;
+
+    private:
+        /** The storage of the columns, indexed by column */
+        std::vector<ColumnVector*> data;
+
+        /** The set of existing rows */
+        BitVector rowSet;
+
+        /** The number of existing rows */
+        int rowTotal;
+
+        /** The number of cells in each row, indexed by row */
+        PagedArray<int> rowCells;
+
+        /** The heights of the rows that have a height set */
+        std::map<int, double> heights;
+
+        /** The collection of rows */
+        ColumnarRows rowsView;
+
+        /** The arena that stores the columns */
+        Arena arena;
+
+        /** The collection of columns */
+        ColumnsImpl columnsImpl;
+};
+
+}
+
+#endif // COLUMNARTABLEIMPL_H
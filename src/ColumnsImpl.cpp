@@ -9,6 +9,9 @@
 
 namespace splib {
 
+ColumnsImpl::ColumnsImpl(Arena& arena) : collection(arena) {
+}
+
 Column& ColumnsImpl::get(int index) {
     if (!IndexLimits::validateColumn(index)) {
         throw IllegalArgumentException();
@@ -24,13 +27,24 @@ Column& ColumnsImpl::get(const _TCHAR* column) {
     return get(col);
 }
 
-bool ColumnsImpl::contains(int index) {
+bool ColumnsImpl::contains(int index) const {
     if (!IndexLimits::validateColumn(index)) {
         throw IllegalArgumentException();
     }
     return collection.contains(index);
 }
 
+const Column* ColumnsImpl::find(int index) const {
+    if (!IndexLimits::validateColumn(index)) {
+        throw IllegalArgumentException();
+    }
+    return collection.find(index);
+}
+
+int ColumnsImpl::next(int index) const {
+    return collection.next(index);
+}
+
 void ColumnsImpl::remove(int index) {
     if (!IndexLimits::validateColumn(index)) {
         throw IllegalArgumentException();
@@ -14,6 +14,12 @@ namespace splib {
 /** Default implementation of the <code>Columns</code> interface. */
 class ColumnsImpl : public Columns {
     public:
+        /**
+         * Creates a new instance of <code>ColumnsImpl</code>.
+         * @param arena the arena to allocate the columns from
+         */
+        ColumnsImpl(Arena& arena);
+
         // inherit doc
         virtual Column& get(int index);
 
@@ -21,7 +27,13 @@ class ColumnsImpl : public Columns {
         virtual Column& get(const _TCHAR* column);
 
         // inherit doc
-        virtual bool contains(int index);
+        virtual bool contains(int index) const;
+
+        // inherit doc
+        virtual const Column* find(int index) const;
+
+        // inherit doc
+        virtual int next(int index) const;
 
         // inherit doc
         virtual void remove(int index);
@@ -41,6 +53,14 @@ class ColumnsImpl : public Columns {
         // inherit doc
         virtual Entry last();
 
+        /**
+         * Removes the columns with indices in a range. The indices are
+         * not validated.
+         */
+        void removeRange(int first, int last) {
+            collection.removeRange(first, last);
+        }
+
     private:
         /** The object used to manage the collection of columns */
         IndexedCollectionImpl<Column,ColumnImpl> collection;
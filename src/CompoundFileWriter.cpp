@@ -0,0 +1,332 @@
+// File: CompoundFileWriter.cpp
+// CompoundFileWriter implementation file
+//
+
+#include "CompoundFileWriter.h"
+#include <string.h>
+#include "splibint.h"
+
+namespace splib {
+
+/** Special sector indices of the compound file format */
+enum {
+    FREESECT = 0xFFFFFFFF,
+    ENDOFCHAIN = 0xFFFFFFFE,
+    FATSECT = 0xFFFFFFFD,
+    DIFSECT = 0xFFFFFFFC,
+    NOSTREAM = 0xFFFFFFFF
+};
+
+CompoundFileWriter::CompoundFileWriter(const _TCHAR* pathname,
+                                       const char* streamName)
+        : sink(0), opened(false), holding(false), flushed(0), used(0) {
+#pragma warning (disable : 4996)
+    file = _tfopen(pathname, _T("wb"));
+#pragma warning (default : 4996)
+    if (file == 0) {
+        throw IOException(_T("error creating compound file"));
+    }
+    init(streamName);
+}
+
+CompoundFileWriter::CompoundFileWriter(OutputSink& sink,
+                                       const char* streamName)
+        : file(0), sink(&sink), opened(false), holding(!sink.isSeekable()),
+          flushed(0), used(0) {
+    init(streamName);
+}
+
+void CompoundFileWriter::init(const char* streamName) {
+#pragma warning (disable : 4996)
+    ::strncpy(name, streamName, sizeof(name) - 1);
+#pragma warning (default : 4996)
+    name[sizeof(name) - 1] = 0;
+    opened = true;
+    // the header is written when the file is closed; before the stream
+    // if the stream is kept in memory
+    if (!holding) {
+        unsigned char header[SECTOR_SIZE];
+        ::memset(header, 0, sizeof(header));
+        output(header, sizeof(header));
+    }
+}
+
+CompoundFileWriter::~CompoundFileWriter() {
+    if (file != 0) {
+        fclose(file);
+    }
+}
+
+CompoundFileWriter& CompoundFileWriter::write(const unsigned char* p,
+                                              int count) {
+    while (count > 0) {
+        if (used == BUFFER_SIZE) {
+            flush();
+        }
+        int n = BUFFER_SIZE - used;
+        if (n > count) {
+            n = count;
+        }
+        ::memcpy(buffer + used, p, n);
+        used += n;
+        p += n;
+        count -= n;
+    }
+    return *this;
+}
+
+int CompoundFileWriter::size() const {
+    return flushed + used;
+}
+
+void CompoundFileWriter::patch(int position, const unsigned char* p,
+                               int count) {
+    if (position < 0 || count < 0 || position + count > size()) {
+        throw IllegalArgumentException();
+    }
+    int inFile = flushed - position;
+    if (inFile < 0) {
+        inFile = 0;
+    } else if (inFile > count) {
+        inFile = count;
+    }
+    if (count > inFile) {
+        ::memcpy(buffer + position + inFile - flushed, p + inFile,
+                 count - inFile);
+    }
+    if (inFile > 0 && holding) {
+        ::memcpy(&held[position], p, inFile);
+    } else if (inFile > 0) {
+        seek(SECTOR_SIZE + position);
+        output(p, inFile);
+        seek(SECTOR_SIZE + flushed);
+    }
+}
+
+void CompoundFileWriter::close() {
+    if (!opened) {
+        throw IllegalStateException();
+    }
+    // pad the stream up to the mini stream cutoff, and its last sector
+    while (size() < MINI_STREAM_CUTOFF) {
+        write(0);
+    }
+    int streamSize = size();
+    while (size() % SECTOR_SIZE != 0) {
+        write(0);
+    }
+    flush();
+    // the sectors that follow the stream are the directory, the FAT, and
+    // the DIFAT; their number depends on their own number
+    ulong streamSectors = size() / SECTOR_SIZE;
+    ulong fatSectors = 0;
+    ulong difatSectors = 0;
+    for (;;) {
+        ulong sectors = streamSectors + 1 + fatSectors + difatSectors;
+        ulong fat = (sectors + SECTOR_INDICES - 1) / SECTOR_INDICES;
+        ulong difat = 0;
+        if (fat > HEADER_FAT_SECTORS) {
+            difat = (fat - HEADER_FAT_SECTORS + SECTOR_INDICES - 2) /
+                    (SECTOR_INDICES - 1);
+        }
+        if (fat == fatSectors && difat == difatSectors) {
+            break;
+        }
+        fatSectors = fat;
+        difatSectors = difat;
+    }
+    if (holding) {
+        writeHeader(streamSectors, fatSectors, difatSectors);
+        output(&held[0], (int)held.size());
+        std::vector<unsigned char>().swap(held);
+    }
+    writeDirectory(streamSize);
+    writeAllocationTable(streamSectors, fatSectors, difatSectors);
+    if (!holding) {
+        seek(0);
+        writeHeader(streamSectors, fatSectors, difatSectors);
+    }
+    opened = false;
+    if (file == 0) {
+        sink->flush();
+        return;
+    }
+    FILE* f = file;
+    file = 0;
+    if (fclose(f) != 0) {
+        throw IOException(_T("error closing compound file"));
+    }
+}
+
+void CompoundFileWriter::flush() {
+    // keep size() and the offsets of the records within 31 bits
+    if (flushed > 0x7FFFFFFF - 2 * BUFFER_SIZE) {
+        throw IOException(_T("compound file stream too large"));
+    }
+    if (holding) {
+        held.insert(held.end(), buffer, buffer + used);
+    } else {
+        output(buffer, used);
+    }
+    flushed += used;
+    used = 0;
+}
+
+void CompoundFileWriter::output(const void* p, int count) {
+    if (count <= 0) {
+        return;
+    }
+    if (file == 0) {
+        sink->write(p, count);
+    } else if (fwrite(p, 1, count, file) != (size_t)count) {
+        throw IOException(_T("error writing compound file"));
+    }
+}
+
+void CompoundFileWriter::seek(ulong position) {
+    if (file == 0) {
+        sink->seek(position);
+    } else if (fseek(file, (long)position, SEEK_SET) != 0) {
+        throw IOException(_T("error writing compound file"));
+    }
+}
+
+void CompoundFileWriter::writeDirectory(ulong streamSize) {
+    // Directory entry
+    // Offset   Size    Contents
+    // 0        64      Name: UTF16 string, 0-terminated
+    // 64       2       Size of the name in bytes, including the 0
+    // 66       1       Type: 2 = stream, 5 = root storage
+    // 67       1       Color: 1 = black
+    // 68       4       Left sibling
+    // 72       4       Right sibling
+    // 76       4       Child
+    // 80       16      CLSID
+    // 96       4       State bits
+    // 100      16      Creation and modification times
+    // 116      4       First sector
+    // 120      8       Size of the stream
+    unsigned char dir[SECTOR_SIZE];
+    ::memset(dir, 0, sizeof(dir));
+    for (int i = 0; i < SECTOR_SIZE; i += 128) {
+        put4bytes(NOSTREAM, dir + i + 68);
+        put4bytes(NOSTREAM, dir + i + 72);
+        put4bytes(NOSTREAM, dir + i + 76);
+    }
+    const char* names[] = {"Root Entry", name};
+    for (int i = 0; i < 2; i++) {
+        unsigned char* entry = dir + i * 128;
+        int length = (int)::strlen(names[i]);
+        for (int j = 0; j < length; j++) {
+            entry[j * 2] = (unsigned char)names[i][j];
+        }
+        put2bytes((unsigned short)((length + 1) * 2), entry + 64);
+        entry[67] = 1;
+    }
+    // the root storage has the stream as its only child and no mini stream
+    dir[66] = 5;
+    put4bytes(1, dir + 76);
+    put4bytes(ENDOFCHAIN, dir + 116);
+    // the stream starts right after the header
+    dir[128 + 66] = 2;
+    put4bytes(0, dir + 128 + 116);
+    put4bytes(streamSize, dir + 128 + 120);
+    output(dir, sizeof(dir));
+}
+
+void CompoundFileWriter::writeAllocationTable(ulong streamSectors,
+                                              ulong fatSectors,
+                                              ulong difatSectors) {
+    ulong directory = streamSectors;
+    ulong firstFat = directory + 1;
+    ulong firstDifat = firstFat + fatSectors;
+    unsigned char sector[SECTOR_SIZE];
+    for (ulong i = 0; i < fatSectors; i++) {
+        for (ulong j = 0; j < SECTOR_INDICES; j++) {
+            ulong s = i * SECTOR_INDICES + j;
+            ulong next = FREESECT;
+            if (s + 1 < streamSectors) {
+                next = s + 1;
+            } else if (s <= directory) {
+                next = ENDOFCHAIN;
+            } else if (s < firstDifat) {
+                next = FATSECT;
+            } else if (s < firstDifat + difatSectors) {
+                next = DIFSECT;
+            }
+            put4bytes(next, sector + j * 4);
+        }
+        output(sector, sizeof(sector));
+    }
+    // the FAT sectors not listed in the header
+    for (ulong i = 0; i < difatSectors; i++) {
+        for (ulong j = 0; j < SECTOR_INDICES - 1; j++) {
+            ulong k = HEADER_FAT_SECTORS + i * (SECTOR_INDICES - 1) + j;
+            put4bytes(k < fatSectors ? firstFat + k : FREESECT,
+                      sector + j * 4);
+        }
+        ulong next = i + 1 < difatSectors ? firstDifat + i + 1 : ENDOFCHAIN;
+        put4bytes(next, sector + SECTOR_SIZE - 4);
+        output(sector, sizeof(sector));
+    }
+}
+
+void CompoundFileWriter::writeHeader(ulong directorySector, ulong fatSectors,
+                                     ulong difatSectors) {
+    // Header
+    // Offset   Size    Contents
+    // 0        8       Signature
+    // 8        16      CLSID
+    // 24       2       Minor version: 0x003E
+    // 26       2       Major version: 3 (512-byte sectors)
+    // 28       2       Byte order: 0xFFFE (little-endian)
+    // 30       2       Sector shift: 9
+    // 32       2       Mini sector shift: 6
+    // 34       10      Not used
+    // 44       4       Number of FAT sectors
+    // 48       4       First directory sector
+    // 52       4       Not used
+    // 56       4       Mini stream cutoff: 4096
+    // 60       4       First mini FAT sector
+    // 64       4       Number of mini FAT sectors
+    // 68       4       First DIFAT sector
+    // 72       4       Number of DIFAT sectors
+    // 76       436     The first 109 FAT sectors
+    unsigned char header[SECTOR_SIZE];
+    ::memset(header, 0, sizeof(header));
+    const unsigned char SIGNATURE[] = {
+        0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1};
+    ::memcpy(header, SIGNATURE, sizeof(SIGNATURE));
+    put2bytes(0x003E, header + 24);
+    put2bytes(0x0003, header + 26);
+    put2bytes(0xFFFE, header + 28);
+    put2bytes(9, header + 30);
+    put2bytes(6, header + 32);
+    put4bytes(fatSectors, header + 44);
+    put4bytes(directorySector, header + 48);
+    put4bytes(MINI_STREAM_CUTOFF, header + 56);
+    put4bytes(ENDOFCHAIN, header + 60);
+    ulong firstFat = directorySector + 1;
+    put4bytes(difatSectors > 0 ? firstFat + fatSectors : ENDOFCHAIN,
+              header + 68);
+    put4bytes(difatSectors, header + 72);
+    for (ulong i = 0; i < HEADER_FAT_SECTORS; i++) {
+        put4bytes(i < fatSectors ? firstFat + i : FREESECT,
+                  header + 76 + i * 4);
+    }
+    output(header, sizeof(header));
+}
+
+void CompoundFileWriter::put2bytes(unsigned short value, unsigned char* out) {
+    out[0] = (unsigned char)(value & 0xFF);
+    out[1] = (unsigned char)((value >> 8) & 0xFF);
+}
+
+void CompoundFileWriter::put4bytes(ulong value, unsigned char* out) {
+    out[0] = (unsigned char)(value & 0xFF);
+    out[1] = (unsigned char)((value >> 8) & 0xFF);
+    out[2] = (unsigned char)((value >> 16) & 0xFF);
+    out[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+
+}
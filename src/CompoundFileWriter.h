@@ -0,0 +1,191 @@
+// File: CompoundFileWriter.h
+// CompoundFileWriter declaration file
+//
+
+#ifndef COMPOUNDFILEWRITER_H
+#define COMPOUNDFILEWRITER_H
+
+#include "splib.h"
+#include <stdio.h>
+#include <vector>
+
+namespace splib {
+
+/**
+ * A writer of an OLE compound file that contains a single stream in its
+ * root storage. The stream is written sequentially into consecutive
+ * sectors that follow the header, through a buffer of a fixed size;
+ * the directory, the sector allocation table, and the header are written
+ * when the writer is closed. Memory use does not depend on the size of
+ * the stream.
+ * <p>
+ * Streams shorter than the mini stream cutoff are padded with zeros up
+ * to the cutoff, so that the mini stream is never needed.
+ * <p>
+ * A file can also be written to a sink. If the sink cannot seek, the
+ * stream is kept in memory until the writer is closed, since the header
+ * precedes it.
+ */
+class CompoundFileWriter {
+    public:
+        /**
+         * Creates the file and opens it for writing.
+         * @param pathname a pointer to the path name of the file
+         * @param streamName a pointer to the name of the stream; ASCII
+         *        characters only, at most 31 of them
+         * @throw IOException if the file cannot be created
+         */
+        CompoundFileWriter(const _TCHAR* pathname, const char* streamName);
+
+        /**
+         * Creates a writer that writes the file to a sink.
+         * @param sink the sink; must live until the writer is closed
+         * @param streamName a pointer to the name of the stream; ASCII
+         *        characters only, at most 31 of them
+         * @throw IOException if writing fails
+         */
+        CompoundFileWriter(OutputSink& sink, const char* streamName);
+
+        /**
+         * Destructor. Closes the file, leaving it incomplete, unless
+         * <code>close()</code> has been called.
+         */
+        virtual ~CompoundFileWriter();
+
+        /**
+         * Appends a byte to the stream.
+         * @param b the byte to append
+         * @return a reference to this object
+         */
+        CompoundFileWriter& write(unsigned char b) {
+            if (used == BUFFER_SIZE) {
+                flush();
+            }
+            buffer[used++] = b;
+            return *this;
+        }
+
+        /**
+         * Appends a number of bytes to the stream.
+         * @param p a pointer to the array of bytes to append
+         * @param count the number of bytes to append
+         * @return a reference to this object
+         */
+        CompoundFileWriter& write(const unsigned char* p, int count);
+
+        /**
+         * Retrieves the number of bytes written to the stream so far.
+         * @return the size of the stream
+         */
+        int size() const;
+
+        /**
+         * Overwrites bytes that have already been written to the stream.
+         * @param position the position in the stream of the first byte
+         * @param p a pointer to the array of new bytes
+         * @param count the number of bytes; <code>position + count</code>
+         *        must not exceed the size of the stream
+         * @throw IOException if writing fails
+         */
+        void patch(int position, const unsigned char* p, int count);
+
+        /**
+         * Finishes the stream and the file and closes the file.
+         * @throw IOException if writing fails
+         * @throw IllegalStateException if the writer is already closed
+         */
+        void close();
+
+    private:
+        /** The type represents an unsigned 32-bit value of the format */
+        typedef unsigned long ulong;
+
+        /** The size of a sector, in bytes */
+        enum {SECTOR_SIZE = 512};
+
+        /** The number of sector indices in a sector */
+        enum {SECTOR_INDICES = SECTOR_SIZE / 4};
+
+        /** The number of FAT sector indices in the header */
+        enum {HEADER_FAT_SECTORS = 109};
+
+        /** The size of the buffer of the stream, in bytes */
+        enum {BUFFER_SIZE = 64 * SECTOR_SIZE};
+
+        /** The size below which streams would go to the mini stream */
+        enum {MINI_STREAM_CUTOFF = 4096};
+
+        /** Copies the name of the stream and starts the file. */
+        void init(const char* streamName);
+
+        /** Moves the contents of the buffer to the file or memory. */
+        void flush();
+
+        /** Writes bytes to the file at its current position. */
+        void output(const void* p, int count);
+
+        /** Moves the current position of the file. */
+        void seek(ulong position);
+
+        /** Writes the directory sector. */
+        void writeDirectory(ulong streamSize);
+
+        /**
+         * Writes the sector allocation table and the sectors that list
+         * its sectors beyond the header.
+         * @param streamSectors the number of sectors of the stream
+         * @param fatSectors the number of sectors of the table
+         * @param difatSectors the number of sectors that list the table
+         *        sectors beyond those listed in the header
+         */
+        void writeAllocationTable(ulong streamSectors, ulong fatSectors,
+                                  ulong difatSectors);
+
+        /** Writes the header. */
+        void writeHeader(ulong directorySector, ulong fatSectors,
+                         ulong difatSectors);
+
+        /** Stores a 2-byte value in little-endian order. */
+        static void put2bytes(unsigned short value, unsigned char* out);
+
+        /** Stores a 4-byte value in little-endian order. */
+        static void put4bytes(ulong value, unsigned char* out);
+
+        /** Not implemented; writers are not copied */
+        CompoundFileWriter(const CompoundFileWriter&);
+
+        /** Not implemented; writers are not copied */
+        CompoundFileWriter& operator = (const CompoundFileWriter&);
+
+    private:
+        /** The file, or 0 if writing to a sink */
+        FILE* file;
+
+        /** The sink, or 0 if writing to a file */
+        OutputSink* sink;
+
+        /** Indicates whether the writer is open */
+        bool opened;
+
+        /** Indicates whether the stream is kept in memory */
+        bool holding;
+
+        /** The bytes of the stream kept in memory */
+        std::vector<unsigned char> held;
+
+        /** The name of the stream */
+        char name[32];
+
+        /** The number of bytes of the stream moved out of the buffer */
+        int flushed;
+
+        /** The number of bytes in the buffer */
+        int used;
+
+        /** The bytes of the stream that follow those in the file */
+        unsigned char buffer[BUFFER_SIZE];
+};
+
+}
+
+#endif // COMPOUNDFILEWRITER_H
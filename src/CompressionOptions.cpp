@@ -0,0 +1,62 @@
+// File: CompressionOptions.cpp
+// CompressionOptions implementation file
+//
+
+#include "splib.h"
+#include <string.h>
+#include "splibint.h"
+
+namespace splib {
+
+CompressionOptions::CompressionOptions(int level) : level(level) {
+    checkLevel(level);
+}
+
+void CompressionOptions::setLevel(int level) {
+    checkLevel(level);
+    this->level = level;
+}
+
+int CompressionOptions::getLevel() const {
+    return level;
+}
+
+void CompressionOptions::setEntryLevel(const char* prefix, int level) {
+    if (prefix == 0) {
+        throw IllegalArgumentException();
+    }
+    checkLevel(level);
+    for (int i = 0; i < (int)entryLevels.size(); i++) {
+        if (entryLevels[i].first == prefix) {
+            entryLevels[i].second = level;
+            return;
+        }
+    }
+    entryLevels.push_back(std::make_pair(std::string(prefix), level));
+}
+
+void CompressionOptions::clearEntryLevels() {
+    entryLevels.clear();
+}
+
+int CompressionOptions::getEntryLevel(const char* entryName) const {
+    int result = level;
+    int longest = -1;
+    for (int i = 0; i < (int)entryLevels.size(); i++) {
+        const std::string& prefix = entryLevels[i].first;
+        if ((int)prefix.size() > longest &&
+            ::strncmp(prefix.c_str(), entryName, prefix.size()) == 0) {
+            result = entryLevels[i].second;
+            longest = (int)prefix.size();
+        }
+    }
+    return result;
+}
+
+void CompressionOptions::checkLevel(int level) {
+    if (level < DEFAULT_LEVEL || level > BEST_COMPRESSION) {
+        throw IllegalArgumentException();
+    }
+}
+
+}
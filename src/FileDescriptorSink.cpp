@@ -0,0 +1,61 @@
+// File: FileDescriptorSink.cpp
+// FileDescriptorSink implementation file
+//
+
+#include "splib.h"
+#ifdef WIN32
+#include <io.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#endif
+#include "splibint.h"
+
+namespace splib {
+
+FileDescriptorSink::FileDescriptorSink(int fd) : fd(fd) {
+#ifdef WIN32
+    start = _lseek(fd, 0, SEEK_CUR);
+#else
+    start = (long)lseek(fd, 0, SEEK_CUR);
+#endif
+}
+
+void FileDescriptorSink::write(const void* data, unsigned length) {
+    const char* p = (const char*)data;
+    while (length > 0) {
+#ifdef WIN32
+        int n = _write(fd, p, length);
+#else
+        ssize_t n = ::write(fd, p, length);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (n <= 0) {
+            throw IOException(_T("error writing to file descriptor"));
+        }
+        p += n;
+        length -= (unsigned)n;
+    }
+}
+
+bool FileDescriptorSink::isSeekable() const {
+    return start != -1;
+}
+
+void FileDescriptorSink::seek(unsigned long position) {
+    if (start == -1) {
+        throw IllegalStateException();
+    }
+#ifdef WIN32
+    long result = _lseek(fd, start + (long)position, SEEK_SET);
+#else
+    long result = (long)lseek(fd, start + (off_t)position, SEEK_SET);
+#endif
+    if (result == -1) {
+        throw IOException(_T("error seeking file descriptor"));
+    }
+}
+
+}
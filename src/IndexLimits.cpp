@@ -3,10 +3,37 @@
 //
 
 #include "IndexLimits.h"
+#include "Formulas.h"
+#include "TableWalker.h"
 #include "splibint.h"
 
 namespace splib {
 
+class IndexLimits::FormulaCheck {
+    public:
+        FormulaCheck(TableWalker& walker, int columns, int rows)
+            : walker(walker), columns(columns), rows(rows) {}
+
+        void row(int index, Row& row) {
+            walker.forEachCell(index, row, *this);
+        }
+
+        void cell(int column, Cell& cell) {
+            int c1, r1, c2, r2;
+            if (cell.getType() == Cell::FORMULA &&
+                Formulas::parse(cell.getFormula(), c1, r1, c2, r2) &&
+                (c1 >= columns || c2 >= columns || r1 >= rows || r2 >= rows)) {
+                throw IllegalArgumentException(
+                    _T("formula exceeds the size limits of the format"));
+            }
+        }
+
+    private:
+        TableWalker& walker;
+        int columns;
+        int rows;
+};
+
 bool IndexLimits::validate(int column, int row) {
     if (!validateRow(row)) {
         return false;
@@ -18,11 +45,27 @@ bool IndexLimits::validate(int column, int row) {
 }
 
 bool IndexLimits::validateRow(int row) {
-    return row >= 0 && row <= 65535;
+    return row >= 0 && row < MAX_ROWS;
 }
 
 bool IndexLimits::validateColumn(int column) {
-    return column >= 0 && column <= 255;
+    return column >= 0 && column < MAX_COLUMNS;
+}
+
+void IndexLimits::checkSpreadsheet(Spreadsheet& sp, int columns, int rows) {
+    for (int i = 0; i < sp.tableCount(); i++) {
+        Table& table = sp.table(i);
+        if (table.lastRow() >= rows || table.lastColumn() >= columns ||
+            table.columns().next(columns) != -1) {
+            throw IllegalArgumentException(
+                _T("table exceeds the size limits of the format"));
+        }
+        if (table.statistics().getCellCount(Cell::FORMULA) > 0) {
+            TableWalker walker(table);
+            FormulaCheck check(walker, columns, rows);
+            walker.forEachRow(check);
+        }
+    }
 }
 
 }
@@ -12,8 +12,25 @@ namespace splib {
 /**
  * A single point of validation of row and column indices
  * against their limits.
+ * <p>
+ * Tables accept indices up to the limits of the largest grid supported,
+ * that of the Excel 2007 format. Writers of formats with smaller grids
+ * check the tables against the limits of their format before writing.
  */
 class IndexLimits {
+    public:
+        /** The grid size of the Excel 2007 format, used for all tables */
+        enum {MAX_ROWS = 1048576, MAX_COLUMNS = 16384};
+
+        /** The grid size of the Excel 97/2000 format */
+        enum {XLS_ROWS = 65536, XLS_COLUMNS = 256};
+
+        /** The grid size of the Excel 2007 format */
+        enum {XLSX_ROWS = 1048576, XLSX_COLUMNS = 16384};
+
+        /** The grid size that OpenOffice.org Calc reads */
+        enum {ODS_ROWS = 1048576, ODS_COLUMNS = 1024};
+
     public:
         /**
          * Validates a pair of indices against limits.
@@ -36,6 +53,23 @@ class IndexLimits {
          * @return true if the column index is valid; false otherwise
          */
         static bool validateColumn(int column);
+
+        /**
+         * Checks that every table of a spreadsheet fits a grid. Cells,
+         * rows, columns, and the ranges that formulas refer to are all
+         * taken into account, so that writers can reject a spreadsheet
+         * before they write anything.
+         * @param spreadsheet the spreadsheet to check
+         * @param columns the number of columns of the grid
+         * @param rows the number of rows of the grid
+         * @throw IllegalArgumentException if a table does not fit
+         */
+        static void checkSpreadsheet(Spreadsheet& spreadsheet, int columns,
+                                     int rows);
+
+    private:
+        /** Visitor that checks the ranges of formulas against a grid */
+        class FormulaCheck;
 };
 
 }
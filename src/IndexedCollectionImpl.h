@@ -6,26 +6,66 @@
 #define INDEXEDCOLLECTIONIMPL_H
 
 #include "splib.h"
-#include <map>
+#include <vector>
+#include <algorithm>
+#include <new>
+#include <string.h>
+#include "Arena.h"
+#include "Bits.h"
 #include "splibint.h"
 
 namespace splib {
 
-/** Default implementation of the <code>IndexedCollection</code> interface. */
+/**
+ * Default implementation of the <code>IndexedCollection</code> interface.
+ * <p>
+ * Objects are kept in blocks, each block covering <code>BLOCK_SIZE</code>
+ * consecutive indices. A block stores an occupancy bitmap and a packed
+ * array of object pointers, ordered by index, with one slot per occupied
+ * index; the position of an index within the array is the number of
+ * occupied indices below it. Sparse blocks therefore behave as a small
+ * sorted vector and full blocks as a dense array, with no switching
+ * between the two. Blocks are kept in a vector sorted by their first
+ * index, so appending in ascending order never searches, lookups cost
+ * one binary search over blocks, and iteration walks contiguous arrays.
+ * <p>
+ * The objects and the blocks are allocated from the <code>Arena</code>
+ * of the table, and removed objects leave their memory to be reused by
+ * the arena.
+ */
 template<class T,class I>
 class IndexedCollectionImpl : public IndexedCollection<T> {
     private:
+        /** Number of bits of an index that select a slot within a block */
+        enum { BLOCK_BITS = 6 };
+
+        /** Number of consecutive indices covered by a block */
+        enum { BLOCK_SIZE = 1 << BLOCK_BITS };
+
+        /** The number of object slots of a newly created block */
+        enum { INITIAL_CAPACITY = 4 };
+
         /**
-         * An internal collection used to store and manage
-         * the indexed collection of objects
+         * A block of up to <code>BLOCK_SIZE</code> objects. The block
+         * is allocated with room for <code>capacity</code> objects and
+         * is reallocated with twice the room when it gets full.
          */
-        typedef std::map<int, T*> Map;
+        struct Block {
+            /** Index of the first slot of the block */
+            int base;
+
+            /** The number of objects the block has room for */
+            int capacity;
 
-        /** An iterator over the internal collection */
-        typedef typename std::map<int, T*>::iterator MapIterator;
+            /** Bit i is set if the object with index base + i exists */
+            Bits::Mask mask;
 
-        /** A reverse iterator over the internal collection */
-        typedef typename std::map<int, T*>::reverse_iterator MapReverseIterator;
+            /** Objects of the block, ordered by index */
+            T* objects[1];
+        };
+
+        /** The sorted sequence of blocks */
+        typedef std::vector<Block*> Blocks;
 
         /** A shortcut to <code>splib::IndexedCollection<T>::Entry</code> */
         typedef typename splib::IndexedCollection<T>::Entry Entry;
@@ -40,13 +80,13 @@ class IndexedCollectionImpl : public IndexedCollection<T> {
         class Iterator : public BaseIterator {
             public:
                 /** Creates a new <code>Iterator</code> */
-                Iterator(Map& m) : map(m) {
-                    iterator = map.begin();
+                Iterator(Blocks& b) : blocks(b), block(0), slot(0) {
+                    mask = blocks.empty() ? 0 : blocks[0]->mask;
                 }
 
                 // inherit doc
                 virtual bool hasNext() const {
-                    return iterator != map.end();
+                    return block < blocks.size();
                 }
 
                 // inherit doc
@@ -54,8 +94,18 @@ class IndexedCollectionImpl : public IndexedCollection<T> {
                     if (!hasNext()) {
                         throw IllegalStateException(_T("no more objects"));
                     }
-                    Entry entry(*iterator->second, iterator->first);
-                    iterator++;
+                    Block* b = blocks[block];
+                    Entry entry(*b->objects[slot],
+                        b->base + Bits::lowest(mask));
+                    mask &= mask - 1;
+                    slot++;
+                    if (mask == 0) {
+                        block++;
+                        slot = 0;
+                        if (block < blocks.size()) {
+                            mask = blocks[block]->mask;
+                        }
+                    }
                     return entry;
                 }
 
@@ -67,60 +117,318 @@ class IndexedCollectionImpl : public IndexedCollection<T> {
                 Iterator& operator = (const Iterator& i) {return *this;}
 
             private:
-                /** A reference to the collection to iterate over */
-                Map& map;
+                /** A reference to the blocks to iterate over */
+                Blocks& blocks;
+
+                /** Position of the current block */
+                typename Blocks::size_type block;
 
-                /** The iterator used to implement the iteration */
-                MapIterator iterator;
+                /** Position of the next object within the current block */
+                int slot;
+
+                /** Occupied slots of the current block not visited yet */
+                Bits::Mask mask;
         };
 
     public:
-        /** Creates a new <code>IndexedCollectionImpl</code> */
-        IndexedCollectionImpl() {}
+        /**
+         * Creates a new <code>IndexedCollectionImpl</code>
+         * @param arena the arena to allocate the objects from
+         * @param droppable <code>true</code> if the objects hold no
+         *        resources outside the arena, so that they can be dropped
+         *        without being destroyed once the arena is closed
+         */
+        IndexedCollectionImpl(Arena& a, bool droppable = false)
+            : arena(a), count(0), droppable(droppable) {}
 
         /** Cleans up resources allocated by this object */
         virtual ~IndexedCollectionImpl() {
-            for (MapIterator i = map.begin(); i != map.end(); i++) {
-                delete i->second;
+            if (droppable && arena.isClosed()) {
+                return;
+            }
+            for (typename Blocks::size_type i = 0; i < blocks.size(); i++) {
+                Block* b = blocks[i];
+                int n = Bits::count(b->mask);
+                for (int j = 0; j < n; j++) {
+                    destroy(b->objects[j]);
+                }
+                releaseBlock(b);
             }
         }
 
         // inherit doc
         virtual T& get(int index) {
-            T*& obj = map[index];
-            if (obj == 0) {
-                obj = new I();
+            Block* b = block(index, true);
+            int bit = index & (BLOCK_SIZE - 1);
+            int slot = Bits::count(b->mask & Bits::below(bit));
+            if (b->mask & (((Bits::Mask)1) << bit)) {
+                return *b->objects[slot];
+            }
+            int n = Bits::count(b->mask);
+            if (n == b->capacity) {
+                b = grow(b);
             }
+            T* obj = new (arena.allocate(sizeof(I))) I();
+            memmove(b->objects + slot + 1, b->objects + slot,
+                    (n - slot) * sizeof(T*));
+            b->objects[slot] = obj;
+            b->mask |= ((Bits::Mask)1) << bit;
+            count++;
             return *obj;
         }
 
+        /**
+         * Retrieves the objects with a range of consecutive indices,
+         * creating the missing ones. This is equivalent to calling
+         * <code>get()</code> for each index but reallocates every
+         * block at most once.
+         * @param first the first index of the range
+         * @param n the number of indices in the range
+         * @param out an array that receives the <code>n</code> objects
+         * @param created a function object called as
+         *        <code>created(index)</code> for each object created
+         */
+        template<class F>
+        void getRange(int first, int n, T** out, F& created) {
+            int index = first;
+            int end = first + n;
+            while (index < end) {
+                Block* b = block(index, true);
+                int from = index - b->base;
+                int to = end - b->base < BLOCK_SIZE ? end - b->base
+                                                    : BLOCK_SIZE;
+                Bits::Mask missing = Bits::range(from, to) & ~b->mask;
+                if (missing != 0) {
+                    b = fill(b, missing);
+                    for (Bits::Mask m = missing; m != 0; m &= m - 1) {
+                        created(b->base + Bits::lowest(m));
+                    }
+                }
+                int slot = Bits::count(b->mask & Bits::below(from));
+                for (int i = from; i < to; i++) {
+                    *out++ = b->objects[slot++];
+                }
+                index = b->base + to;
+            }
+        }
+
+        /**
+         * Calls a function for each object of the collection in the order
+         * of their indices. Unlike <code>iterator()</code>, this allocates
+         * nothing and makes no virtual calls. The collection must not be
+         * modified while it is traversed.
+         * @param f a function object called as <code>f(index, object)</code>
+         *        with an <code>int</code> and a <code>T&</code>
+         */
+        template<class F>
+        void forEach(F& f) {
+            for (typename Blocks::size_type i = 0; i < blocks.size(); i++) {
+                Block* b = blocks[i];
+                Bits::Mask mask = b->mask;
+                for (T** p = b->objects; mask != 0; p++) {
+                    f(b->base + Bits::lowest(mask), **p);
+                    mask &= mask - 1;
+                }
+            }
+        }
+
+        /**
+         * Calls a function for each object with an index in a range, in
+         * the order of their indices, as <code>forEach()</code> does.
+         * @param first the first index of the range
+         * @param last the last index of the range
+         * @param f a function object called as <code>f(index, object)</code>
+         */
+        template<class F>
+        void forEachInRange(int first, int last, F& f) {
+            typename Blocks::iterator i = std::lower_bound(blocks.begin(),
+                blocks.end(), base(first), less);
+            for (; i != blocks.end() && (*i)->base <= last; ++i) {
+                Block* b = *i;
+                Bits::Mask mask = b->mask & range(b, first, last);
+                if (mask == 0) {
+                    continue;
+                }
+                T** p = b->objects +
+                    Bits::count(b->mask & Bits::below(Bits::lowest(mask)));
+                for (; mask != 0; mask &= mask - 1) {
+                    f(b->base + Bits::lowest(mask), **p++);
+                }
+            }
+        }
+
+        /**
+         * Removes the objects with an index in a range. The blocks that
+         * overlap the range are visited once, so the cost depends on the
+         * number of objects in the range, not on its length.
+         * @param first the first index of the range
+         * @param last the last index of the range
+         * @param removed a function object called as
+         *        <code>removed(index, object)</code> before each object
+         *        is destroyed
+         */
+        template<class F>
+        void removeRange(int first, int last, F& removed) {
+            typename Blocks::iterator i = std::lower_bound(blocks.begin(),
+                blocks.end(), base(first), less);
+            typename Blocks::iterator kept = i;
+            for (; i != blocks.end() && (*i)->base <= last; ++i) {
+                Block* b = *i;
+                Bits::Mask gone = b->mask & range(b, first, last);
+                if (gone != 0) {
+                    // destroy the objects in the range and pack the others
+                    int n = Bits::count(b->mask);
+                    int k = 0;
+                    Bits::Mask mask = b->mask;
+                    for (int j = 0; j < n; j++, mask &= mask - 1) {
+                        Bits::Mask bit = mask & (~mask + 1);
+                        T* obj = b->objects[j];
+                        if (gone & bit) {
+                            removed(b->base + Bits::lowest(mask), *obj);
+                            destroy(obj);
+                        } else {
+                            b->objects[k++] = obj;
+                        }
+                    }
+                    b->mask &= ~gone;
+                    count -= n - k;
+                }
+                if (b->mask == 0) {
+                    releaseBlock(b);
+                } else {
+                    *kept++ = b;
+                }
+            }
+            blocks.erase(kept, i);
+        }
+
+        /** Removes the objects with an index in a range. */
+        void removeRange(int first, int last) {
+            Ignore ignore;
+            removeRange(first, last, ignore);
+        }
+
+        /**
+         * Finds the object with a given index without creating it.
+         * @param index index of the object
+         * @return a pointer to the object, or 0 if it does not exist
+         */
+        T* lookup(int index) const {
+            typename Blocks::const_iterator i = std::lower_bound(
+                blocks.begin(), blocks.end(), base(index), less);
+            if (i == blocks.end() || (*i)->base != base(index)) {
+                return 0;
+            }
+            const Block* b = *i;
+            int bit = index & (BLOCK_SIZE - 1);
+            if ((b->mask & (((Bits::Mask)1) << bit)) == 0) {
+                return 0;
+            }
+            return b->objects[Bits::count(b->mask & Bits::below(bit))];
+        }
+
+        // inherit doc
+        virtual bool contains(int index) const {
+            return lookup(index) != 0;
+        }
+
         // inherit doc
-        virtual bool contains(int index) {
-            return map.find(index) != map.end();
+        virtual const T* find(int index) const {
+            return lookup(index);
+        }
+
+        // inherit doc
+        virtual int next(int index) const {
+            if (index < 0) {
+                index = 0;
+            }
+            typename Blocks::const_iterator i = std::lower_bound(
+                blocks.begin(), blocks.end(), base(index), less);
+            if (i == blocks.end()) {
+                return -1;
+            }
+            const Block* b = *i;
+            Bits::Mask mask = b->mask;
+            if (b->base == base(index)) {
+                mask &= ~Bits::below(index & (BLOCK_SIZE - 1));
+                if (mask == 0) {
+                    if (++i == blocks.end()) {
+                        return -1;
+                    }
+                    b = *i;
+                    mask = b->mask;
+                }
+            }
+            return b->base + Bits::lowest(mask);
+        }
+
+        /**
+         * Finds the largest index of an object that is not greater than
+         * a specified index.
+         * @param index the index to start from
+         * @return the index of the object, or -1 if there is none
+         */
+        int previous(int index) const {
+            if (index < 0) {
+                return -1;
+            }
+            typename Blocks::const_iterator i = std::lower_bound(
+                blocks.begin(), blocks.end(), base(index) + 1, less);
+            if (i == blocks.begin()) {
+                return -1;
+            }
+            const Block* b = *--i;
+            Bits::Mask mask = b->mask;
+            if (b->base == base(index)) {
+                mask &= Bits::range(0, (index & (BLOCK_SIZE - 1)) + 1);
+                if (mask == 0) {
+                    if (i == blocks.begin()) {
+                        return -1;
+                    }
+                    b = *--i;
+                    mask = b->mask;
+                }
+            }
+            return b->base + Bits::highest(mask);
         }
 
         // inherit doc
         virtual void remove(int index) {
-            MapIterator i = map.find(index);
-            if (i != map.end()) {
-                delete i->second;
-                map.erase(i);
+            typename Blocks::iterator i = locate(index);
+            if (i == blocks.end() || (*i)->base != base(index)) {
+                return;
+            }
+            Block* b = *i;
+            int bit = index & (BLOCK_SIZE - 1);
+            if ((b->mask & (((Bits::Mask)1) << bit)) == 0) {
+                return;
+            }
+            int slot = Bits::count(b->mask & Bits::below(bit));
+            int n = Bits::count(b->mask);
+            destroy(b->objects[slot]);
+            memmove(b->objects + slot, b->objects + slot + 1,
+                    (n - slot - 1) * sizeof(T*));
+            b->mask &= ~(((Bits::Mask)1) << bit);
+            count--;
+            if (b->mask == 0) {
+                releaseBlock(b);
+                blocks.erase(i);
             }
         }
 
         // inherit doc
         virtual int size() const {
-            return (int)map.size();
+            return count;
         }
 
         // inherit doc
         virtual bool isEmpty() const {
-            return map.empty();
+            return count == 0;
         }
 
         // inherit doc
         virtual BaseIterator* iterator() {
-            return new Iterator(map);
+            return new Iterator(blocks);
         }
 
         // inherit doc
@@ -128,8 +436,8 @@ class IndexedCollectionImpl : public IndexedCollection<T> {
             if (size() == 0) {
                 throw IllegalStateException(_T("collection is empty"));
             }
-            MapIterator i = map.begin();
-            return Entry(*i->second, i->first);
+            Block* b = blocks.front();
+            return Entry(*b->objects[0], b->base + Bits::lowest(b->mask));
         }
 
         // inherit doc
@@ -137,16 +445,166 @@ class IndexedCollectionImpl : public IndexedCollection<T> {
             if (size() == 0) {
                 throw IllegalStateException(_T("collection is empty"));
             }
-            MapReverseIterator i = map.rbegin();
-            return Entry(*i->second, i->first);
+            Block* b = blocks.back();
+            return Entry(*b->objects[Bits::count(b->mask) - 1],
+                         b->base + Bits::highest(b->mask));
         }
 
     private:
+        /** A function object that ignores the objects passed to it. */
+        struct Ignore {
+            void operator () (int index, T& object) {}
+        };
+
         /**
-         * The object used to store and manage the indexed collection
-         * of objects
+         * Returns the mask of the slots of a block whose indices lie
+         * in a range.
          */
-        Map map;
+        static Bits::Mask range(const Block* b, int first, int last) {
+            int from = first > b->base ? first - b->base : 0;
+            int to = last - b->base + 1 < BLOCK_SIZE ? last - b->base + 1
+                                                     : BLOCK_SIZE;
+            return from < to ? Bits::range(from, to) : 0;
+        }
+
+        /** Returns the first index of the block that holds an index. */
+        static int base(int index) {
+            return index & ~(BLOCK_SIZE - 1);
+        }
+
+        /** Orders blocks by their first index. */
+        static bool less(const Block* b, int base) {
+            return b->base < base;
+        }
+
+        /**
+         * Returns the position of the block that holds an index, or the
+         * position at which such a block should be inserted.
+         */
+        typename Blocks::iterator locate(int index) {
+            int b = base(index);
+            if (!blocks.empty() && blocks.back()->base <= b) {
+                // fast path for appending in ascending order
+                return blocks.back()->base == b ? blocks.end() - 1
+                                                : blocks.end();
+            }
+            return std::lower_bound(blocks.begin(), blocks.end(), b, less);
+        }
+
+        /**
+         * Returns the block that holds an index. If there is no such block
+         * and <code>create</code> is true, the block is created; otherwise
+         * 0 is returned.
+         */
+        Block* block(int index, bool create) {
+            typename Blocks::iterator i = locate(index);
+            if (i != blocks.end() && (*i)->base == base(index)) {
+                return *i;
+            }
+            if (!create) {
+                return 0;
+            }
+            Block* b = newBlock(base(index), INITIAL_CAPACITY);
+            blocks.insert(i, b);
+            return b;
+        }
+
+        /** Returns the number of bytes taken by a block. */
+        static size_t blockSize(int capacity) {
+            return sizeof(Block) + (capacity - 1) * sizeof(T*);
+        }
+
+        /** Allocates an empty block. */
+        Block* newBlock(int base, int capacity) {
+            Block* b = (Block*)arena.allocate(blockSize(capacity));
+            b->base = base;
+            b->capacity = capacity;
+            b->mask = 0;
+            return b;
+        }
+
+        /** Returns the memory of a block to the arena. */
+        void releaseBlock(Block* b) {
+            arena.release(b, blockSize(b->capacity));
+        }
+
+        /**
+         * Replaces a block with a copy that has more room, updating
+         * the sequence of blocks.
+         * @param b the block
+         * @param capacity the new capacity; twice the old one if 0
+         */
+        Block* grow(Block* b, int capacity = 0) {
+            if (capacity == 0) {
+                capacity = b->capacity * 2;
+            }
+            Block* res = newBlock(b->base, capacity);
+            res->mask = b->mask;
+            memcpy(res->objects, b->objects,
+                   Bits::count(b->mask) * sizeof(T*));
+            *locate(b->base) = res;
+            releaseBlock(b);
+            return res;
+        }
+
+        /**
+         * Creates the objects of a block for a set of unoccupied slots,
+         * growing the block once if needed.
+         * @param b the block
+         * @param missing the slots to fill
+         * @return the block, which may have been reallocated
+         */
+        Block* fill(Block* b, Bits::Mask missing) {
+            Bits::Mask mask = b->mask | missing;
+            int total = Bits::count(mask);
+            if (total > b->capacity) {
+                int capacity = b->capacity;
+                while (capacity < total) {
+                    capacity *= 2;
+                }
+                b = grow(b, capacity);
+            }
+            // allocate the new objects in index order, then merge them
+            // with the existing ones from the top down
+            T* created[BLOCK_SIZE];
+            int n = 0;
+            for (Bits::Mask m = missing; m != 0; m &= m - 1) {
+                created[n++] = new (arena.allocate(sizeof(I))) I();
+            }
+            int src = Bits::count(b->mask) - 1;
+            for (int dst = total - 1; n > 0; dst--) {
+                int bit = Bits::highest(mask);
+                mask &= ~(((Bits::Mask)1) << bit);
+                if (missing & (((Bits::Mask)1) << bit)) {
+                    b->objects[dst] = created[--n];
+                } else {
+                    b->objects[dst] = b->objects[src--];
+                }
+            }
+            b->mask |= missing;
+            count += Bits::count(missing);
+            return b;
+        }
+
+        /** Destroys an object and returns its memory to the arena. */
+        void destroy(T* obj) {
+            I* impl = static_cast<I*>(obj);
+            impl->~I();
+            arena.release(impl, sizeof(I));
+        }
+
+    private:
+        /** The arena that stores the objects and the blocks */
+        Arena& arena;
+
+        /** The blocks of objects, sorted by their first index */
+        Blocks blocks;
+
+        /** The number of objects in the collection */
+        int count;
+
+        /** Whether the objects can be dropped when the arena is closed */
+        bool droppable;
 };
 
 }
@@ -0,0 +1,49 @@
+// File: MemorySink.cpp
+// MemorySink implementation file
+//
+
+#include "splib.h"
+#include <string.h>
+#include "splibint.h"
+
+namespace splib {
+
+MemorySink::MemorySink() : position(0) {
+}
+
+void MemorySink::write(const void* data, unsigned length) {
+    if (length == 0) {
+        return;
+    }
+    if (position + length > this->data.size()) {
+        this->data.resize(position + length);
+    }
+    ::memcpy(&this->data[position], data, length);
+    position += length;
+}
+
+bool MemorySink::isSeekable() const {
+    return true;
+}
+
+void MemorySink::seek(unsigned long position) {
+    if (position > data.size()) {
+        throw IllegalArgumentException();
+    }
+    this->position = position;
+}
+
+const unsigned char* MemorySink::getData() const {
+    return data.empty() ? 0 : &data[0];
+}
+
+unsigned long MemorySink::getSize() const {
+    return (unsigned long)data.size();
+}
+
+void MemorySink::clear() {
+    data.clear();
+    position = 0;
+}
+
+}
@@ -0,0 +1,362 @@
+// File: NumberFormat.cpp
+// NumberFormat implementation file
+//
+
+#include "NumberFormat.h"
+#include <float.h>
+#include <string.h>
+#include "splibint.h"
+
+namespace splib {
+
+/** The decimal digits of the numbers from 0 to 99, two by two */
+static const char DIGIT_PAIRS[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/** The significands of the cached powers of ten, 10^-348 to 10^340 */
+static const unsigned long long POWER_SIGNIFICANDS[] = {
+    0xFA8FD5A0081C0288ULL, 0xBAAEE17FA23EBF76ULL, 0x8B16FB203055AC76ULL,
+    0xCF42894A5DCE35EAULL, 0x9A6BB0AA55653B2DULL, 0xE61ACF033D1A45DFULL,
+    0xAB70FE17C79AC6CAULL, 0xFF77B1FCBEBCDC4FULL, 0xBE5691EF416BD60CULL,
+    0x8DD01FAD907FFC3CULL, 0xD3515C2831559A83ULL, 0x9D71AC8FADA6C9B5ULL,
+    0xEA9C227723EE8BCBULL, 0xAECC49914078536DULL, 0x823C12795DB6CE57ULL,
+    0xC21094364DFB5637ULL, 0x9096EA6F3848984FULL, 0xD77485CB25823AC7ULL,
+    0xA086CFCD97BF97F4ULL, 0xEF340A98172AACE5ULL, 0xB23867FB2A35B28EULL,
+    0x84C8D4DFD2C63F3BULL, 0xC5DD44271AD3CDBAULL, 0x936B9FCEBB25C996ULL,
+    0xDBAC6C247D62A584ULL, 0xA3AB66580D5FDAF6ULL, 0xF3E2F893DEC3F126ULL,
+    0xB5B5ADA8AAFF80B8ULL, 0x87625F056C7C4A8BULL, 0xC9BCFF6034C13053ULL,
+    0x964E858C91BA2655ULL, 0xDFF9772470297EBDULL, 0xA6DFBD9FB8E5B88FULL,
+    0xF8A95FCF88747D94ULL, 0xB94470938FA89BCFULL, 0x8A08F0F8BF0F156BULL,
+    0xCDB02555653131B6ULL, 0x993FE2C6D07B7FACULL, 0xE45C10C42A2B3B06ULL,
+    0xAA242499697392D3ULL, 0xFD87B5F28300CA0EULL, 0xBCE5086492111AEBULL,
+    0x8CBCCC096F5088CCULL, 0xD1B71758E219652CULL, 0x9C40000000000000ULL,
+    0xE8D4A51000000000ULL, 0xAD78EBC5AC620000ULL, 0x813F3978F8940984ULL,
+    0xC097CE7BC90715B3ULL, 0x8F7E32CE7BEA5C70ULL, 0xD5D238A4ABE98068ULL,
+    0x9F4F2726179A2245ULL, 0xED63A231D4C4FB27ULL, 0xB0DE65388CC8ADA8ULL,
+    0x83C7088E1AAB65DBULL, 0xC45D1DF942711D9AULL, 0x924D692CA61BE758ULL,
+    0xDA01EE641A708DEAULL, 0xA26DA3999AEF774AULL, 0xF209787BB47D6B85ULL,
+    0xB454E4A179DD1877ULL, 0x865B86925B9BC5C2ULL, 0xC83553C5C8965D3DULL,
+    0x952AB45CFA97A0B3ULL, 0xDE469FBD99A05FE3ULL, 0xA59BC234DB398C25ULL,
+    0xF6C69A72A3989F5CULL, 0xB7DCBF5354E9BECEULL, 0x88FCF317F22241E2ULL,
+    0xCC20CE9BD35C78A5ULL, 0x98165AF37B2153DFULL, 0xE2A0B5DC971F303AULL,
+    0xA8D9D1535CE3B396ULL, 0xFB9B7CD9A4A7443CULL, 0xBB764C4CA7A44410ULL,
+    0x8BAB8EEFB6409C1AULL, 0xD01FEF10A657842CULL, 0x9B10A4E5E9913129ULL,
+    0xE7109BFBA19C0C9DULL, 0xAC2820D9623BF429ULL, 0x80444B5E7AA7CF85ULL,
+    0xBF21E44003ACDD2DULL, 0x8E679C2F5E44FF8FULL, 0xD433179D9C8CB841ULL,
+    0x9E19DB92B4E31BA9ULL, 0xEB96BF6EBADF77D9ULL, 0xAF87023B9BF0EE6BULL
+};
+
+/** The binary exponents of the cached powers of ten */
+static const short POWER_EXPONENTS[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066
+};
+
+/** Powers of ten that fit 32 bits */
+static const unsigned POWERS_OF_TEN[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+    1000000000
+};
+
+/** Powers of ten that fit 64 bits */
+static const unsigned long long LONG_POWERS_OF_TEN[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+/** The implicit leading bit of the significand of a normal double */
+static const unsigned long long HIDDEN_BIT = 0x0010000000000000ULL;
+
+/** The bits of the stored significand of a double */
+static const unsigned long long SIGNIFICAND_MASK = 0x000FFFFFFFFFFFFFULL;
+
+int NumberFormat::format(long value, char* buffer) {
+    char* p = buffer;
+    unsigned long u = (unsigned long)value;
+    if (value < 0) {
+        *p++ = '-';
+        u = 0UL - u;
+    }
+    p += digitCount(u);
+    *p = 0;
+    // the digits are written from the last, two at a time
+    char* q = p;
+    while (u >= 100) {
+        unsigned pair = (unsigned)(u % 100);
+        u /= 100;
+        q -= 2;
+        q[0] = DIGIT_PAIRS[2 * pair];
+        q[1] = DIGIT_PAIRS[2 * pair + 1];
+    }
+    if (u >= 10) {
+        q[-2] = DIGIT_PAIRS[2 * u];
+        q[-1] = DIGIT_PAIRS[2 * u + 1];
+    } else {
+        q[-1] = (char)('0' + u);
+    }
+    return (int)(p - buffer);
+}
+
+int NumberFormat::format(double value, char* buffer) {
+    if (value != value) {
+        ::strcpy(buffer, "NaN");
+        return 3;
+    }
+    if (value > DBL_MAX) {
+        ::strcpy(buffer, "INF");
+        return 3;
+    }
+    if (value < -DBL_MAX) {
+        ::strcpy(buffer, "-INF");
+        return 4;
+    }
+    char* p = buffer;
+    uint64 bits;
+    ::memcpy(&bits, &value, sizeof(bits));
+    if (bits >> 63) {
+        *p++ = '-';
+        bits &= ~(1ULL << 63);
+    }
+    if (bits == 0) {
+        *p++ = '0';
+        *p = 0;
+        return (int)(p - buffer);
+    }
+
+    // the value and the boundaries of the numbers that read back as it
+    int biasedExponent = (int)(bits >> 52);
+    DiyFp v;
+    if (biasedExponent != 0) {
+        v.f = (bits & SIGNIFICAND_MASK) | HIDDEN_BIT;
+        v.e = biasedExponent - 1075;
+    } else {
+        v.f = bits & SIGNIFICAND_MASK;
+        v.e = -1074;
+    }
+    DiyFp plus;
+    plus.f = (v.f << 1) + 1;
+    plus.e = v.e - 1;
+    plus = normalize(plus);
+    DiyFp minus;
+    if (v.f == HIDDEN_BIT) {
+        minus.f = (v.f << 2) - 1;
+        minus.e = v.e - 2;
+    } else {
+        minus.f = (v.f << 1) - 1;
+        minus.e = v.e - 1;
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    // scale them so that the integral part of the upper bound has
+    // a few digits, and generate the digits
+    int k;
+    DiyFp c = cachedPower(plus.e, k);
+    DiyFp w = multiply(normalize(v), c);
+    DiyFp upper = multiply(plus, c);
+    DiyFp lower = multiply(minus, c);
+    lower.f++;
+    upper.f--;
+    int length = 0;
+    generateDigits(w, upper, upper.f - lower.f, p, length, k);
+    p += layout(p, length, k);
+    return (int)(p - buffer);
+}
+
+int NumberFormat::digitCount(unsigned long value) {
+    int n = 1;
+    for (;;) {
+        if (value < 10) {
+            return n;
+        }
+        if (value < 100) {
+            return n + 1;
+        }
+        if (value < 1000) {
+            return n + 2;
+        }
+        if (value < 10000) {
+            return n + 3;
+        }
+        value /= 10000;
+        n += 4;
+    }
+}
+
+NumberFormat::DiyFp NumberFormat::multiply(const DiyFp& x, const DiyFp& y) {
+    const uint64 M32 = 0xFFFFFFFFULL;
+    uint64 a = x.f >> 32;
+    uint64 b = x.f & M32;
+    uint64 c = y.f >> 32;
+    uint64 d = y.f & M32;
+    uint64 ac = a * c;
+    uint64 bc = b * c;
+    uint64 ad = a * d;
+    uint64 bd = b * d;
+    uint64 tmp = (bd >> 32) + (ad & M32) + (bc & M32) + (1ULL << 31);
+    DiyFp r;
+    r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+    r.e = x.e + y.e + 64;
+    return r;
+}
+
+NumberFormat::DiyFp NumberFormat::normalize(DiyFp x) {
+    while ((x.f & (1ULL << 63)) == 0) {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+NumberFormat::DiyFp NumberFormat::cachedPower(int e, int& k) {
+    // the binary exponent of the product should be about -60
+    double dk = (-61 - e) * 0.30102999566398114 + 347;
+    int ik = (int)dk;
+    if (dk - ik > 0.0) {
+        ik++;
+    }
+    int index = (ik >> 3) + 1;
+    k = -(-348 + index * 8);
+    DiyFp r;
+    r.f = POWER_SIGNIFICANDS[index];
+    r.e = POWER_EXPONENTS[index];
+    return r;
+}
+
+void NumberFormat::generateDigits(const DiyFp& w, const DiyFp& upper,
+                                  uint64 delta, char* buffer, int& length,
+                                  int& k) {
+    DiyFp one;
+    one.f = 1ULL << -upper.e;
+    one.e = upper.e;
+    uint64 distance = upper.f - w.f;
+    unsigned p1 = (unsigned)(upper.f >> -one.e);
+    uint64 p2 = upper.f & (one.f - 1);
+    int kappa = 1;
+    while (kappa < 10 && p1 >= POWERS_OF_TEN[kappa]) {
+        kappa++;
+    }
+    // the digits of the integral part
+    while (kappa > 0) {
+        unsigned d = p1 / POWERS_OF_TEN[kappa - 1];
+        p1 %= POWERS_OF_TEN[kappa - 1];
+        if (d != 0 || length != 0) {
+            buffer[length++] = (char)('0' + d);
+        }
+        kappa--;
+        uint64 rest = ((uint64)p1 << -one.e) + p2;
+        if (rest <= delta) {
+            k += kappa;
+            round(buffer, length, delta, rest,
+                  (uint64)POWERS_OF_TEN[kappa] << -one.e, distance);
+            return;
+        }
+    }
+    // the digits of the fractional part
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        char d = (char)(p2 >> -one.e);
+        if (d != 0 || length != 0) {
+            buffer[length++] = (char)('0' + d);
+        }
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta) {
+            k += kappa;
+            int index = -kappa;
+            round(buffer, length, delta, p2, one.f,
+                  index < 20 ? distance * LONG_POWERS_OF_TEN[index] : 0);
+            return;
+        }
+    }
+}
+
+void NumberFormat::round(char* buffer, int length, uint64 delta,
+                         uint64 rest, uint64 tenKappa, uint64 distance) {
+    while (rest < distance && delta - rest >= tenKappa &&
+           (rest + tenKappa < distance ||
+            distance - rest > rest + tenKappa - distance)) {
+        buffer[length - 1]--;
+        rest += tenKappa;
+    }
+}
+
+int NumberFormat::layout(char* buffer, int length, int k) {
+    // the value is between 10^(kk - 1) and 10^kk
+    int kk = length + k;
+    if (k >= 0 && kk <= 21) {
+        // 1234e7 -> 12340000000
+        for (int i = length; i < kk; i++) {
+            buffer[i] = '0';
+        }
+        buffer[kk] = 0;
+        return kk;
+    }
+    if (kk > 0 && kk <= 21) {
+        // 1234e-2 -> 12.34
+        ::memmove(buffer + kk + 1, buffer + kk, length - kk);
+        buffer[kk] = '.';
+        buffer[length + 1] = 0;
+        return length + 1;
+    }
+    if (kk > -6 && kk <= 0) {
+        // 1234e-6 -> 0.001234
+        int offset = 2 - kk;
+        ::memmove(buffer + offset, buffer, length);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        for (int i = 2; i < offset; i++) {
+            buffer[i] = '0';
+        }
+        buffer[length + offset] = 0;
+        return length + offset;
+    }
+    if (length == 1) {
+        // 1e30
+        buffer[1] = 'e';
+        return 2 + writeExponent(kk - 1, buffer + 2);
+    }
+    // 1234e30 -> 1.234e+33
+    ::memmove(buffer + 2, buffer + 1, length - 1);
+    buffer[1] = '.';
+    buffer[length + 1] = 'e';
+    return length + 2 + writeExponent(kk - 1, buffer + length + 2);
+}
+
+int NumberFormat::writeExponent(int exponent, char* buffer) {
+    char* p = buffer;
+    if (exponent < 0) {
+        *p++ = '-';
+        exponent = -exponent;
+    } else {
+        *p++ = '+';
+    }
+    if (exponent >= 100) {
+        *p++ = (char)('0' + exponent / 100);
+        exponent %= 100;
+        *p++ = (char)('0' + exponent / 10);
+    } else if (exponent >= 10) {
+        *p++ = (char)('0' + exponent / 10);
+    }
+    *p++ = (char)('0' + exponent % 10);
+    *p = 0;
+    return (int)(p - buffer);
+}
+
+}
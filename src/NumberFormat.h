@@ -0,0 +1,107 @@
+// File: NumberFormat.h
+// NumberFormat declaration file
+//
+
+#ifndef NUMBERFORMAT_H
+#define NUMBERFORMAT_H
+
+namespace splib {
+
+/**
+ * Static methods that format numbers into character buffers, the way XML
+ * schema types expect them: ASCII digits, a period as the decimal point,
+ * and no grouping, whatever the locale. Nothing is allocated.
+ * <p>
+ * Doubles are written with the fewest digits that read back as the same
+ * value, using the Grisu2 algorithm of Florian Loitsch ("Printing
+ * Floating-Point Numbers Quickly and Accurately with Integers", 2010).
+ * Numbers from 1e-6 up to 1e21 are written in positional notation,
+ * others as a significand and a decimal exponent, like 1.5e+300.
+ */
+class NumberFormat {
+    public:
+        /** The size of a buffer that holds any formatted number */
+        enum {BUFFER_SIZE = 32};
+
+        /**
+         * Formats an integer.
+         * @param value the value to format
+         * @param buffer a pointer to at least <code>BUFFER_SIZE</code>
+         *        characters; the result is 0-terminated
+         * @return the number of characters, the terminating 0 excluded
+         */
+        static int format(long value, char* buffer);
+
+        /**
+         * Formats a double. Infinities and NaN are written as in XML
+         * schema: INF, -INF, and NaN.
+         * @param value the value to format
+         * @param buffer a pointer to at least <code>BUFFER_SIZE</code>
+         *        characters; the result is 0-terminated
+         * @return the number of characters, the terminating 0 excluded
+         */
+        static int format(double value, char* buffer);
+
+        /** Retrieves the number of decimal digits of a number. */
+        static int digitCount(unsigned long value);
+
+    private:
+        /** The type represents a 64-bit significand */
+        typedef unsigned long long uint64;
+
+        /** A floating-point number with a 64-bit significand */
+        struct DiyFp {
+            /** The significand */
+            uint64 f;
+
+            /** The binary exponent */
+            int e;
+        };
+
+        /** Multiplies two numbers, rounding the significand. */
+        static DiyFp multiply(const DiyFp& x, const DiyFp& y);
+
+        /** Shifts the significand so that its highest bit is set. */
+        static DiyFp normalize(DiyFp x);
+
+        /**
+         * Finds the cached power of ten that brings a number with the
+         * specified binary exponent into the range of the digit generation.
+         * @param e the binary exponent of the number
+         * @param k the decimal exponent of the power returned, negated
+         */
+        static DiyFp cachedPower(int e, int& k);
+
+        /**
+         * Generates the shortest digits of a number within a range.
+         * @param w the scaled number
+         * @param upper the scaled upper bound of the range
+         * @param delta the width of the range
+         * @param buffer the digits
+         * @param length the number of digits
+         * @param k the decimal exponent of the digits, updated
+         */
+        static void generateDigits(const DiyFp& w, const DiyFp& upper,
+                                   uint64 delta, char* buffer, int& length,
+                                   int& k);
+
+        /** Moves the last digit closer to the exact value. */
+        static void round(char* buffer, int length, uint64 delta,
+                          uint64 rest, uint64 tenKappa, uint64 distance);
+
+        /**
+         * Lays out digits in positional or exponential notation.
+         * @param buffer the digits, followed by room for the layout
+         * @param length the number of digits
+         * @param k the decimal exponent of the last digit
+         * @return the number of characters
+         */
+        static int layout(char* buffer, int length, int k);
+
+        /** Writes a decimal exponent with its sign. */
+        static int writeExponent(int exponent, char* buffer);
+};
+
+}
+
+#endif // NUMBERFORMAT_H
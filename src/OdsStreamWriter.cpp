@@ -0,0 +1,58 @@
+// File: OdsStreamWriter.cpp
+// OdsStreamWriter implementation file
+//
+
+#include "splib.h"
+#include "OdsStreamWriterImpl.h"
+#include "splibint.h"
+
+namespace splib {
+
+OdsStreamWriter::OdsStreamWriter(const _TCHAR* pathname) {
+    impl = new OdsStreamWriterImpl(pathname);
+}
+
+OdsStreamWriter::OdsStreamWriter(OutputSink& sink) {
+    impl = new OdsStreamWriterImpl(sink);
+}
+
+OdsStreamWriter::~OdsStreamWriter() {
+    if (!impl->isClosed()) {
+        try {
+            impl->close();
+        } catch (Exception&) {
+        }
+    }
+    delete impl;
+}
+
+void OdsStreamWriter::setCompression(const CompressionOptions& compression) {
+    impl->setCompression(compression);
+}
+
+void OdsStreamWriter::beginSheet(const _TCHAR* name) {
+    impl->beginSheet(name);
+}
+
+void OdsStreamWriter::setColumnWidth(int column, double width) {
+    impl->setColumnWidth(column, width);
+}
+
+void OdsStreamWriter::setRowHeight(int row, double height) {
+    impl->setRowHeight(row, height);
+}
+
+void OdsStreamWriter::writeRow(int row, int first, const CellValue* values,
+                                int count) {
+    impl->writeRow(row, first, values, count);
+}
+
+void OdsStreamWriter::endSheet() {
+    impl->endSheet();
+}
+
+void OdsStreamWriter::close() {
+    impl->close();
+}
+
+}
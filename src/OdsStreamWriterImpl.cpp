@@ -0,0 +1,120 @@
+// File: OdsStreamWriterImpl.cpp
+// OdsStreamWriterImpl implementation file
+//
+
+#include "OdsStreamWriterImpl.h"
+#include "OdsWriterImpl.h"
+#include "IndexLimits.h"
+#include "splibint.h"
+
+namespace splib {
+
+OdsStreamWriterImpl::OdsStreamWriterImpl(const _TCHAR* pathname)
+        : StreamWriterBase(IndexLimits::ODS_COLUMNS, IndexLimits::ODS_ROWS),
+          ar(pathname), xml(ar), tablesXml(tables), lastRow(-1) {
+}
+
+OdsStreamWriterImpl::OdsStreamWriterImpl(OutputSink& sink)
+        : StreamWriterBase(IndexLimits::ODS_COLUMNS, IndexLimits::ODS_ROWS),
+          ar(sink), xml(ar), tablesXml(tables), lastRow(-1) {
+}
+
+void OdsStreamWriterImpl::setCompression(
+        const CompressionOptions& compression) {
+    ar.setCompression(compression);
+}
+
+void OdsStreamWriterImpl::openSheet(int index, const _TCHAR* name,
+                                    const Widths& widths) {
+    // the tables are opened late, so that the compression set before
+    // the first sheet applies to them
+    if (index == 0) {
+        startTables();
+    }
+    OdsWriterImpl::writeTableStart(name, tablesXml);
+    int lastColumn = -1;
+    for (Widths::const_iterator i = widths.begin(); i != widths.end(); ++i) {
+        OdsWriterImpl::writeEmptyColumns(i->first - lastColumn - 1,
+                                         tablesXml);
+        OdsWriterImpl::writeColumn(style(columnStyles, i->second),
+                                   tablesXml);
+        lastColumn = i->first;
+    }
+    lastRow = -1;
+}
+
+void OdsStreamWriterImpl::outputRow(int row, double height, int first,
+                                    const CellValue* values, int count) {
+    OdsWriterImpl::writeEmptyRows(row - lastRow - 1, tablesXml);
+    lastRow = row;
+    OdsWriterImpl::writeRowStart(height >= 0 ? style(rowStyles, height) : 1,
+                                 tablesXml);
+    int empty = first;
+    for (int i = 0; i < count; i++) {
+        Cell::Type type = values[i].getType();
+        if (type == Cell::NONE) {
+            empty++;
+            continue;
+        }
+        OdsWriterImpl::writeEmptyCells(empty, tablesXml);
+        empty = 0;
+        int cellStyle = OdsWriterImpl::cellStyleIndex(type, Cell::HADEFAULT,
+                                                      Cell::VADEFAULT);
+        OdsWriterImpl::writeValue(values[i], cellStyle, tablesXml);
+    }
+    OdsWriterImpl::writeRowEnd(tablesXml);
+}
+
+void OdsStreamWriterImpl::closeSheet() {
+    OdsWriterImpl::writeTableEnd(tablesXml);
+}
+
+void OdsStreamWriterImpl::closeFile(const Names& names) {
+    if (names.empty()) {
+        startTables();
+    }
+    OdsWriterImpl::writeManifest(xml);
+    writeContent();
+    OdsWriterImpl::writeFixedParts(xml);
+    ar.close();
+}
+
+void OdsStreamWriterImpl::startTables() {
+    tables.setCompression(ar.getCompression());
+    tablesXml.openEntry("content.xml");
+}
+
+void OdsStreamWriterImpl::writeContent() {
+    OdsWriterImpl::writeContentEnd(tablesXml);
+    ZipArchive content;
+    content.setCompression(tables.getCompression());
+    XmlWriter contentXml(content);
+    // styles 1 are the default styles
+    OdsWriterImpl::writeContentStart(contentXml);
+    OdsWriterImpl::writeColumnStyle(1, -1, contentXml);
+    for (Styles::const_iterator i = columnStyles.begin();
+         i != columnStyles.end(); ++i) {
+        OdsWriterImpl::writeColumnStyle(i->second, i->first, contentXml);
+    }
+    OdsWriterImpl::writeRowStyle(1, -1, contentXml);
+    for (Styles::const_iterator i = rowStyles.begin();
+         i != rowStyles.end(); ++i) {
+        OdsWriterImpl::writeRowStyle(i->second, i->first, contentXml);
+    }
+    OdsWriterImpl::writeBodyStart(contentXml);
+    contentXml.closeEntry();
+    content.appendEntry(tables);
+    ar.writeEntries(content);
+}
+
+int OdsStreamWriterImpl::style(Styles& styles, double size) {
+    Styles::iterator i = styles.find(size);
+    if (i != styles.end()) {
+        return i->second;
+    }
+    int res = (int)styles.size() + 2; // style 1 is the default
+    styles.insert(Styles::value_type(size, res));
+    return res;
+}
+
+}
@@ -0,0 +1,105 @@
+// File: OdsStreamWriterImpl.h
+// OdsStreamWriterImpl declaration file
+//
+
+#ifndef ODSSTREAMWRITERIMPL_H
+#define ODSSTREAMWRITERIMPL_H
+
+#include "splib.h"
+#include "StreamWriterBase.h"
+#include "ZipArchive.h"
+#include "XmlWriter.h"
+#include <map>
+
+namespace splib {
+
+/**
+ * The implementation of <code>OdsStreamWriter</code>. The automatic styles
+ * of content.xml precede the tables, but the row heights and column widths
+ * are only known once the tables are written. The tables are therefore
+ * compressed into an entry of an archive in memory as they arrive, and
+ * each distinct height and width is given a style. When the writer is
+ * closed, the start of content.xml and the styles are compressed into
+ * another entry in memory, the tables are joined to it without being
+ * compressed again, and the entry is stored into the package.
+ */
+class OdsStreamWriterImpl : public StreamWriterBase {
+    public:
+        /**
+         * Creates a new instance of <code>OdsStreamWriterImpl</code>.
+         * @param pathname a pointer to the path name of the file to write
+         */
+        OdsStreamWriterImpl(const _TCHAR* pathname);
+
+        /**
+         * Creates a new instance of <code>OdsStreamWriterImpl</code>.
+         * @param sink the sink to write the file to
+         */
+        OdsStreamWriterImpl(OutputSink& sink);
+
+        /** Sets the compression of the entries opened from now on. */
+        void setCompression(const CompressionOptions& compression);
+
+    protected:
+        // inherit doc
+        virtual void openSheet(int index, const _TCHAR* name,
+                               const Widths& widths);
+
+        // inherit doc
+        virtual void outputRow(int row, double height, int first,
+                               const CellValue* values, int count);
+
+        // inherit doc
+        virtual void closeSheet();
+
+        // inherit doc
+        virtual void closeFile(const Names& names);
+
+    private:
+        /** The numbers of the styles, by row height or column width */
+        typedef std::map<double, int> Styles;
+
+        /**
+         * Opens the entry in memory that receives the tables, with the
+         * compression of content.xml.
+         */
+        void startTables();
+
+        /**
+         * Writes content.xml into the package: its start and the styles,
+         * followed by the tables written so far.
+         */
+        void writeContent();
+
+        /**
+         * Retrieves the number of the style for a size, adding a style
+         * if there is none.
+         */
+        static int style(Styles& styles, double size);
+
+    private:
+        /** The package */
+        ZipArchive ar;
+
+        /** The writer of the entries of the package */
+        XmlWriter xml;
+
+        /** The archive in memory that keeps the compressed tables */
+        ZipArchive tables;
+
+        /** The writer of the tables */
+        XmlWriter tablesXml;
+
+        /** The styles of the columns */
+        Styles columnStyles;
+
+        /** The styles of the rows */
+        Styles rowStyles;
+
+        /** The index of the last row written to the current sheet, or -1 */
+        int lastRow;
+};
+
+}
+
+#endif // ODSSTREAMWRITERIMPL_H
@@ -8,8 +8,20 @@
 
 namespace splib {
 
+void OdsWriter::setCompression(const CompressionOptions& compression) {
+    this->compression = compression;
+}
+
+const CompressionOptions& OdsWriter::getCompression() const {
+    return compression;
+}
+
 void OdsWriter::write(Spreadsheet& spreadsheet, const _TCHAR* pathname) {
-    OdsWriterImpl::write(spreadsheet, pathname);
+    OdsWriterImpl::write(spreadsheet, pathname, compression);
+}
+
+void OdsWriter::write(Spreadsheet& spreadsheet, OutputSink& sink) {
+    OdsWriterImpl::write(spreadsheet, sink, compression);
 }
 
 }
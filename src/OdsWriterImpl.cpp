@@ -6,325 +6,384 @@
 #include <stdio.h>
 #include "OdsWriterImpl.h"
 #include "ZipArchive.h"
-#include "ToUTF8.h"
-#include "Strings.h"
+#include "XmlWriter.h"
 #include "Formulas.h"
 #include "Util.h"
+#include "TableWalker.h"
+#include "IndexLimits.h"
 #include "splibint.h"
 
 namespace splib {
 
-void OdsWriterImpl::write(Spreadsheet& spreadsheet, const _TCHAR* pathname) {
+class OdsWriterImpl::RowWriter {
+    public:
+        RowWriter(TableWalker& walker, int& nextRowStyle, XmlWriter& xml)
+            : walker(walker), nextRowStyle(nextRowStyle), xml(xml),
+              lastRowIndex(-1), lastCellIndex(-1) {}
+
+        void row(int index, Row& row) {
+            double height = row.getHeight();
+            if (row.cells().size() == 0 && height < 0) {
+                return;
+            }
+            writeEmptyRows(index - lastRowIndex - 1, xml);
+            lastRowIndex = index;
+            int style = 1;
+            if (height >= 0) {
+                style = nextRowStyle++;
+            }
+            writeRowStart(style, xml);
+            lastCellIndex = -1;
+            walker.forEachCell(index, row, *this);
+            writeRowEnd(xml);
+        }
+
+        void cell(int column, Cell& cell) {
+            if (cell.getType() == Cell::NONE) {
+                return;
+            }
+            writeEmptyCells(column - lastCellIndex - 1, xml);
+            lastCellIndex = column;
+            writeCell(cell, xml);
+        }
+
+    private:
+        /** The walker of the table */
+        TableWalker& walker;
+
+        /** The number of the next row style */
+        int& nextRowStyle;
+
+        /** The archive to write to */
+        XmlWriter& xml;
+
+        /** The index of the last row written */
+        int lastRowIndex;
+
+        /** The index of the last cell written in the current row */
+        int lastCellIndex;
+};
+
+void OdsWriterImpl::write(Spreadsheet& spreadsheet, const _TCHAR* pathname,
+                          const CompressionOptions& compression) {
+    IndexLimits::checkSpreadsheet(spreadsheet, IndexLimits::ODS_COLUMNS,
+                                  IndexLimits::ODS_ROWS);
     ZipArchive ar(pathname);
-    writeManifest(ar);
-    writeContent(spreadsheet, ar);
-    writeMeta(ar);
-    writeMimetype(ar);
-    writeSettings(ar);
-    writeStyles(ar);
+    ar.setCompression(compression);
+    writePackage(spreadsheet, ar);
+}
+
+void OdsWriterImpl::write(Spreadsheet& spreadsheet, OutputSink& sink,
+                          const CompressionOptions& compression) {
+    IndexLimits::checkSpreadsheet(spreadsheet, IndexLimits::ODS_COLUMNS,
+                                  IndexLimits::ODS_ROWS);
+    ZipArchive ar(sink);
+    ar.setCompression(compression);
+    writePackage(spreadsheet, ar);
+}
+
+void OdsWriterImpl::writePackage(Spreadsheet& spreadsheet, ZipArchive& ar) {
+    XmlWriter xml(ar);
+    writeManifest(xml);
+    writeContent(spreadsheet, xml);
+    writeFixedParts(xml);
     ar.close();
 }
 
-void OdsWriterImpl::writeManifest(ZipArchive& ar) {
-    ar.openEntry("META-INF/manifest.xml");
-    ar << "<\?xml version=\"1.0\" encoding=\"UTF-8\"\?>\r\n"
-          "<!DOCTYPE manifest:manifest PUBLIC \"-//OpenOffice.org//DTD Manifest 1.0//EN\" \"Manifest.dtd\">\r\n"
-          "<manifest:manifest xmlns:manifest=\"urn:oasis:names:tc:opendocument:xmlns:manifest:1.0\">\r\n"
-          "<manifest:file-entry manifest:media-type=\"application/vnd.oasis.opendocument.spreadsheet\" manifest:full-path=\"/\"/>\r\n"
-          "<manifest:file-entry manifest:media-type=\"text/xml\" manifest:full-path=\"content.xml\"/>\r\n"
-          "<manifest:file-entry manifest:media-type=\"text/xml\" manifest:full-path=\"styles.xml\"/>\r\n"
-          "<manifest:file-entry manifest:media-type=\"text/xml\" manifest:full-path=\"meta.xml\"/>\r\n"
-          "<manifest:file-entry manifest:media-type=\"text/xml\" manifest:full-path=\"settings.xml\"/>\r\n"
-          "</manifest:manifest>\r\n";
-    ar.closeEntry();
-}
-
-void OdsWriterImpl::writeContent(Spreadsheet& sp, ZipArchive& ar) {
-    ar.openEntry("content.xml");
-    ar << "<\?xml version=\"1.0\" encoding=\"UTF-8\"\?>\r\n"
-          "<office:document-content xmlns:office=\"urn:oasis:names:tc:opendocument:xmlns:office:1.0\" xmlns:style=\"urn:oasis:names:tc:opendocument:xmlns:style:1.0\" xmlns:text=\"urn:oasis:names:tc:opendocument:xmlns:text:1.0\" xmlns:table=\"urn:oasis:names:tc:opendocument:xmlns:table:1.0\" xmlns:draw=\"urn:oasis:names:tc:opendocument:xmlns:drawing:1.0\" xmlns:fo=\"urn:oasis:names:tc:opendocument:xmlns:xsl-fo-compatible:1.0\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\" xmlns:meta=\"urn:oasis:names:tc:opendocument:xmlns:meta:1.0\" xmlns:number=\"urn:oasis:names:tc:opendocument:xmlns:datastyle:1.0\" xmlns:svg=\"urn:oasis:names:tc:opendocument:xmlns:svg-compatible:1.0\" xmlns:chart=\"urn:oasis:names:tc:opendocument:xmlns:chart:1.0\" xmlns:dr3d=\"urn:oasis:names:tc:opendocument:xmlns:dr3d:1.0\" xmlns:math=\"http://www.w3.org/1998/Math/MathML\" xmlns:form=\"urn:oasis:names:tc:opendocument:xmlns:form:1.0\" xmlns:script=\"urn:oasis:names:tc:opendocument:xmlns:script:1.0\" xmlns:ooo=\"http://openoffice.org/2004/office\" xmlns:ooow=\"http://openoffice.org/2004/writer\" xmlns:oooc=\"http://openoffice.org/2004/calc\" xmlns:dom=\"http://www.w3.org/2001/xml-events\" xmlns:xforms=\"http://www.w3.org/2002/xforms\" xmlns:xsd=\"http://www.w3.org/2001/XMLSchema\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" office:version=\"1.0\">\r\n"
-          "<office:scripts/>\r\n"
-          "<office:font-face-decls>\r\n"
-          "<style:font-face style:name=\"Andale Sans UI\" svg:font-family=\"&apos;Andale Sans UI&apos;\" style:font-pitch=\"variable\"/>\r\n"
-          "<style:font-face style:name=\"Tahoma\" svg:font-family=\"Tahoma\" style:font-pitch=\"variable\"/>\r\n"
-          "<style:font-face style:name=\"Albany\" svg:font-family=\"Albany\" style:font-family-generic=\"swiss\" style:font-pitch=\"variable\"/>\r\n"
-          "</office:font-face-decls>\r\n"
-          "<office:automatic-styles>\r\n";
+void OdsWriterImpl::writeFixedParts(XmlWriter& xml) {
+    writeMeta(xml);
+    writeMimetype(xml);
+    writeSettings(xml);
+    writeStyles(xml);
+}
+
+void OdsWriterImpl::writeManifest(XmlWriter& xml) {
+    xml.openEntry("META-INF/manifest.xml");
+    xml << "<\?xml version=\"1.0\" encoding=\"UTF-8\"\?>\r\n"
+           "<!DOCTYPE manifest:manifest PUBLIC \"-//OpenOffice.org//DTD Manifest 1.0//EN\" \"Manifest.dtd\">\r\n"
+           "<manifest:manifest xmlns:manifest=\"urn:oasis:names:tc:opendocument:xmlns:manifest:1.0\">\r\n"
+           "<manifest:file-entry manifest:media-type=\"application/vnd.oasis.opendocument.spreadsheet\" manifest:full-path=\"/\"/>\r\n"
+           "<manifest:file-entry manifest:media-type=\"text/xml\" manifest:full-path=\"content.xml\"/>\r\n"
+           "<manifest:file-entry manifest:media-type=\"text/xml\" manifest:full-path=\"styles.xml\"/>\r\n"
+           "<manifest:file-entry manifest:media-type=\"text/xml\" manifest:full-path=\"meta.xml\"/>\r\n"
+           "<manifest:file-entry manifest:media-type=\"text/xml\" manifest:full-path=\"settings.xml\"/>\r\n"
+           "</manifest:manifest>\r\n";
+    xml.closeEntry();
+}
+
+void OdsWriterImpl::writeContent(Spreadsheet& sp, XmlWriter& xml) {
+    writeContentStart(xml);
     int nextColumnStyle;
-    writeColumnStyles(sp, nextColumnStyle, ar);
+    writeColumnStyles(sp, nextColumnStyle, xml);
     int nextRowStyle;
-    writeRowStyles(sp, nextRowStyle, ar);
-    writeCellStyles(ar);
-    ar << "<style:style style:name=\"ta1\" style:family=\"table\" style:master-page-name=\"Default\">\r\n"
-          "<style:table-properties table:display=\"true\" style:writing-mode=\"lr-tb\"/>\r\n"
-          "</style:style>\r\n"
-          "</office:automatic-styles>\r\n"
-          "<office:body>\r\n"
-          "<office:spreadsheet>\r\n";
+    writeRowStyles(sp, nextRowStyle, xml);
+    writeBodyStart(xml);
     for (int i = 0; i < sp.tableCount(); i++) {
-        writeTable(sp.table(i), nextColumnStyle, nextRowStyle, ar);
+        writeTable(sp.table(i), nextColumnStyle, nextRowStyle, xml);
     }
-    ar << "</office:spreadsheet>\r\n"
-          "</office:body>\r\n"
-          "</office:document-content>\r\n";
-    ar.closeEntry();
-}
-
-void OdsWriterImpl::writeMeta(ZipArchive& ar) {
-    ar.openEntry("meta.xml");
-    ar << "<\?xml version=\"1.0\" encoding=\"UTF-8\"\?>\r\n"
-          "<office:document-meta xmlns:office=\"urn:oasis:names:tc:opendocument:xmlns:office:1.0\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\" xmlns:meta=\"urn:oasis:names:tc:opendocument:xmlns:meta:1.0\" xmlns:ooo=\"http://openoffice.org/2004/office\" office:version=\"1.0\">\r\n"
-          "<office:meta>\r\n"
-          "<meta:user-defined meta:name=\"Info 1\"/>\r\n"
-          "<meta:user-defined meta:name=\"Info 2\"/>\r\n"
-          "<meta:user-defined meta:name=\"Info 3\"/>\r\n"
-          "<meta:user-defined meta:name=\"Info 4\"/>\r\n"
-          "</office:meta>\r\n"
-          "</office:document-meta>\r\n";
-    ar.closeEntry();
-}
-
-void OdsWriterImpl::writeMimetype(ZipArchive& ar) {
-    ar.openEntry("mimetype");
-    ar << "application/vnd.oasis.opendocument.spreadsheet";
-    ar.closeEntry();
-}
-
-void OdsWriterImpl::writeSettings(ZipArchive& ar) {
-    ar.openEntry("settings.xml");
-    ar << "<\?xml version=\"1.0\" encoding=\"UTF-8\"\?>\r\n"
-          "<office:document-settings xmlns:office=\"urn:oasis:names:tc:opendocument:xmlns:office:1.0\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:config=\"urn:oasis:names:tc:opendocument:xmlns:config:1.0\" xmlns:ooo=\"http://openoffice.org/2004/office\" office:version=\"1.0\">\r\n"
-          "<office:settings>\r\n"
-          "<config:config-item-set config:name=\"ooo:view-settings\">\r\n"
-          "<config:config-item config:name=\"VisibleAreaTop\" config:type=\"int\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"VisibleAreaLeft\" config:type=\"int\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"VisibleAreaWidth\" config:type=\"int\">2258</config:config-item>\r\n"
-          "<config:config-item config:name=\"VisibleAreaHeight\" config:type=\"int\">451</config:config-item>\r\n"
-          "<config:config-item-map-indexed config:name=\"Views\">\r\n"
-          "<config:config-item-map-entry>\r\n"
-          "<config:config-item config:name=\"ViewId\" config:type=\"string\">View1</config:config-item>\r\n"
-          "<config:config-item-map-named config:name=\"Tables\">\r\n"
-          "<config:config-item-map-entry config:name=\"Sheet1\">\r\n"
-          "<config:config-item config:name=\"CursorPositionX\" config:type=\"int\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"CursorPositionY\" config:type=\"int\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"HorizontalSplitMode\" config:type=\"short\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"VerticalSplitMode\" config:type=\"short\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"HorizontalSplitPosition\" config:type=\"int\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"VerticalSplitPosition\" config:type=\"int\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"ActiveSplitRange\" config:type=\"short\">2</config:config-item>\r\n"
-          "<config:config-item config:name=\"PositionLeft\" config:type=\"int\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"PositionRight\" config:type=\"int\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"PositionTop\" config:type=\"int\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"PositionBottom\" config:type=\"int\">0</config:config-item>\r\n"
-          "</config:config-item-map-entry>\r\n"
-          "</config:config-item-map-named>\r\n"
-          "<config:config-item config:name=\"ActiveTable\" config:type=\"string\">Sheet1</config:config-item>\r\n"
-          "<config:config-item config:name=\"HorizontalScrollbarWidth\" config:type=\"int\">600</config:config-item>\r\n"
-          "<config:config-item config:name=\"ZoomType\" config:type=\"short\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"ZoomValue\" config:type=\"int\">100</config:config-item>\r\n"
-          "<config:config-item config:name=\"PageViewZoomValue\" config:type=\"int\">60</config:config-item>\r\n"
-          "<config:config-item config:name=\"ShowPageBreakPreview\" config:type=\"boolean\">false</config:config-item>\r\n"
-          "<config:config-item config:name=\"ShowZeroValues\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"ShowNotes\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"ShowGrid\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"GridColor\" config:type=\"long\">12632256</config:config-item>\r\n"
-          "<config:config-item config:name=\"ShowPageBreaks\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"HasColumnRowHeaders\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"HasSheetTabs\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"IsOutlineSymbolsSet\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"IsSnapToRaster\" config:type=\"boolean\">false</config:config-item>\r\n"
-          "<config:config-item config:name=\"RasterIsVisible\" config:type=\"boolean\">false</config:config-item>\r\n"
-          "<config:config-item config:name=\"RasterResolutionX\" config:type=\"int\">1000</config:config-item>\r\n"
-          "<config:config-item config:name=\"RasterResolutionY\" config:type=\"int\">1000</config:config-item>\r\n"
-          "<config:config-item config:name=\"RasterSubdivisionX\" config:type=\"int\">1</config:config-item>\r\n"
-          "<config:config-item config:name=\"RasterSubdivisionY\" config:type=\"int\">1</config:config-item>\r\n"
-          "<config:config-item config:name=\"IsRasterAxisSynchronized\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "</config:config-item-map-entry>\r\n"
-          "</config:config-item-map-indexed>\r\n"
-          "</config:config-item-set>\r\n"
-          "<config:config-item-set config:name=\"ooo:configuration-settings\">\r\n"
-          "<config:config-item config:name=\"ShowZeroValues\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"ShowNotes\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"ShowGrid\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"GridColor\" config:type=\"long\">12632256</config:config-item>\r\n"
-          "<config:config-item config:name=\"ShowPageBreaks\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"LinkUpdateMode\" config:type=\"short\">3</config:config-item>\r\n"
-          "<config:config-item config:name=\"HasColumnRowHeaders\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"HasSheetTabs\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"IsOutlineSymbolsSet\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"IsSnapToRaster\" config:type=\"boolean\">false</config:config-item>\r\n"
-          "<config:config-item config:name=\"RasterIsVisible\" config:type=\"boolean\">false</config:config-item>\r\n"
-          "<config:config-item config:name=\"RasterResolutionX\" config:type=\"int\">1000</config:config-item>\r\n"
-          "<config:config-item config:name=\"RasterResolutionY\" config:type=\"int\">1000</config:config-item>\r\n"
-          "<config:config-item config:name=\"RasterSubdivisionX\" config:type=\"int\">1</config:config-item>\r\n"
-          "<config:config-item config:name=\"RasterSubdivisionY\" config:type=\"int\">1</config:config-item>\r\n"
-          "<config:config-item config:name=\"IsRasterAxisSynchronized\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"AutoCalculate\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"ApplyUserData\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"CharacterCompressionType\" config:type=\"short\">0</config:config-item>\r\n"
-          "<config:config-item config:name=\"IsKernAsianPunctuation\" config:type=\"boolean\">false</config:config-item>\r\n"
-          "<config:config-item config:name=\"SaveVersionOnClose\" config:type=\"boolean\">false</config:config-item>\r\n"
-          "<config:config-item config:name=\"UpdateFromTemplate\" config:type=\"boolean\">false</config:config-item>\r\n"
-          "<config:config-item config:name=\"AllowPrintJobCancel\" config:type=\"boolean\">true</config:config-item>\r\n"
-          "<config:config-item config:name=\"LoadReadonly\" config:type=\"boolean\">false</config:config-item>\r\n"
-          "</config:config-item-set>\r\n"
-          "</office:settings>\r\n"
-          "</office:document-settings>\r\n";
-    ar.closeEntry();
-}
-
-void OdsWriterImpl::writeStyles(ZipArchive& ar) {
-    ar.openEntry("styles.xml");
-    ar << "<\?xml version=\"1.0\" encoding=\"UTF-8\"\?>\r\n"
-          "<office:document-styles xmlns:office=\"urn:oasis:names:tc:opendocument:xmlns:office:1.0\" xmlns:style=\"urn:oasis:names:tc:opendocument:xmlns:style:1.0\" xmlns:text=\"urn:oasis:names:tc:opendocument:xmlns:text:1.0\" xmlns:table=\"urn:oasis:names:tc:opendocument:xmlns:table:1.0\" xmlns:draw=\"urn:oasis:names:tc:opendocument:xmlns:drawing:1.0\" xmlns:fo=\"urn:oasis:names:tc:opendocument:xmlns:xsl-fo-compatible:1.0\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\" xmlns:meta=\"urn:oasis:names:tc:opendocument:xmlns:meta:1.0\" xmlns:number=\"urn:oasis:names:tc:opendocument:xmlns:datastyle:1.0\" xmlns:svg=\"urn:oasis:names:tc:opendocument:xmlns:svg-compatible:1.0\" xmlns:chart=\"urn:oasis:names:tc:opendocument:xmlns:chart:1.0\" xmlns:dr3d=\"urn:oasis:names:tc:opendocument:xmlns:dr3d:1.0\" xmlns:math=\"http://www.w3.org/1998/Math/MathML\" xmlns:form=\"urn:oasis:names:tc:opendocument:xmlns:form:1.0\" xmlns:script=\"urn:oasis:names:tc:opendocument:xmlns:script:1.0\" xmlns:ooo=\"http://openoffice.org/2004/office\" xmlns:ooow=\"http://openoffice.org/2004/writer\" xmlns:oooc=\"http://openoffice.org/2004/calc\" xmlns:dom=\"http://www.w3.org/2001/xml-events\" office:version=\"1.0\">\r\n"
-          "<office:font-face-decls>\r\n"
-          "<style:font-face style:name=\"Andale Sans UI\" svg:font-family=\"&apos;Andale Sans UI&apos;\" style:font-pitch=\"variable\"/>\r\n"
-          "<style:font-face style:name=\"Tahoma\" svg:font-family=\"Tahoma\" style:font-pitch=\"variable\"/>\r\n"
-          "<style:font-face style:name=\"Albany\" svg:font-family=\"Albany\" style:font-family-generic=\"swiss\" style:font-pitch=\"variable\"/>\r\n"
-          "</office:font-face-decls>\r\n"
-          "<office:styles>\r\n"
-          "<style:default-style style:family=\"table-cell\">\r\n"
-          "<style:table-cell-properties style:decimal-places=\"2\"/>\r\n"
-          "<style:paragraph-properties style:tab-stop-distance=\"1.25cm\"/>\r\n"
-          "<style:text-properties style:font-name=\"Albany\" fo:language=\"en\" fo:country=\"US\" style:font-name-asian=\"Andale Sans UI\" style:language-asian=\"none\" style:country-asian=\"none\" style:font-name-complex=\"Tahoma\" style:language-complex=\"none\" style:country-complex=\"none\"/>\r\n"
-          "</style:default-style>\r\n"
-          "<number:number-style style:name=\"N0\">\r\n"
-          "<number:number number:min-integer-digits=\"1\"/>\r\n"
-          "</number:number-style>\r\n"
-          "<number:currency-style style:name=\"N104P0\" style:volatile=\"true\">\r\n"
-          "<number:number number:decimal-places=\"2\" number:min-integer-digits=\"1\" number:grouping=\"true\"/>\r\n"
-          "</number:currency-style>\r\n"
-          "<number:currency-style style:name=\"N104\">\r\n"
-          "<style:text-properties fo:color=\"#ff0000\"/>\r\n"
-          "<number:text>-</number:text>\r\n"
-          "<number:number number:decimal-places=\"2\" number:min-integer-digits=\"1\" number:grouping=\"true\"/>\r\n"
-          "<style:map style:condition=\"value()&gt;=0\" style:apply-style-name=\"N104P0\"/>\r\n"
-          "</number:currency-style>\r\n"
-          "<style:style style:name=\"Default\" style:family=\"table-cell\"/>\r\n"
-          "<style:style style:name=\"Result\" style:family=\"table-cell\" style:parent-style-name=\"Default\">\r\n"
-          "<style:text-properties fo:font-style=\"italic\" style:text-underline-style=\"solid\" style:text-underline-width=\"auto\" style:text-underline-color=\"font-color\" fo:font-weight=\"bold\"/>\r\n"
-          "</style:style>\r\n"
-          "<style:style style:name=\"Result2\" style:family=\"table-cell\" style:parent-style-name=\"Result\" style:data-style-name=\"N104\"/>\r\n"
-          "<style:style style:name=\"Heading\" style:family=\"table-cell\" style:parent-style-name=\"Default\">\r\n"
-          "<style:table-cell-properties style:text-align-source=\"fix\" style:repeat-content=\"false\"/>\r\n"
-          "<style:paragraph-properties fo:text-align=\"center\"/>\r\n"
-          "<style:text-properties fo:font-size=\"16pt\" fo:font-style=\"italic\" fo:font-weight=\"bold\"/>\r\n"
-          "</style:style>\r\n"
-          "<style:style style:name=\"Heading1\" style:family=\"table-cell\" style:parent-style-name=\"Heading\">\r\n"
-          "<style:table-cell-properties style:rotation-angle=\"90\"/>\r\n"
-          "</style:style>\r\n"
-          "</office:styles>\r\n"
-          "<office:automatic-styles>\r\n"
-          "<style:page-layout style:name=\"pm1\">\r\n"
-          "<style:page-layout-properties style:writing-mode=\"lr-tb\"/>\r\n"
-          "<style:header-style>\r\n"
-          "<style:header-footer-properties fo:min-height=\"0.751cm\" fo:margin-left=\"0cm\" fo:margin-right=\"0cm\" fo:margin-bottom=\"0.25cm\"/>\r\n"
-          "</style:header-style>\r\n"
-          "<style:footer-style>\r\n"
-          "<style:header-footer-properties fo:min-height=\"0.751cm\" fo:margin-left=\"0cm\" fo:margin-right=\"0cm\" fo:margin-top=\"0.25cm\"/>\r\n"
-          "</style:footer-style>\r\n"
-          "</style:page-layout>\r\n"
-          "<style:page-layout style:name=\"pm2\">\r\n"
-          "<style:page-layout-properties style:writing-mode=\"lr-tb\"/>\r\n"
-          "<style:header-style>\r\n"
-          "<style:header-footer-properties fo:min-height=\"0.751cm\" fo:margin-left=\"0cm\" fo:margin-right=\"0cm\" fo:margin-bottom=\"0.25cm\" fo:border=\"0.088cm solid #000000\" fo:padding=\"0.018cm\" fo:background-color=\"#c0c0c0\">\r\n"
-          "<style:background-image/>\r\n"
-          "</style:header-footer-properties>\r\n"
-          "</style:header-style>\r\n"
-          "<style:footer-style>\r\n"
-          "<style:header-footer-properties fo:min-height=\"0.751cm\" fo:margin-left=\"0cm\" fo:margin-right=\"0cm\" fo:margin-top=\"0.25cm\" fo:border=\"0.088cm solid #000000\" fo:padding=\"0.018cm\" fo:background-color=\"#c0c0c0\">\r\n"
-          "<style:background-image/>\r\n"
-          "</style:header-footer-properties>\r\n"
-          "</style:footer-style>\r\n"
-          "</style:page-layout>\r\n"
-          "</office:automatic-styles>\r\n"
-          "<office:master-styles>\r\n"
-          "<style:master-page style:name=\"Default\" style:page-layout-name=\"pm1\">\r\n"
-          "<style:header>\r\n"
-          "<text:p>\r\n"
-          "<text:sheet-name>\?\?\?</text:sheet-name>\r\n"
-          "</text:p>\r\n"
-          "</style:header>\r\n"
-          "<style:header-left style:display=\"false\"/>\r\n"
-          "<style:footer>\r\n"
-          "<text:p>Page <text:page-number>1</text:page-number>\r\n"
-          "</text:p>\r\n"
-          "</style:footer>\r\n"
-          "<style:footer-left style:display=\"false\"/>\r\n"
-          "</style:master-page>\r\n"
-          "<style:master-page style:name=\"Report\" style:page-layout-name=\"pm2\">\r\n"
-          "<style:header>\r\n"
-          "<style:region-left>\r\n"
-          "<text:p>\r\n"
-          "<text:sheet-name>\?\?\?</text:sheet-name> (<text:title>\?\?\?</text:title>)</text:p>\r\n"
-          "</style:region-left>\r\n"
-          "<style:region-right>\r\n"
-          "<text:p>\r\n"
-          "</text:p>\r\n"
-          "</style:region-right>\r\n"
-          "</style:header>\r\n"
-          "<style:header-left style:display=\"false\"/>\r\n"
-          "<style:footer>\r\n"
-          "<text:p>Page <text:page-number>1</text:page-number> / <text:page-count>99</text:page-count>\r\n"
-          "</text:p>\r\n"
-          "</style:footer>\r\n"
-          "<style:footer-left style:display=\"false\"/>\r\n"
-          "</style:master-page>\r\n"
-          "</office:master-styles>\r\n"
-          "</office:document-styles>\r\n";
-    ar.closeEntry();
+    writeContentEnd(xml);
+}
+
+void OdsWriterImpl::writeContentStart(XmlWriter& xml) {
+    xml.openEntry("content.xml");
+    xml << "<\?xml version=\"1.0\" encoding=\"UTF-8\"\?>\r\n"
+           "<office:document-content xmlns:office=\"urn:oasis:names:tc:opendocument:xmlns:office:1.0\" xmlns:style=\"urn:oasis:names:tc:opendocument:xmlns:style:1.0\" xmlns:text=\"urn:oasis:names:tc:opendocument:xmlns:text:1.0\" xmlns:table=\"urn:oasis:names:tc:opendocument:xmlns:table:1.0\" xmlns:draw=\"urn:oasis:names:tc:opendocument:xmlns:drawing:1.0\" xmlns:fo=\"urn:oasis:names:tc:opendocument:xmlns:xsl-fo-compatible:1.0\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\" xmlns:meta=\"urn:oasis:names:tc:opendocument:xmlns:meta:1.0\" xmlns:number=\"urn:oasis:names:tc:opendocument:xmlns:datastyle:1.0\" xmlns:svg=\"urn:oasis:names:tc:opendocument:xmlns:svg-compatible:1.0\" xmlns:chart=\"urn:oasis:names:tc:opendocument:xmlns:chart:1.0\" xmlns:dr3d=\"urn:oasis:names:tc:opendocument:xmlns:dr3d:1.0\" xmlns:math=\"http://www.w3.org/1998/Math/MathML\" xmlns:form=\"urn:oasis:names:tc:opendocument:xmlns:form:1.0\" xmlns:script=\"urn:oasis:names:tc:opendocument:xmlns:script:1.0\" xmlns:ooo=\"http://openoffice.org/2004/office\" xmlns:ooow=\"http://openoffice.org/2004/writer\" xmlns:oooc=\"http://openoffice.org/2004/calc\" xmlns:dom=\"http://www.w3.org/2001/xml-events\" xmlns:xforms=\"http://www.w3.org/2002/xforms\" xmlns:xsd=\"http://www.w3.org/2001/XMLSchema\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" office:version=\"1.0\">\r\n"
+           "<office:scripts/>\r\n"
+           "<office:font-face-decls>\r\n"
+           "<style:font-face style:name=\"Andale Sans UI\" svg:font-family=\"&apos;Andale Sans UI&apos;\" style:font-pitch=\"variable\"/>\r\n"
+           "<style:font-face style:name=\"Tahoma\" svg:font-family=\"Tahoma\" style:font-pitch=\"variable\"/>\r\n"
+           "<style:font-face style:name=\"Albany\" svg:font-family=\"Albany\" style:font-family-generic=\"swiss\" style:font-pitch=\"variable\"/>\r\n"
+           "</office:font-face-decls>\r\n"
+           "<office:automatic-styles>\r\n";
+}
+
+void OdsWriterImpl::writeBodyStart(XmlWriter& xml) {
+    writeCellStyles(xml);
+    xml << "<style:style style:name=\"ta1\" style:family=\"table\" style:master-page-name=\"Default\">\r\n"
+           "<style:table-properties table:display=\"true\" style:writing-mode=\"lr-tb\"/>\r\n"
+           "</style:style>\r\n"
+           "</office:automatic-styles>\r\n"
+           "<office:body>\r\n"
+           "<office:spreadsheet>\r\n";
+}
+
+void OdsWriterImpl::writeContentEnd(XmlWriter& xml) {
+    xml << "</office:spreadsheet>\r\n"
+           "</office:body>\r\n"
+           "</office:document-content>\r\n";
+    xml.closeEntry();
+}
+
+void OdsWriterImpl::writeMeta(XmlWriter& xml) {
+    xml.openEntry("meta.xml");
+    xml << "<\?xml version=\"1.0\" encoding=\"UTF-8\"\?>\r\n"
+           "<office:document-meta xmlns:office=\"urn:oasis:names:tc:opendocument:xmlns:office:1.0\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\" xmlns:meta=\"urn:oasis:names:tc:opendocument:xmlns:meta:1.0\" xmlns:ooo=\"http://openoffice.org/2004/office\" office:version=\"1.0\">\r\n"
+           "<office:meta>\r\n"
+           "<meta:user-defined meta:name=\"Info 1\"/>\r\n"
+           "<meta:user-defined meta:name=\"Info 2\"/>\r\n"
+           "<meta:user-defined meta:name=\"Info 3\"/>\r\n"
+           "<meta:user-defined meta:name=\"Info 4\"/>\r\n"
+           "</office:meta>\r\n"
+           "</office:document-meta>\r\n";
+    xml.closeEntry();
+}
+
+void OdsWriterImpl::writeMimetype(XmlWriter& xml) {
+    xml.openEntry("mimetype");
+    xml << "application/vnd.oasis.opendocument.spreadsheet";
+    xml.closeEntry();
+}
+
+void OdsWriterImpl::writeSettings(XmlWriter& xml) {
+    xml.openEntry("settings.xml");
+    xml << "<\?xml version=\"1.0\" encoding=\"UTF-8\"\?>\r\n"
+           "<office:document-settings xmlns:office=\"urn:oasis:names:tc:opendocument:xmlns:office:1.0\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:config=\"urn:oasis:names:tc:opendocument:xmlns:config:1.0\" xmlns:ooo=\"http://openoffice.org/2004/office\" office:version=\"1.0\">\r\n"
+           "<office:settings>\r\n"
+           "<config:config-item-set config:name=\"ooo:view-settings\">\r\n"
+           "<config:config-item config:name=\"VisibleAreaTop\" config:type=\"int\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"VisibleAreaLeft\" config:type=\"int\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"VisibleAreaWidth\" config:type=\"int\">2258</config:config-item>\r\n"
+           "<config:config-item config:name=\"VisibleAreaHeight\" config:type=\"int\">451</config:config-item>\r\n"
+           "<config:config-item-map-indexed config:name=\"Views\">\r\n"
+           "<config:config-item-map-entry>\r\n"
+           "<config:config-item config:name=\"ViewId\" config:type=\"string\">View1</config:config-item>\r\n"
+           "<config:config-item-map-named config:name=\"Tables\">\r\n"
+           "<config:config-item-map-entry config:name=\"Sheet1\">\r\n"
+           "<config:config-item config:name=\"CursorPositionX\" config:type=\"int\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"CursorPositionY\" config:type=\"int\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"HorizontalSplitMode\" config:type=\"short\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"VerticalSplitMode\" config:type=\"short\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"HorizontalSplitPosition\" config:type=\"int\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"VerticalSplitPosition\" config:type=\"int\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"ActiveSplitRange\" config:type=\"short\">2</config:config-item>\r\n"
+           "<config:config-item config:name=\"PositionLeft\" config:type=\"int\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"PositionRight\" config:type=\"int\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"PositionTop\" config:type=\"int\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"PositionBottom\" config:type=\"int\">0</config:config-item>\r\n"
+           "</config:config-item-map-entry>\r\n"
+           "</config:config-item-map-named>\r\n"
+           "<config:config-item config:name=\"ActiveTable\" config:type=\"string\">Sheet1</config:config-item>\r\n"
+           "<config:config-item config:name=\"HorizontalScrollbarWidth\" config:type=\"int\">600</config:config-item>\r\n"
+           "<config:config-item config:name=\"ZoomType\" config:type=\"short\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"ZoomValue\" config:type=\"int\">100</config:config-item>\r\n"
+           "<config:config-item config:name=\"PageViewZoomValue\" config:type=\"int\">60</config:config-item>\r\n"
+           "<config:config-item config:name=\"ShowPageBreakPreview\" config:type=\"boolean\">false</config:config-item>\r\n"
+           "<config:config-item config:name=\"ShowZeroValues\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"ShowNotes\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"ShowGrid\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"GridColor\" config:type=\"long\">12632256</config:config-item>\r\n"
+           "<config:config-item config:name=\"ShowPageBreaks\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"HasColumnRowHeaders\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"HasSheetTabs\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"IsOutlineSymbolsSet\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"IsSnapToRaster\" config:type=\"boolean\">false</config:config-item>\r\n"
+           "<config:config-item config:name=\"RasterIsVisible\" config:type=\"boolean\">false</config:config-item>\r\n"
+           "<config:config-item config:name=\"RasterResolutionX\" config:type=\"int\">1000</config:config-item>\r\n"
+           "<config:config-item config:name=\"RasterResolutionY\" config:type=\"int\">1000</config:config-item>\r\n"
+           "<config:config-item config:name=\"RasterSubdivisionX\" config:type=\"int\">1</config:config-item>\r\n"
+           "<config:config-item config:name=\"RasterSubdivisionY\" config:type=\"int\">1</config:config-item>\r\n"
+           "<config:config-item config:name=\"IsRasterAxisSynchronized\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "</config:config-item-map-entry>\r\n"
+           "</config:config-item-map-indexed>\r\n"
+           "</config:config-item-set>\r\n"
+           "<config:config-item-set config:name=\"ooo:configuration-settings\">\r\n"
+           "<config:config-item config:name=\"ShowZeroValues\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"ShowNotes\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"ShowGrid\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"GridColor\" config:type=\"long\">12632256</config:config-item>\r\n"
+           "<config:config-item config:name=\"ShowPageBreaks\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"LinkUpdateMode\" config:type=\"short\">3</config:config-item>\r\n"
+           "<config:config-item config:name=\"HasColumnRowHeaders\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"HasSheetTabs\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"IsOutlineSymbolsSet\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"IsSnapToRaster\" config:type=\"boolean\">false</config:config-item>\r\n"
+           "<config:config-item config:name=\"RasterIsVisible\" config:type=\"boolean\">false</config:config-item>\r\n"
+           "<config:config-item config:name=\"RasterResolutionX\" config:type=\"int\">1000</config:config-item>\r\n"
+           "<config:config-item config:name=\"RasterResolutionY\" config:type=\"int\">1000</config:config-item>\r\n"
+           "<config:config-item config:name=\"RasterSubdivisionX\" config:type=\"int\">1</config:config-item>\r\n"
+           "<config:config-item config:name=\"RasterSubdivisionY\" config:type=\"int\">1</config:config-item>\r\n"
+           "<config:config-item config:name=\"IsRasterAxisSynchronized\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"AutoCalculate\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"ApplyUserData\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"CharacterCompressionType\" config:type=\"short\">0</config:config-item>\r\n"
+           "<config:config-item config:name=\"IsKernAsianPunctuation\" config:type=\"boolean\">false</config:config-item>\r\n"
+           "<config:config-item config:name=\"SaveVersionOnClose\" config:type=\"boolean\">false</config:config-item>\r\n"
+           "<config:config-item config:name=\"UpdateFromTemplate\" config:type=\"boolean\">false</config:config-item>\r\n"
+           "<config:config-item config:name=\"AllowPrintJobCancel\" config:type=\"boolean\">true</config:config-item>\r\n"
+           "<config:config-item config:name=\"LoadReadonly\" config:type=\"boolean\">false</config:config-item>\r\n"
+           "</config:config-item-set>\r\n"
+           "</office:settings>\r\n"
+           "</office:document-settings>\r\n";
+    xml.closeEntry();
+}
+
+void OdsWriterImpl::writeStyles(XmlWriter& xml) {
+    xml.openEntry("styles.xml");
+    xml << "<\?xml version=\"1.0\" encoding=\"UTF-8\"\?>\r\n"
+           "<office:document-styles xmlns:office=\"urn:oasis:names:tc:opendocument:xmlns:office:1.0\" xmlns:style=\"urn:oasis:names:tc:opendocument:xmlns:style:1.0\" xmlns:text=\"urn:oasis:names:tc:opendocument:xmlns:text:1.0\" xmlns:table=\"urn:oasis:names:tc:opendocument:xmlns:table:1.0\" xmlns:draw=\"urn:oasis:names:tc:opendocument:xmlns:drawing:1.0\" xmlns:fo=\"urn:oasis:names:tc:opendocument:xmlns:xsl-fo-compatible:1.0\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\" xmlns:meta=\"urn:oasis:names:tc:opendocument:xmlns:meta:1.0\" xmlns:number=\"urn:oasis:names:tc:opendocument:xmlns:datastyle:1.0\" xmlns:svg=\"urn:oasis:names:tc:opendocument:xmlns:svg-compatible:1.0\" xmlns:chart=\"urn:oasis:names:tc:opendocument:xmlns:chart:1.0\" xmlns:dr3d=\"urn:oasis:names:tc:opendocument:xmlns:dr3d:1.0\" xmlns:math=\"http://www.w3.org/1998/Math/MathML\" xmlns:form=\"urn:oasis:names:tc:opendocument:xmlns:form:1.0\" xmlns:script=\"urn:oasis:names:tc:opendocument:xmlns:script:1.0\" xmlns:ooo=\"http://openoffice.org/2004/office\" xmlns:ooow=\"http://openoffice.org/2004/writer\" xmlns:oooc=\"http://openoffice.org/2004/calc\" xmlns:dom=\"http://www.w3.org/2001/xml-events\" office:version=\"1.0\">\r\n"
+           "<office:font-face-decls>\r\n"
+           "<style:font-face style:name=\"Andale Sans UI\" svg:font-family=\"&apos;Andale Sans UI&apos;\" style:font-pitch=\"variable\"/>\r\n"
+           "<style:font-face style:name=\"Tahoma\" svg:font-family=\"Tahoma\" style:font-pitch=\"variable\"/>\r\n"
+           "<style:font-face style:name=\"Albany\" svg:font-family=\"Albany\" style:font-family-generic=\"swiss\" style:font-pitch=\"variable\"/>\r\n"
+           "</office:font-face-decls>\r\n"
+           "<office:styles>\r\n"
+           "<style:default-style style:family=\"table-cell\">\r\n"
+           "<style:table-cell-properties style:decimal-places=\"2\"/>\r\n"
+           "<style:paragraph-properties style:tab-stop-distance=\"1.25cm\"/>\r\n"
+           "<style:text-properties style:font-name=\"Albany\" fo:language=\"en\" fo:country=\"US\" style:font-name-asian=\"Andale Sans UI\" style:language-asian=\"none\" style:country-asian=\"none\" style:font-name-complex=\"Tahoma\" style:language-complex=\"none\" style:country-complex=\"none\"/>\r\n"
+           "</style:default-style>\r\n"
+           "<number:number-style style:name=\"N0\">\r\n"
+           "<number:number number:min-integer-digits=\"1\"/>\r\n"
+           "</number:number-style>\r\n"
+           "<number:currency-style style:name=\"N104P0\" style:volatile=\"true\">\r\n"
+           "<number:number number:decimal-places=\"2\" number:min-integer-digits=\"1\" number:grouping=\"true\"/>\r\n"
+           "</number:currency-style>\r\n"
+           "<number:currency-style style:name=\"N104\">\r\n"
+           "<style:text-properties fo:color=\"#ff0000\"/>\r\n"
+           "<number:text>-</number:text>\r\n"
+           "<number:number number:decimal-places=\"2\" number:min-integer-digits=\"1\" number:grouping=\"true\"/>\r\n"
+           "<style:map style:condition=\"value()&gt;=0\" style:apply-style-name=\"N104P0\"/>\r\n"
+           "</number:currency-style>\r\n"
+           "<style:style style:name=\"Default\" style:family=\"table-cell\"/>\r\n"
+           "<style:style style:name=\"Result\" style:family=\"table-cell\" style:parent-style-name=\"Default\">\r\n"
+           "<style:text-properties fo:font-style=\"italic\" style:text-underline-style=\"solid\" style:text-underline-width=\"auto\" style:text-underline-color=\"font-color\" fo:font-weight=\"bold\"/>\r\n"
+           "</style:style>\r\n"
+           "<style:style style:name=\"Result2\" style:family=\"table-cell\" style:parent-style-name=\"Result\" style:data-style-name=\"N104\"/>\r\n"
+           "<style:style style:name=\"Heading\" style:family=\"table-cell\" style:parent-style-name=\"Default\">\r\n"
+           "<style:table-cell-properties style:text-align-source=\"fix\" style:repeat-content=\"false\"/>\r\n"
+           "<style:paragraph-properties fo:text-align=\"center\"/>\r\n"
+           "<style:text-properties fo:font-size=\"16pt\" fo:font-style=\"italic\" fo:font-weight=\"bold\"/>\r\n"
+           "</style:style>\r\n"
+           "<style:style style:name=\"Heading1\" style:family=\"table-cell\" style:parent-style-name=\"Heading\">\r\n"
+           "<style:table-cell-properties style:rotation-angle=\"90\"/>\r\n"
+           "</style:style>\r\n"
+           "</office:styles>\r\n"
+           "<office:automatic-styles>\r\n"
+           "<style:page-layout style:name=\"pm1\">\r\n"
+           "<style:page-layout-properties style:writing-mode=\"lr-tb\"/>\r\n"
+           "<style:header-style>\r\n"
+           "<style:header-footer-properties fo:min-height=\"0.751cm\" fo:margin-left=\"0cm\" fo:margin-right=\"0cm\" fo:margin-bottom=\"0.25cm\"/>\r\n"
+           "</style:header-style>\r\n"
+           "<style:footer-style>\r\n"
+           "<style:header-footer-properties fo:min-height=\"0.751cm\" fo:margin-left=\"0cm\" fo:margin-right=\"0cm\" fo:margin-top=\"0.25cm\"/>\r\n"
+           "</style:footer-style>\r\n"
+           "</style:page-layout>\r\n"
+           "<style:page-layout style:name=\"pm2\">\r\n"
+           "<style:page-layout-properties style:writing-mode=\"lr-tb\"/>\r\n"
+           "<style:header-style>\r\n"
+           "<style:header-footer-properties fo:min-height=\"0.751cm\" fo:margin-left=\"0cm\" fo:margin-right=\"0cm\" fo:margin-bottom=\"0.25cm\" fo:border=\"0.088cm solid #000000\" fo:padding=\"0.018cm\" fo:background-color=\"#c0c0c0\">\r\n"
+           "<style:background-image/>\r\n"
+           "</style:header-footer-properties>\r\n"
+           "</style:header-style>\r\n"
+           "<style:footer-style>\r\n"
+           "<style:header-footer-properties fo:min-height=\"0.751cm\" fo:margin-left=\"0cm\" fo:margin-right=\"0cm\" fo:margin-top=\"0.25cm\" fo:border=\"0.088cm solid #000000\" fo:padding=\"0.018cm\" fo:background-color=\"#c0c0c0\">\r\n"
+           "<style:background-image/>\r\n"
+           "</style:header-footer-properties>\r\n"
+           "</style:footer-style>\r\n"
+           "</style:page-layout>\r\n"
+           "</office:automatic-styles>\r\n"
+           "<office:master-styles>\r\n"
+           "<style:master-page style:name=\"Default\" style:page-layout-name=\"pm1\">\r\n"
+           "<style:header>\r\n"
+           "<text:p>\r\n"
+           "<text:sheet-name>\?\?\?</text:sheet-name>\r\n"
+           "</text:p>\r\n"
+           "</style:header>\r\n"
+           "<style:header-left style:display=\"false\"/>\r\n"
+           "<style:footer>\r\n"
+           "<text:p>Page <text:page-number>1</text:page-number>\r\n"
+           "</text:p>\r\n"
+           "</style:footer>\r\n"
+           "<style:footer-left style:display=\"false\"/>\r\n"
+           "</style:master-page>\r\n"
+           "<style:master-page style:name=\"Report\" style:page-layout-name=\"pm2\">\r\n"
+           "<style:header>\r\n"
+           "<style:region-left>\r\n"
+           "<text:p>\r\n"
+           "<text:sheet-name>\?\?\?</text:sheet-name> (<text:title>\?\?\?</text:title>)</text:p>\r\n"
+           "</style:region-left>\r\n"
+           "<style:region-right>\r\n"
+           "<text:p>\r\n"
+           "</text:p>\r\n"
+           "</style:region-right>\r\n"
+           "</style:header>\r\n"
+           "<style:header-left style:display=\"false\"/>\r\n"
+           "<style:footer>\r\n"
+           "<text:p>Page <text:page-number>1</text:page-number> / <text:page-count>99</text:page-count>\r\n"
+           "</text:p>\r\n"
+           "</style:footer>\r\n"
+           "<style:footer-left style:display=\"false\"/>\r\n"
+           "</style:master-page>\r\n"
+           "</office:master-styles>\r\n"
+           "</office:document-styles>\r\n";
+    xml.closeEntry();
 }
 
 void OdsWriterImpl::writeTable(Table& table, int& nextColumnStyle,
-                               int& nextRowStyle, ZipArchive& ar) {
-    ToUTF8 tableNameUtf8(Strings::xmlize(table.getName()).c_str());
-    ar << "<table:table table:name=\"" << tableNameUtf8.get() << "\" table:style-name=\"ta1\" table:print=\"false\">\r\n";
+                               int& nextRowStyle, XmlWriter& xml) {
+    writeTableStart(table.getName(), xml);
     // columns
-    writeColumns(table, nextColumnStyle, ar);
+    writeColumns(table, nextColumnStyle, xml);
     // rows and cells
-    int lastRowIndex = -1;
-    Rows::Iterator* rowIt = table.rows().iterator();
-    while (rowIt->hasNext()) {
-        Rows::Entry entry = rowIt->next();
-        int rowIndex = entry.index();
-        Row& row = entry.object();
-        Cells& cells = row.cells();
-        double height = row.getHeight();
-        if (cells.size() == 0 && height < 0) {
-            continue;
-        }
-        writeEmptyRows(rowIndex - lastRowIndex - 1, ar);
-        lastRowIndex = rowIndex;
-        int style = 1;
-        if (height >= 0) {
-            style = nextRowStyle++;
-        }
-        ar << "<table:table-row table:style-name=\"ro" << style << "\">\r\n";
-        int lastCellIndex = -1;
-        Cells::Iterator* cellIt = cells.iterator();
-        while (cellIt->hasNext()) {
-            Cells::Entry entry = cellIt->next();
-            int cellIndex = entry.index();
-            Cell& cell = entry.object();
-            if (cell.getType() == Cell::NONE) {
-                continue;
-            }
-            writeEmptyCells(cellIndex - lastCellIndex - 1, ar);
-            lastCellIndex = cellIndex;
-            writeCell(cell, ar);
-        }
-        delete cellIt;
-        ar << "</table:table-row>\r\n";
-    }
-    delete rowIt;
-    ar << "</table:table>\r\n";
+    TableWalker walker(table);
+    RowWriter writer(walker, nextRowStyle, xml);
+    walker.forEachRow(writer);
+    writeTableEnd(xml);
+}
+
+void OdsWriterImpl::writeTableStart(const _TCHAR* name, XmlWriter& xml) {
+    xml << "<table:table table:name=\"";
+    xml.writeText(name);
+    xml << "\" table:style-name=\"ta1\" table:print=\"false\">\r\n";
+}
+
+void OdsWriterImpl::writeTableEnd(XmlWriter& xml) {
+    xml << "</table:table>\r\n";
 }
 
 void OdsWriterImpl::writeRowStyles(Spreadsheet& sp, int& nextRowStyle,
-                                   ZipArchive& ar) {
-    ar << "<style:style style:name=\"ro1\" style:family=\"table-row\">\r\n"
-          "<style:table-row-properties style:row-height=\"0.453cm\" fo:break-before=\"auto\" style:use-optimal-row-height=\"true\"/>\r\n"
-          "</style:style>\r\n";
+                                   XmlWriter& xml) {
+    writeRowStyle(1, -1, xml);
     int k = 2;
     for (int i = 0; i < sp.tableCount(); i++) {
         Table& table = sp.table(i);
@@ -332,9 +391,7 @@ void OdsWriterImpl::writeRowStyles(Spreadsheet& sp, int& nextRowStyle,
         while (j->hasNext()) {
             double height = j->next().object().getHeight();
             if (height >= 0) {
-                ar << "<style:style style:name=\"ro" << k++ << "\" style:family=\"table-row\">\r\n"
-                      "<style:table-row-properties style:row-height=\"" << height << "pt\" fo:break-before=\"auto\" style:use-optimal-row-height=\"false\"/>\r\n"
-                      "</style:style>\r\n";
+                writeRowStyle(k++, height, xml);
             }
         }
         delete j;
@@ -343,10 +400,8 @@ void OdsWriterImpl::writeRowStyles(Spreadsheet& sp, int& nextRowStyle,
 }
 
 void OdsWriterImpl::writeColumnStyles(Spreadsheet& sp, int& nextColumnStyle,
-                                      ZipArchive& ar) {
-    ar << "<style:style style:name=\"co1\" style:family=\"table-column\">\r\n"
-          "<style:table-column-properties fo:break-before=\"auto\" style:column-width=\"2.267cm\"/>\r\n"
-          "</style:style>\r\n";
+                                      XmlWriter& xml) {
+    writeColumnStyle(1, -1, xml);
     int k = 2;
     for (int i = 0; i < sp.tableCount(); i++) {
         Table& table = sp.table(i);
@@ -354,9 +409,7 @@ void OdsWriterImpl::writeColumnStyles(Spreadsheet& sp, int& nextColumnStyle,
         while (j->hasNext()) {
             double width = j->next().object().getWidth();
             if (width >= 0) {
-                ar << "<style:style style:name=\"co" << k++ << "\" style:family=\"table-column\">\r\n"
-                      "<style:table-column-properties fo:break-before=\"auto\" style:column-width=\"" << width << "pt\"/>\r\n"
-                      "</style:style>\r\n";
+                writeColumnStyle(k++, width, xml);
             }
         }
         delete j;
@@ -364,8 +417,29 @@ void OdsWriterImpl::writeColumnStyles(Spreadsheet& sp, int& nextColumnStyle,
     nextColumnStyle = 2;
 }
 
+void OdsWriterImpl::writeRowStyle(int style, double height, XmlWriter& xml) {
+    xml << "<style:style style:name=\"ro" << style << "\" style:family=\"table-row\">\r\n";
+    if (height < 0) {
+        xml << "<style:table-row-properties style:row-height=\"0.453cm\" fo:break-before=\"auto\" style:use-optimal-row-height=\"true\"/>\r\n";
+    } else {
+        xml << "<style:table-row-properties style:row-height=\"" << height << "pt\" fo:break-before=\"auto\" style:use-optimal-row-height=\"false\"/>\r\n";
+    }
+    xml << "</style:style>\r\n";
+}
+
+void OdsWriterImpl::writeColumnStyle(int style, double width,
+                                     XmlWriter& xml) {
+    xml << "<style:style style:name=\"co" << style << "\" style:family=\"table-column\">\r\n";
+    if (width < 0) {
+        xml << "<style:table-column-properties fo:break-before=\"auto\" style:column-width=\"2.267cm\"/>\r\n";
+    } else {
+        xml << "<style:table-column-properties fo:break-before=\"auto\" style:column-width=\"" << width << "pt\"/>\r\n";
+    }
+    xml << "</style:style>\r\n";
+}
+
 void OdsWriterImpl::writeColumns(Table& table, int& nextColumnStyle,
-                                 ZipArchive& ar) {
+                                 XmlWriter& xml) {
     int lastIndex = -1;
     Columns::Iterator* i = table.columns().iterator();
     while (i->hasNext()) {
@@ -373,61 +447,81 @@ void OdsWriterImpl::writeColumns(Table& table, int& nextColumnStyle,
         int index = entry.index();
         double width = entry.object().getWidth();
         if (width >= 0) {
-            writeEmptyColumns(index - lastIndex - 1, ar);
+            writeEmptyColumns(index - lastIndex - 1, xml);
             lastIndex = index;
-            ar << "<table:table-column table:style-name=\"co" << nextColumnStyle++ << "\" table:default-cell-style-name=\"Default\"/>\r\n";
+            writeColumn(nextColumnStyle++, xml);
         }
     }
     delete i;
 }
 
-void OdsWriterImpl::writeEmptyColumns(int columns, ZipArchive& ar) {
+void OdsWriterImpl::writeColumn(int style, XmlWriter& xml) {
+    xml << "<table:table-column table:style-name=\"co" << style << "\" table:default-cell-style-name=\"Default\"/>\r\n";
+}
+
+void OdsWriterImpl::writeEmptyColumns(int columns, XmlWriter& xml) {
     if (columns == 1) {
-        ar << "<table:table-column table:style-name=\"co1\" table:default-cell-style-name=\"Default\"/>\r\n";
+        xml << "<table:table-column table:style-name=\"co1\" table:default-cell-style-name=\"Default\"/>\r\n";
     } else if (columns > 1) {
-        ar << "<table:table-column table:style-name=\"co1\" table:number-columns-repeated=\"" << columns << "\" table:default-cell-style-name=\"Default\"/>\r\n";
+        xml << "<table:table-column table:style-name=\"co1\" table:number-columns-repeated=\"" << columns << "\" table:default-cell-style-name=\"Default\"/>\r\n";
     }
 }
 
-void OdsWriterImpl::writeEmptyRows(int rows, ZipArchive& ar) {
+void OdsWriterImpl::writeEmptyRows(int rows, XmlWriter& xml) {
     if (rows == 1) {
-        ar << "<table:table-row table:style-name=\"ro1\"/>\r\n";
+        xml << "<table:table-row table:style-name=\"ro1\"/>\r\n";
     } else if (rows > 1) {
-        ar << "<table:table-row table:style-name=\"ro1\" table:number-rows-repeated=\"" << rows << "\"/>\r\n";
+        xml << "<table:table-row table:style-name=\"ro1\" table:number-rows-repeated=\"" << rows << "\"/>\r\n";
     }
 }
 
-void OdsWriterImpl::writeCell(Cell& cell, ZipArchive& ar) {
-    ar << "<table:table-cell ";
-    int style = cellStyleIndex(cell);
+void OdsWriterImpl::writeRowStart(int style, XmlWriter& xml) {
+    xml << "<table:table-row table:style-name=\"ro" << style << "\">\r\n";
+}
+
+void OdsWriterImpl::writeRowEnd(XmlWriter& xml) {
+    xml << "</table:table-row>\r\n";
+}
+
+void OdsWriterImpl::writeCell(Cell& cell, XmlWriter& xml) {
+    int style = cellStyleIndex(cell.getType(), cell.getHAlignment(),
+                               cell.getVAlignment());
+    writeValue(CellValue::of(cell), style, xml);
+}
+
+void OdsWriterImpl::writeValue(const CellValue& value, int style,
+                               XmlWriter& xml) {
+    Cell::Type type = value.getType();
+    xml << "<table:table-cell ";
     if (style != 0) {
-        ar << "table:style-name=\"ce" << style << "\" ";
+        xml << "table:style-name=\"ce" << style << "\" ";
     }
-    if (cell.getType() == Cell::TEXT) {
-        ToUTF8 textUtf8(Strings::xmlize(cell.getText()).c_str());
-        ar << "office:value-type=\"string\">\r\n"
-              "<text:p>" << textUtf8.get() << "</text:p>\r\n";
-    } else if (cell.getType() == Cell::LONG) {
-        ar << "office:value-type=\"float\" office:value=\"" << cell.getLong() << "\">\r\n"
-              "<text:p>" << cell.getLong() << "</text:p>\r\n";
-    } else if (cell.getType() == Cell::DOUBLE) {
-        ar << "office:value-type=\"float\" office:value=\"" << cell.getDouble() << "\">\r\n"
-              "<text:p>" << cell.getDouble() << "</text:p>\r\n";
-    } else if (cell.getType() == Cell::DATE) {
-        ar << "office:value-type=\"date\" office:date-value=\"" << date(cell.getDate()).c_str() << "\">\r\n";
-    } else if (cell.getType() == Cell::TIME) {
-        ar << "office:value-type=\"time\" office:time-value=\"" << time(cell.getTime()).c_str() << "\">\r\n";
-    } else if (cell.getType() == Cell::FORMULA) {
-        ar << "table:formula=\"" << formula(cell.getFormula()).c_str() << "\" office:value-type=\"float\">";
+    if (type == Cell::TEXT) {
+        xml << "office:value-type=\"string\">\r\n"
+               "<text:p>";
+        xml.writeText(value.getText());
+        xml << "</text:p>\r\n";
+    } else if (type == Cell::LONG) {
+        xml << "office:value-type=\"float\" office:value=\"" << value.getLong() << "\">\r\n"
+               "<text:p>" << value.getLong() << "</text:p>\r\n";
+    } else if (type == Cell::DOUBLE) {
+        xml << "office:value-type=\"float\" office:value=\"" << value.getDouble() << "\">\r\n"
+               "<text:p>" << value.getDouble() << "</text:p>\r\n";
+    } else if (type == Cell::DATE) {
+        xml << "office:value-type=\"date\" office:date-value=\"" << date(value.getDate()).c_str() << "\">\r\n";
+    } else if (type == Cell::TIME) {
+        xml << "office:value-type=\"time\" office:time-value=\"" << time(value.getTime()).c_str() << "\">\r\n";
+    } else if (type == Cell::FORMULA) {
+        xml << "table:formula=\"" << formula(value.getFormula()).c_str() << "\" office:value-type=\"float\">";
     }
-    ar << "</table:table-cell>\r\n";
+    xml << "</table:table-cell>\r\n";
 }
 
-void OdsWriterImpl::writeEmptyCells(int cells, ZipArchive& ar) {
+void OdsWriterImpl::writeEmptyCells(int cells, XmlWriter& xml) {
     if (cells == 1) {
-        ar << "<table:table-cell/>\r\n";
+        xml << "<table:table-cell/>\r\n";
     } else if (cells > 1) {
-        ar << "<table:table-cell table:number-columns-repeated=\"" << cells << "\"/>\r\n";
+        xml << "<table:table-cell table:number-columns-repeated=\"" << cells << "\"/>\r\n";
     }
 }
 
@@ -465,23 +559,23 @@ std::basic_string<char> OdsWriterImpl::formula(const _TCHAR* formula) {
     return res;
 }
 
-void OdsWriterImpl::writeCellStyles(ZipArchive& ar) {
-    ar << "<number:date-style style:name=\"N37\" number:automatic-order=\"true\">\r\n"
-          "<number:month number:style=\"long\"/>\r\n"
-          "<number:text>/</number:text>\r\n"
-          "<number:day number:style=\"long\"/>\r\n"
-          "<number:text>/</number:text>\r\n"
-          "<number:year/>\r\n"
-          "</number:date-style>\r\n"
-          "<number:time-style style:name=\"N43\">\r\n"
-          "<number:hours number:style=\"long\"/>\r\n"
-          "<number:text>:</number:text>\r\n"
-          "<number:minutes number:style=\"long\"/>\r\n"
-          "<number:text>:</number:text>\r\n"
-          "<number:seconds number:style=\"long\"/>\r\n"
-          "<number:text> </number:text>\r\n"
-          "<number:am-pm/>\r\n"
-          "</number:time-style>\r\n";
+void OdsWriterImpl::writeCellStyles(XmlWriter& xml) {
+    xml << "<number:date-style style:name=\"N37\" number:automatic-order=\"true\">\r\n"
+           "<number:month number:style=\"long\"/>\r\n"
+           "<number:text>/</number:text>\r\n"
+           "<number:day number:style=\"long\"/>\r\n"
+           "<number:text>/</number:text>\r\n"
+           "<number:year/>\r\n"
+           "</number:date-style>\r\n"
+           "<number:time-style style:name=\"N43\">\r\n"
+           "<number:hours number:style=\"long\"/>\r\n"
+           "<number:text>:</number:text>\r\n"
+           "<number:minutes number:style=\"long\"/>\r\n"
+           "<number:text>:</number:text>\r\n"
+           "<number:seconds number:style=\"long\"/>\r\n"
+           "<number:text> </number:text>\r\n"
+           "<number:am-pm/>\r\n"
+           "</number:time-style>\r\n";
     Cell::HAlignment hAligns[] = {Cell::HADEFAULT, Cell::LEFT, Cell::CENTER,
         Cell::RIGHT, Cell::JUSTIFIED, Cell::FILLED};
     Cell::VAlignment vAligns[] = {Cell::VADEFAULT, Cell::TOP, Cell::MIDDLE,
@@ -498,16 +592,16 @@ void OdsWriterImpl::writeCellStyles(ZipArchive& ar) {
                     case 1: dataStyle = " style:data-style-name=\"N37\""; break;
                     case 2: dataStyle = " style:data-style-name=\"N43\""; break;
                 }
-                ar << "<style:style style:name=\"ce" << style << "\" style:family=\"table-cell\" style:parent-style-name=\"Default\""
-                   << dataStyle << ">\r\n";
+                xml << "<style:style style:name=\"ce" << style << "\" style:family=\"table-cell\" style:parent-style-name=\"Default\""
+                    << dataStyle << ">\r\n";
 
                 Cell::HAlignment hAlign = hAligns[j];
                 Cell::VAlignment vAlign = vAligns[k];
 
-                ar << "<style:table-cell-properties";
+                xml << "<style:table-cell-properties";
                 if (hAlign != Cell::HADEFAULT) {
-                    ar << " style:text-align-source=\"fix\" style:repeat-content=\""
-                       << (hAlign == Cell::FILLED ? "true" : "false") << "\"";
+                    xml << " style:text-align-source=\"fix\" style:repeat-content=\""
+                        << (hAlign == Cell::FILLED ? "true" : "false") << "\"";
                 }
                 if (vAlign != Cell::VADEFAULT) {
                     const char* sAlign = "bottom";
@@ -516,9 +610,9 @@ void OdsWriterImpl::writeCellStyles(ZipArchive& ar) {
                         case Cell::MIDDLE: sAlign = "middle"; break;
                         case Cell::BOTTOM: sAlign = "bottom"; break;
                     }
-                    ar << " style:vertical-align=\"" << sAlign << "\"";
+                    xml << " style:vertical-align=\"" << sAlign << "\"";
                 }
-                ar << "/>\r\n";
+                xml << "/>\r\n";
 
                 if (hAlign != Cell::HADEFAULT) {
                     const char* sAlign = "end";
@@ -529,23 +623,25 @@ void OdsWriterImpl::writeCellStyles(ZipArchive& ar) {
                         case Cell::JUSTIFIED: sAlign  = "justify"; break;
                         case Cell::FILLED:    sAlign  = "start";   break;
                     }
-                    ar << "<style:paragraph-properties fo:text-align=\"" << sAlign << "\"/>\r\n";
+                    xml << "<style:paragraph-properties fo:text-align=\"" << sAlign << "\"/>\r\n";
                 }
 
-                ar << "</style:style>\r\n";
+                xml << "</style:style>\r\n";
             }
         }
     }
 }
 
-int OdsWriterImpl::cellStyleIndex(Cell& cell) {
+int OdsWriterImpl::cellStyleIndex(Cell::Type type,
+                                  Cell::HAlignment hAlignment,
+                                  Cell::VAlignment vAlignment) {
     int i = 0;
-    switch (cell.getType()) {
+    switch (type) {
         case Cell::DATE:        i = 1; break;
         case Cell::TIME:        i = 2; break;
     }
     int j = 0;
-    switch (cell.getHAlignment()) {
+    switch (hAlignment) {
         case Cell::LEFT:        j = 1; break;
         case Cell::CENTER:      j = 2; break;
         case Cell::RIGHT:       j = 3; break;
@@ -553,7 +649,7 @@ int OdsWriterImpl::cellStyleIndex(Cell& cell) {
         case Cell::FILLED:      j = 5; break;
     }
     int k = 0;
-    switch (cell.getVAlignment()) {
+    switch (vAlignment) {
         case Cell::TOP:         k = 1; break;
         case Cell::MIDDLE:      k = 2; break;
         case Cell::BOTTOM:      k = 3; break;
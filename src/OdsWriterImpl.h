@@ -17,63 +17,139 @@ class OdsWriterImpl {
 
     public:
         /** Writes a spreadsheet to a file in ods format. */
-        static void write(Spreadsheet& spreadsheet, const _TCHAR* pathname);
+        static void write(Spreadsheet& spreadsheet, const _TCHAR* pathname,
+                          const CompressionOptions& compression);
+
+        /** Writes a spreadsheet to a sink in ods format. */
+        static void write(Spreadsheet& spreadsheet, OutputSink& sink,
+                          const CompressionOptions& compression);
 
-    private:
         /** Writes the META-INF/manifest.xml entry of the ods package. */
-        static void writeManifest(class ZipArchive& ar);
+        static void writeManifest(class XmlWriter& xml);
 
-        /** Writes the content.xml entry of the ods package. */
-        static void writeContent(Spreadsheet& spreadsheet, ZipArchive& ar);
+        /**
+         * Opens the content.xml entry of the ods package and writes its
+         * start, up to and including the start tag of the automatic
+         * styles.
+         */
+        static void writeContentStart(XmlWriter& xml);
 
-        /** Writes the meta.xml entry of the ods package. */
-        static void writeMeta(ZipArchive& ar);
+        /**
+         * Writes the automatic styles shared by all tables, closes the
+         * automatic styles, and starts the body of the content.xml entry.
+         */
+        static void writeBodyStart(XmlWriter& xml);
 
-        /** Writes the mimetype entry of the ods package. */
-        static void writeMimetype(ZipArchive& ar);
+        /** Finishes and closes the content.xml entry of the ods package. */
+        static void writeContentEnd(XmlWriter& xml);
 
-        /** Writes the settings.xml entry of the ods package. */
-        static void writeSettings(ZipArchive& ar);
+        /**
+         * Writes the meta.xml, mimetype, settings.xml, and styles.xml
+         * entries of the ods package, which do not depend on the content.
+         */
+        static void writeFixedParts(XmlWriter& xml);
 
-        /** Writes the styles.xml entry of the ods package. */
-        static void writeStyles(ZipArchive& ar);
+        /**
+         * Writes a column style into the current zip entry.
+         * @param style the number of the style
+         * @param width the width of the column, or a negative value for
+         *        the default width
+         */
+        static void writeColumnStyle(int style, double width, XmlWriter& xml);
 
-        /** Writes a table into the current zip entry. */
-        static void writeTable(Table& table, int& nextColumnStyle,
-            int& nextRowStyle, ZipArchive& ar);
+        /**
+         * Writes a row style into the current zip entry.
+         * @param style the number of the style
+         * @param height the height of the row, or a negative value for
+         *        the default height
+         */
+        static void writeRowStyle(int style, double height, XmlWriter& xml);
 
-        /** Writes all required row styles into the current zip entry. */
-        static void writeRowStyles(Spreadsheet& sp, int& nextRowStyle,
-            ZipArchive& ar);
+        /** Writes the start tag of a table into the current zip entry. */
+        static void writeTableStart(const _TCHAR* name, XmlWriter& xml);
 
-        /** Writes all required column styles into the current zip entry. */
-        static void writeColumnStyles(Spreadsheet& sp, int& nextColumnStyle,
-            ZipArchive& ar);
+        /** Writes the end tag of a table into the current zip entry. */
+        static void writeTableEnd(XmlWriter& xml);
 
-        /** Writes table columns into the current zip entry. */
-        static void writeColumns(Table& table, int& nextColumnStyle,
-            ZipArchive& ar);
+        /** Writes a column with a style into the current zip entry. */
+        static void writeColumn(int style, XmlWriter& xml);
 
         /**
          * Writes the specified number of empty columns into the current
          * zip entry.
          */
-        static void writeEmptyColumns(int columns, ZipArchive& ar);
+        static void writeEmptyColumns(int columns, XmlWriter& xml);
 
         /**
          * Writes the specified number of empty rows into the current
          * zip entry.
          */
-        static void writeEmptyRows(int rows, ZipArchive& ar);
+        static void writeEmptyRows(int rows, XmlWriter& xml);
 
-        /** Writes a non-empty cell into the current zip entry. */
-        static void writeCell(Cell& cell, ZipArchive& ar);
+        /** Writes the start tag of a row with a style. */
+        static void writeRowStart(int style, XmlWriter& xml);
+
+        /** Writes the end tag of a row. */
+        static void writeRowEnd(XmlWriter& xml);
+
+        /**
+         * Writes a value as a cell into the current zip entry. The value
+         * must not be of type <code>Cell::NONE</code>.
+         * @param value the value
+         * @param style the index of the cell style, as returned by
+         *        <code>cellStyleIndex()</code>
+         */
+        static void writeValue(const CellValue& value, int style,
+                               XmlWriter& xml);
 
         /**
          * Writes the specified number of empty cells into the current
          * zip entry.
          */
-        static void writeEmptyCells(int cells, ZipArchive& ar);
+        static void writeEmptyCells(int cells, XmlWriter& xml);
+
+        /** Determines the style index for a cell. */
+        static int cellStyleIndex(Cell::Type type, Cell::HAlignment hAlignment,
+                                  Cell::VAlignment vAlignment);
+
+    private:
+        /** Writes all entries of the ods package and closes it. */
+        static void writePackage(Spreadsheet& spreadsheet,
+                                 class ZipArchive& ar);
+
+        /** Writes the content.xml entry of the ods package. */
+        static void writeContent(Spreadsheet& spreadsheet, XmlWriter& xml);
+
+        /** Writes the meta.xml entry of the ods package. */
+        static void writeMeta(XmlWriter& xml);
+
+        /** Writes the mimetype entry of the ods package. */
+        static void writeMimetype(XmlWriter& xml);
+
+        /** Writes the settings.xml entry of the ods package. */
+        static void writeSettings(XmlWriter& xml);
+
+        /** Writes the styles.xml entry of the ods package. */
+        static void writeStyles(XmlWriter& xml);
+
+        /** Writes a table into the current zip entry. */
+        static void writeTable(Table& table, int& nextColumnStyle,
+            int& nextRowStyle, XmlWriter& xml);
+
+        /** Writes all required row styles into the current zip entry. */
+        static void writeRowStyles(Spreadsheet& sp, int& nextRowStyle,
+            XmlWriter& xml);
+
+        /** Writes all required column styles into the current zip entry. */
+        static void writeColumnStyles(Spreadsheet& sp, int& nextColumnStyle,
+            XmlWriter& xml);
+
+        /** Writes table columns into the current zip entry. */
+        static void writeColumns(Table& table, int& nextColumnStyle,
+            XmlWriter& xml);
+
+        /** Writes a non-empty cell into the current zip entry. */
+        static void writeCell(Cell& cell, XmlWriter& xml);
 
         /** Converts a Date object to a string in OpenDocument format. */
         static std::basic_string<char> date(const Date& date);
@@ -85,10 +161,10 @@ class OdsWriterImpl {
         static std::basic_string<char> formula(const _TCHAR* formula);
 
         /** Writes cell styles into the current zip entry. */
-        static void writeCellStyles(ZipArchive& ar);
+        static void writeCellStyles(XmlWriter& xml);
 
-        /** Determines the style index for a cell. */
-        static int cellStyleIndex(Cell& cell);
+        /** Visitor that writes the rows of a table. */
+        class RowWriter;
 };
 
 }
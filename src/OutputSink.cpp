@@ -0,0 +1,21 @@
+// File: OutputSink.cpp
+// OutputSink implementation file
+//
+
+#include "splib.h"
+#include "splibint.h"
+
+namespace splib {
+
+bool OutputSink::isSeekable() const {
+    return false;
+}
+
+void OutputSink::seek(unsigned long) {
+    throw IllegalStateException();
+}
+
+void OutputSink::flush() {
+}
+
+}
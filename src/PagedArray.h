@@ -0,0 +1,102 @@
+// File: PagedArray.h
+// PagedArray declaration file
+//
+
+#ifndef PAGEDARRAY_H
+#define PAGEDARRAY_H
+
+#include <vector>
+
+namespace splib {
+
+/**
+ * A growable array of plain values split into pages of
+ * <code>PAGE_SIZE</code> elements. A page is allocated, zero-filled, when
+ * one of its elements is first written, so a sparse array only pays for
+ * the pages it uses plus one pointer per page. Pages are never released
+ * before the array is destroyed.
+ */
+template<class T>
+class PagedArray {
+    public:
+        /** Number of bits of an index that select an element of a page */
+        enum {PAGE_BITS = 6};
+
+        /** Number of elements of a page */
+        enum {PAGE_SIZE = 1 << PAGE_BITS};
+
+    public:
+        /** Creates a new, empty instance of <code>PagedArray</code>. */
+        PagedArray() {}
+
+        /** Destructor */
+        ~PagedArray() {
+            for (typename Pages::size_type i = 0; i < pages.size(); i++) {
+                delete[] pages[i];
+            }
+        }
+
+        /**
+         * Provides access to an element, allocating its page if necessary.
+         * @param index the index of the element
+         */
+        T& at(int index) {
+            int page = index >> PAGE_BITS;
+            if (page >= (int)pages.size()) {
+                pages.resize(page + 1, 0);
+            }
+            if (pages[page] == 0) {
+                pages[page] = new T[PAGE_SIZE]();
+            }
+            return pages[page][index & (PAGE_SIZE - 1)];
+        }
+
+        /**
+         * Retrieves an element without allocating anything. Elements of
+         * pages that have not been allocated are zero.
+         * @param index the index of the element
+         */
+        T get(int index) const {
+            int page = index >> PAGE_BITS;
+            if (page >= (int)pages.size() || pages[page] == 0) {
+                return T();
+            }
+            return pages[page][index & (PAGE_SIZE - 1)];
+        }
+
+        /**
+         * Provides access to an element whose page has been allocated
+         * by <code>at()</code>.
+         * @param index the index of the element
+         */
+        T& operator [] (int index) {
+            return pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)];
+        }
+
+        /**
+         * Provides read-only access to an element whose page has been
+         * allocated by <code>at()</code>.
+         * @param index the index of the element
+         */
+        const T& operator [] (int index) const {
+            return pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)];
+        }
+
+    private:
+        /** The type of the page table */
+        typedef std::vector<T*> Pages;
+
+        /** Not implemented; arrays are not copied */
+        PagedArray(const PagedArray&);
+
+        /** Not implemented; arrays are not copied */
+        PagedArray& operator = (const PagedArray&);
+
+    private:
+        /** The pages, indexed by element index / PAGE_SIZE */
+        Pages pages;
+};
+
+}
+
+#endif // PAGEDARRAY_H
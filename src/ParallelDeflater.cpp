@@ -0,0 +1,173 @@
+// File: ParallelDeflater.cpp
+// ParallelDeflater implementation file
+//
+
+#include "ParallelDeflater.h"
+#include "AtomicCounter.h"
+#include "Thread.h"
+#include "splib.h"
+#include <string.h>
+#include "splibint.h"
+
+namespace splib {
+
+class ParallelDeflater::Compressor : public Thread::Runnable {
+    public:
+        Compressor(std::vector<Block>& blocks, int level)
+            : blocks(blocks), level(level) {
+        }
+
+        virtual void run() {
+            z_stream zs;
+            ::memset(&zs, 0, sizeof(zs));
+            bool ready = deflateInit2(&zs, level, Z_DEFLATED,
+                                      -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+            int count = (int)blocks.size();
+            for (int i = (int)next.next(); i < count; i = (int)next.next()) {
+                if (ready && deflateReset(&zs) == Z_OK) {
+                    compressBlock(blocks[i], zs);
+                } else {
+                    blocks[i].failed = true;
+                }
+            }
+            if (ready) {
+                deflateEnd(&zs);
+            }
+        }
+
+    private:
+        /** The blocks to compress */
+        std::vector<Block>& blocks;
+
+        /** The compression level */
+        int level;
+
+        /** The index of the next block to compress */
+        AtomicCounter next;
+};
+
+ParallelDeflater::ParallelDeflater(int threads, int level)
+        : threads(threads > 1 ? threads : 1), level(level),
+          batch(DICTIONARY_SIZE + (threads > 1 ? threads : 1) * BLOCK_SIZE),
+          dictionary(0), used(0), dataCrc(crc32(0, Z_NULL, 0)), dataSize(0) {
+}
+
+ParallelDeflater::~ParallelDeflater() {
+}
+
+void ParallelDeflater::write(const void* buffer, unsigned length) {
+    const Bytef* p = (const Bytef*)buffer;
+    while (length > 0) {
+        // the last batch is compressed by finish(), to end the stream
+        if (used == batch.size()) {
+            compressBatch(false);
+        }
+        unsigned n = (unsigned)batch.size() - used;
+        if (n > length) {
+            n = length;
+        }
+        ::memcpy(&batch[used], p, n);
+        used += n;
+        p += n;
+        length -= n;
+    }
+}
+
+void ParallelDeflater::finish() {
+    compressBatch(true);
+}
+
+std::basic_string<char>& ParallelDeflater::output() {
+    return compressed;
+}
+
+unsigned long ParallelDeflater::crc() const {
+    return dataCrc;
+}
+
+unsigned long ParallelDeflater::size() const {
+    return dataSize;
+}
+
+void ParallelDeflater::compressBatch(bool last) {
+    unsigned length = used - dictionary;
+    int count = (int)((length + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    if (count == 0) {
+        if (last) {
+            // an empty final block with fixed codes
+            compressed.append("\x03\x00", 2);
+        }
+        return;
+    }
+    blocks.resize(count);
+    for (int i = 0; i < count; i++) {
+        Block& block = blocks[i];
+        unsigned start = dictionary + i * BLOCK_SIZE;
+        block.data = &batch[start];
+        block.length = used - start < BLOCK_SIZE ? used - start : BLOCK_SIZE;
+        block.dictionary = start < DICTIONARY_SIZE ? start : DICTIONARY_SIZE;
+        block.last = last && i == count - 1;
+        block.compressed.clear();
+        block.failed = false;
+    }
+    Compressor compressor(blocks, level);
+    int n = threads < count ? threads : count;
+    std::vector<Thread*> workers;
+    workers.reserve(n - 1);
+    try {
+        for (int i = 1; i < n; i++) {
+            workers.push_back(new Thread(compressor));
+        }
+    } catch (...) {
+        // go on with the threads started
+    }
+    compressor.run();
+    for (int i = 0; i < (int)workers.size(); i++) {
+        delete workers[i];
+    }
+    for (int i = 0; i < count; i++) {
+        if (blocks[i].failed) {
+            throw IOException(_T("error compressing zip entry"));
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        Block& block = blocks[i];
+        compressed.append(block.compressed);
+        dataCrc = crc32_combine(dataCrc, block.crc, block.length);
+        dataSize += block.length;
+    }
+    // the end of the batch is the dictionary of the next one
+    unsigned keep = used < DICTIONARY_SIZE ? used : DICTIONARY_SIZE;
+    ::memmove(&batch[0], &batch[used - keep], keep);
+    dictionary = keep;
+    used = keep;
+}
+
+void ParallelDeflater::compressBlock(Block& block, z_stream& zs) {
+    try {
+        if (block.dictionary > 0 &&
+            deflateSetDictionary(&zs, block.data - block.dictionary,
+                                 block.dictionary) != Z_OK) {
+            block.failed = true;
+            return;
+        }
+        block.crc = crc32(0, block.data, block.length);
+        char out[DEFLATE_BUFFER_SIZE];
+        int flush = block.last ? Z_FINISH : Z_SYNC_FLUSH;
+        zs.next_in = (Bytef*)block.data;
+        zs.avail_in = block.length;
+        do {
+            zs.next_out = (Bytef*)out;
+            zs.avail_out = sizeof(out);
+            if (deflate(&zs, flush) == Z_STREAM_ERROR) {
+                block.failed = true;
+                return;
+            }
+            block.compressed.append(out, sizeof(out) - zs.avail_out);
+        } while (zs.avail_out == 0);
+    } catch (...) {
+        block.failed = true;
+    }
+}
+
+}
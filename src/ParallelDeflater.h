@@ -0,0 +1,151 @@
+// File: ParallelDeflater.h
+// ParallelDeflater declaration file
+//
+
+#ifndef PARALLELDEFLATER_H
+#define PARALLELDEFLATER_H
+
+#include "zlib.h"
+#include <string>
+#include <vector>
+
+namespace splib {
+
+/**
+ * A raw deflate compressor that uses several threads. The data is cut
+ * into blocks of a fixed size, and a batch of blocks is compressed at a
+ * time, each block by one thread. Every block is compressed on its own,
+ * with the 32 KB of data that precede it as the dictionary, and ends
+ * with a sync flush, except the last one, which ends the stream; the
+ * compressed blocks are thus byte-aligned and make up a single deflate
+ * stream when concatenated. The CRC-32 of each block is computed by its
+ * thread, and the CRC-32 of the data is combined from them.
+ */
+class ParallelDeflater {
+    public:
+        /**
+         * Creates a new instance of <code>ParallelDeflater</code>.
+         * @param threads the number of threads, including the calling one
+         * @param level the compression level, as in zlib
+         */
+        ParallelDeflater(int threads, int level);
+
+        /** Destructor */
+        ~ParallelDeflater();
+
+        /**
+         * Adds data to compress. Full batches of blocks are compressed
+         * as soon as more data follows them.
+         * @throw IOException if compression fails
+         */
+        void write(const void* buffer, unsigned length);
+
+        /**
+         * Compresses the rest of the data and ends the deflate stream.
+         * @throw IOException if compression fails
+         */
+        void finish();
+
+        /**
+         * Retrieves the compressed data produced so far; the caller
+         * takes it away by clearing the string.
+         */
+        std::basic_string<char>& output();
+
+        /** Retrieves the CRC-32 of the data compressed so far. */
+        unsigned long crc() const;
+
+        /** Retrieves the size of the data compressed so far. */
+        unsigned long size() const;
+
+    private:
+        /** A block of data and its compressed form */
+        struct Block {
+            /** The first byte of the block */
+            const Bytef* data;
+
+            /** The size of the block */
+            unsigned length;
+
+            /** The size of the data before the block used as dictionary */
+            unsigned dictionary;
+
+            /** Indicates whether the block ends the stream */
+            bool last;
+
+            /** The compressed block */
+            std::basic_string<char> compressed;
+
+            /** The CRC-32 of the block */
+            unsigned long crc;
+
+            /** Indicates whether compression failed */
+            bool failed;
+        };
+
+        /** The code run by the threads that compress a batch */
+        class Compressor;
+
+        /** The size of a block */
+        enum {BLOCK_SIZE = 128 * 1024};
+
+        /** The size of the dictionary of a block */
+        enum {DICTIONARY_SIZE = 32 * 1024};
+
+        /** The size of the buffer used to compress a block */
+        enum {DEFLATE_BUFFER_SIZE = 16384};
+
+        /**
+         * Compresses the data in the batch buffer and appends it to
+         * the output.
+         * @param last indicates whether the batch ends the stream
+         */
+        void compressBatch(bool last);
+
+        /**
+         * Compresses a block. Does not throw.
+         * @param zs a stream that has just been reset
+         */
+        static void compressBlock(Block& block, z_stream& zs);
+
+        /** Not implemented; deflaters are not copied */
+        ParallelDeflater(const ParallelDeflater&);
+
+        /** Not implemented; deflaters are not copied */
+        ParallelDeflater& operator = (const ParallelDeflater&);
+
+    private:
+        /** The number of threads */
+        int threads;
+
+        /** The compression level */
+        int level;
+
+        /**
+         * The dictionary of the first block of the batch, followed by
+         * the data of the batch
+         */
+        std::vector<Bytef> batch;
+
+        /** The size of the dictionary at the start of the batch buffer */
+        unsigned dictionary;
+
+        /** The number of bytes in the batch buffer, dictionary included */
+        unsigned used;
+
+        /** The blocks of the batch */
+        std::vector<Block> blocks;
+
+        /** The compressed data not taken yet */
+        std::basic_string<char> compressed;
+
+        /** The CRC-32 of the data */
+        unsigned long dataCrc;
+
+        /** The size of the data */
+        unsigned long dataSize;
+};
+
+}
+
+#endif // PARALLELDEFLATER_H
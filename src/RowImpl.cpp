@@ -7,7 +7,7 @@
 
 namespace splib {
 
-RowImpl::RowImpl() {
+RowImpl::RowImpl() : cellsImpl(Arena::of(this)) {
     height = -1;
 }
 
@@ -23,4 +23,8 @@ Cells& RowImpl::cells() {
     return cellsImpl;
 }
 
+const Cells& RowImpl::cells() const {
+    return cellsImpl;
+}
+
 }
@@ -13,7 +13,10 @@ namespace splib {
 /** Default implementation of the <code>Row</code> interface. */
 class RowImpl : public Row {
     public:
-        /** Creates a new <code>RowImpl</code> */
+        /**
+         * Creates a new <code>RowImpl</code>. The object must be allocated
+         * from an <code>Arena</code>, which is also used for its cells.
+         */
         RowImpl();
 
         // inherit doc
@@ -25,6 +28,9 @@ class RowImpl : public Row {
         // inherit doc
         virtual Cells& cells();
 
+        // inherit doc
+        virtual const Cells& cells() const;
+
     private:
         /** Stores the height */
         double height;
@@ -8,6 +8,9 @@
 
 namespace splib {
 
+RowsImpl::RowsImpl(Arena& arena) : collection(arena) {
+}
+
 Row& RowsImpl::get(int index) {
     if (!IndexLimits::validateRow(index)) {
         throw IllegalArgumentException();
@@ -15,13 +18,24 @@ Row& RowsImpl::get(int index) {
     return collection.get(index);
 }
 
-bool RowsImpl::contains(int index) {
+bool RowsImpl::contains(int index) const {
     if (!IndexLimits::validateRow(index)) {
         throw IllegalArgumentException();
     }
     return collection.contains(index);
 }
 
+const Row* RowsImpl::find(int index) const {
+    if (!IndexLimits::validateRow(index)) {
+        throw IllegalArgumentException();
+    }
+    return collection.find(index);
+}
+
+int RowsImpl::next(int index) const {
+    return collection.next(index);
+}
+
 void RowsImpl::remove(int index) {
     if (!IndexLimits::validateRow(index)) {
         throw IllegalArgumentException();
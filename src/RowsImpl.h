@@ -14,11 +14,23 @@ namespace splib {
 /** Default implementation of the <code>Rows</code> interface. */
 class RowsImpl : public Rows {
     public:
+        /**
+         * Creates a new instance of <code>RowsImpl</code>.
+         * @param arena the arena to allocate the rows from
+         */
+        RowsImpl(Arena& arena);
+
         // inherit doc
         virtual Row& get(int index);
 
         // inherit doc
-        virtual bool contains(int index);
+        virtual bool contains(int index) const;
+
+        // inherit doc
+        virtual const Row* find(int index) const;
+
+        // inherit doc
+        virtual int next(int index) const;
 
         // inherit doc
         virtual void remove(int index);
@@ -38,6 +50,42 @@ class RowsImpl : public Rows {
         // inherit doc
         virtual Entry last();
 
+        /**
+         * Finds the largest index of a row that is not greater than
+         * a specified index.
+         * @param index the index to start from
+         * @return the row index, or -1 if there is none
+         */
+        int previous(int index) const {
+            return collection.previous(index);
+        }
+
+        /**
+         * Calls a function for each row in the order of the row indices,
+         * as <code>f(row, object)</code>.
+         */
+        template<class F>
+        void forEach(F& f) {
+            collection.forEach(f);
+        }
+
+        /**
+         * Calls a function for each row with an index in a range, as
+         * <code>f(row, object)</code>.
+         */
+        template<class F>
+        void forEachInRange(int first, int last, F& f) {
+            collection.forEachInRange(first, last, f);
+        }
+
+        /**
+         * Removes the rows with indices in a range, together with their
+         * cells. The indices are not validated.
+         */
+        void removeRange(int first, int last) {
+            collection.removeRange(first, last);
+        }
+
     private:
         /** The object used to store and manage the collection of rows */
         IndexedCollectionImpl<Row,RowImpl> collection;
@@ -0,0 +1,88 @@
+// File: SharedStrings.cpp
+// SharedStrings implementation file
+//
+
+#include "SharedStrings.h"
+#include "splibint.h"
+
+#include <string.h>
+
+namespace splib {
+
+SharedStrings::SharedStrings() : buckets(64, -1), refs(0), sealed(false) {
+}
+
+int SharedStrings::add(const _TCHAR* s) {
+    if (sealed) {
+        throw IllegalStateException(_T("shared strings are sealed"));
+    }
+    size_t length;
+    unsigned hash = hashCode(s, length);
+    int b = bucket(s, length, hash);
+    refs++;
+    if (buckets[b] != -1) {
+        return buckets[b];
+    }
+    Entry e;
+    e.offset = chars.size();
+    e.length = length;
+    e.hash = hash;
+    chars.insert(chars.end(), s, s + length + 1);
+    int index = (int)entries.size();
+    entries.push_back(e);
+    buckets[b] = index;
+    // keep the load factor below 1/2
+    if (entries.size() * 2 > buckets.size()) {
+        rehash();
+    }
+    return index;
+}
+
+int SharedStrings::find(const _TCHAR* s) const {
+    size_t length;
+    unsigned hash = hashCode(s, length);
+    return buckets[bucket(s, length, hash)];
+}
+
+unsigned SharedStrings::hashCode(const _TCHAR* s, size_t& length) {
+    // FNV-1a
+    unsigned hash = 2166136261u;
+    const _TCHAR* p = s;
+    for (; *p; p++) {
+        hash = (hash ^ (unsigned)*p) * 16777619u;
+    }
+    length = p - s;
+    return hash;
+}
+
+int SharedStrings::bucket(const _TCHAR* s, size_t length,
+                          unsigned hash) const {
+    int mask = (int)buckets.size() - 1;
+    int b = (int)(hash & mask);
+    while (buckets[b] != -1) {
+        const Entry& e = entries[buckets[b]];
+        if (e.hash == hash && e.length == length &&
+            memcmp(&chars[e.offset], s, length * sizeof(_TCHAR)) == 0) {
+            break;
+        }
+        b = (b + 1) & mask;
+    }
+    return b;
+}
+
+void SharedStrings::rehash() {
+    std::vector<int> old(buckets.size() * 2, -1);
+    old.swap(buckets);
+    int mask = (int)buckets.size() - 1;
+    for (std::vector<int>::size_type i = 0; i < old.size(); i++) {
+        if (old[i] != -1) {
+            int b = (int)(entries[old[i]].hash & mask);
+            while (buckets[b] != -1) {
+                b = (b + 1) & mask;
+            }
+            buckets[b] = old[i];
+        }
+    }
+}
+
+}
@@ -0,0 +1,120 @@
+// File: SharedStrings.h
+// SharedStrings declaration file
+//
+
+#ifndef SHAREDSTRINGS_H
+#define SHAREDSTRINGS_H
+
+#include "splib.h"
+
+#include <vector>
+
+namespace splib {
+
+/**
+ * The shared string table of an xlsx package. Each distinct text is
+ * stored once and identified by its index in the table, in the order the
+ * texts are first added; cells refer to their text by this index.
+ * <p>
+ * The texts are kept one after another in a single buffer, and found
+ * through an open-addressing hash table of indexes. Once the table is
+ * sealed, texts can no longer be added, and several threads can find
+ * texts in it at the same time.
+ */
+class SharedStrings {
+    public:
+        /** Creates a new, empty table. */
+        SharedStrings();
+
+        /**
+         * Adds a reference to a text, storing it if necessary.
+         * @param s a pointer to the text
+         * @return the index of the text
+         * @throw IllegalStateException if the table is sealed
+         */
+        int add(const _TCHAR* s);
+
+        /**
+         * Finds a text without adding a reference to it.
+         * @param s a pointer to the text
+         * @return the index of the text or <code>-1</code>
+         */
+        int find(const _TCHAR* s) const;
+
+        /**
+         * Retrieves a text.
+         * @param index the index of the text
+         * @return a pointer to the text; valid until a text is added
+         */
+        const _TCHAR* get(int index) const {
+            return &chars[entries[index].offset];
+        }
+
+        /** Returns the number of distinct texts in the table. */
+        int size() const {
+            return (int)entries.size();
+        }
+
+        /** Returns the number of references added to the texts. */
+        long references() const {
+            return refs;
+        }
+
+        /** Prevents texts from being added from now on. */
+        void seal() {
+            sealed = true;
+        }
+
+        /** Indicates whether the table is sealed. */
+        bool isSealed() const {
+            return sealed;
+        }
+
+    private:
+        /** A text of the table */
+        struct Entry {
+            /** The offset of the text in the buffer */
+            size_t offset;
+
+            /** The length of the text, without the terminating 0 */
+            size_t length;
+
+            /** The hash code of the text */
+            unsigned hash;
+        };
+
+        /** Computes the hash code of a text. */
+        static unsigned hashCode(const _TCHAR* s, size_t& length);
+
+        /**
+         * Finds the bucket that holds a text, or the empty bucket
+         * where it should be placed.
+         */
+        int bucket(const _TCHAR* s, size_t length, unsigned hash) const;
+
+        /** Rebuilds the hash table with twice the number of buckets. */
+        void rehash();
+
+    private:
+        /** The texts, each followed by a 0 */
+        std::vector<_TCHAR> chars;
+
+        /** The texts, by index */
+        std::vector<Entry> entries;
+
+        /**
+         * The open-addressing hash table of indexes; the number of
+         * buckets is a power of two and empty buckets hold <code>-1</code>
+         */
+        std::vector<int> buckets;
+
+        /** The number of references added */
+        long refs;
+
+        /** Indicates whether the table is sealed */
+        bool sealed;
+};
+
+}
+
+#endif // SHAREDSTRINGS_H
@@ -4,6 +4,8 @@
 
 #include "splib.h"
 #include "TableImpl.h"
+#include "ColumnarTableImpl.h"
+#include "StringPool.h"
 #include "splibint.h"
 
 #include <string.h>
@@ -11,25 +13,27 @@
 namespace splib {
 
 SpreadsheetImpl::SpreadsheetImpl() {
+    strings = new StringPool();
 }
 
 SpreadsheetImpl::~SpreadsheetImpl() {
     for (std::vector<Table*>::size_type i = 0; i < tables.size(); i++) {
         delete tables[i];
     }
+    delete strings;
 }
 
 Table& SpreadsheetImpl::insertTable(int index, const _TCHAR* name) {
-    if (index < 0 || index > tableCount()) {
-        throw IllegalArgumentException();
-    }
-    if (name == 0) {
-        throw IllegalArgumentException();
-    }
-    if (tableExists(name)) {
-        throw IllegalArgumentException();
-    }
-    Table* table = new TableImpl(this);
+    checkInsert(index, name);
+    Table* table = new TableImpl(this, *strings);
+    table->setName(name);
+    tables.insert(tables.begin() + index, table);
+    return *table;
+}
+
+Table& SpreadsheetImpl::insertColumnarTable(int index, const _TCHAR* name) {
+    checkInsert(index, name);
+    Table* table = new ColumnarTableImpl(this, *strings);
     table->setName(name);
     tables.insert(tables.begin() + index, table);
     return *table;
@@ -92,4 +96,16 @@ int SpreadsheetImpl::find(const _TCHAR* name) {
     return -1;
 }
 
+void SpreadsheetImpl::checkInsert(int index, const _TCHAR* name) {
+    if (index < 0 || index > tableCount()) {
+        throw IllegalArgumentException();
+    }
+    if (name == 0) {
+        throw IllegalArgumentException();
+    }
+    if (tableExists(name)) {
+        throw IllegalArgumentException();
+    }
+}
+
 }
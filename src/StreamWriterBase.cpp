@@ -0,0 +1,167 @@
+// File: StreamWriterBase.cpp
+// StreamWriterBase implementation file
+//
+
+#include "StreamWriterBase.h"
+#include "Formulas.h"
+#include "IndexLimits.h"
+#include "splibint.h"
+
+namespace splib {
+
+StreamWriterBase::StreamWriterBase(int columns, int rows)
+        : columns(columns), rows(rows), inSheet(false), sheetOpened(false), lastRow(-1), pendingRow(-1),
+          pendingHeight(-1), closed(false) {
+}
+
+StreamWriterBase::~StreamWriterBase() {
+}
+
+void StreamWriterBase::beginSheet(const _TCHAR* name) {
+    if (closed || inSheet) {
+        throw IllegalStateException();
+    }
+    if (name == 0) {
+        throw IllegalArgumentException();
+    }
+    for (Names::size_type i = 0; i < names.size(); i++) {
+        if (names[i] == name) {
+            throw IllegalArgumentException();
+        }
+    }
+    names.push_back(name);
+    widths.clear();
+    inSheet = true;
+    sheetOpened = false;
+    lastRow = -1;
+    pendingRow = -1;
+}
+
+void StreamWriterBase::setColumnWidth(int column, double width) {
+    checkSheet();
+    if (sheetOpened) {
+        throw IllegalStateException();
+    }
+    if (!fitsColumn(column)) {
+        throw IllegalArgumentException();
+    }
+    if (width < 0) {
+        widths.erase(column);
+    } else {
+        widths[column] = width;
+    }
+}
+
+void StreamWriterBase::setRowHeight(int row, double height) {
+    checkSheet();
+    if (!fitsRow(row) || row <= lastRow ||
+        (pendingRow != -1 && row < pendingRow)) {
+        throw IllegalArgumentException();
+    }
+    if (row != pendingRow) {
+        flushPending();
+    }
+    pendingRow = row;
+    pendingHeight = height;
+}
+
+void StreamWriterBase::writeRow(int row, int first, const CellValue* values,
+                                int count) {
+    checkSheet();
+    checkRow(row, first, values, count);
+    double height = -1;
+    if (row == pendingRow) {
+        height = pendingHeight;
+        pendingRow = -1;
+    } else {
+        flushPending();
+    }
+    startRows();
+    outputRow(row, height, first, values, count);
+    lastRow = row;
+}
+
+void StreamWriterBase::endSheet() {
+    checkSheet();
+    flushPending();
+    startRows();
+    closeSheet();
+    inSheet = false;
+}
+
+void StreamWriterBase::close() {
+    if (closed) {
+        throw IllegalStateException();
+    }
+    if (inSheet) {
+        endSheet();
+    }
+    closed = true;
+    closeFile(names);
+}
+
+bool StreamWriterBase::isClosed() const {
+    return closed;
+}
+
+bool StreamWriterBase::fitsColumn(int column) const {
+    return IndexLimits::validateColumn(column) && column < columns;
+}
+
+bool StreamWriterBase::fitsRow(int row) const {
+    return IndexLimits::validateRow(row) && row < rows;
+}
+
+void StreamWriterBase::checkSheet() const {
+    if (!inSheet) {
+        throw IllegalStateException();
+    }
+}
+
+void StreamWriterBase::checkRow(int row, int first, const CellValue* values,
+                                int count) const {
+    if (count < 0 || (values == 0 && count > 0)) {
+        throw IllegalArgumentException();
+    }
+    if (!fitsColumn(first) || !fitsRow(row)) {
+        throw IllegalArgumentException();
+    }
+    if (count > 0 && !fitsColumn(first + count - 1)) {
+        throw IllegalArgumentException();
+    }
+    if (row <= lastRow || (pendingRow != -1 && row < pendingRow)) {
+        throw IllegalArgumentException();
+    }
+    for (int i = 0; i < count; i++) {
+        if (values[i].getType() != Cell::FORMULA) {
+            continue;
+        }
+        int c1, r1, c2, r2;
+        const _TCHAR* f = values[i].getFormula();
+        if (f == 0 || !Formulas::parse(f, c1, r1, c2, r2) ||
+            !fitsColumn(c1) || !fitsRow(r1) ||
+            !fitsColumn(c2) || !fitsRow(r2)) {
+            throw IllegalArgumentException();
+        }
+    }
+}
+
+void StreamWriterBase::startRows() {
+    if (!sheetOpened) {
+        openSheet((int)names.size() - 1, names.back().c_str(), widths);
+        widths.clear();
+        sheetOpened = true;
+    }
+}
+
+void StreamWriterBase::flushPending() {
+    if (pendingRow != -1) {
+        int row = pendingRow;
+        pendingRow = -1;
+        startRows();
+        outputRow(row, pendingHeight, 0, 0, 0);
+        lastRow = row;
+    }
+}
+
+}
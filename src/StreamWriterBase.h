@@ -0,0 +1,153 @@
+// File: StreamWriterBase.h
+// StreamWriterBase declaration file
+//
+
+#ifndef STREAMWRITERBASE_H
+#define STREAMWRITERBASE_H
+
+#include "splib.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace splib {
+
+/**
+ * A reusable partial implementation of the <code>StreamWriter</code>
+ * interface. It validates the calls and keeps track of the sheets and
+ * rows written, and passes the sheets to the derived classes in the
+ * order of the file: the start of a sheet with the widths of its columns,
+ * the rows in ascending order, each with its height and cells, and the
+ * end of the sheet. Indices are checked against the grid of the format.
+ * The only state kept is the names of the sheets and the widths of the
+ * columns of the current sheet until its first row.
+ */
+class StreamWriterBase : public StreamWriter {
+    public:
+        /** The names of the sheets, in order */
+        typedef std::vector<std::basic_string<_TCHAR> > Names;
+
+        /** The widths of the columns of a sheet, by column index */
+        typedef std::map<int, double> Widths;
+
+    public:
+        /**
+         * Creates a new instance of <code>StreamWriterBase</code>.
+         * @param columns the number of columns of the grid of the format
+         * @param rows the number of rows of the grid of the format
+         */
+        StreamWriterBase(int columns, int rows);
+
+        /** Destructor */
+        virtual ~StreamWriterBase();
+
+        // inherit doc
+        virtual void beginSheet(const _TCHAR* name);
+
+        // inherit doc
+        virtual void setColumnWidth(int column, double width);
+
+        // inherit doc
+        virtual void setRowHeight(int row, double height);
+
+        // inherit doc
+        virtual void writeRow(int row, int first, const CellValue* values,
+                              int count);
+
+        // inherit doc
+        virtual void endSheet();
+
+        // inherit doc
+        virtual void close();
+
+        /** Checks whether the writer is closed. */
+        bool isClosed() const;
+
+    protected:
+        /**
+         * Starts the output of a sheet.
+         * @param index the index of the sheet, starting from 0
+         * @param name a pointer to the name of the sheet
+         * @param widths the widths of the columns of the sheet
+         */
+        virtual void openSheet(int index, const _TCHAR* name,
+                               const Widths& widths) = 0;
+
+        /**
+         * Outputs a row of the current sheet. The arguments have been
+         * validated.
+         * @param row row index
+         * @param height the height of the row, or a negative value for
+         *        the default height
+         * @param first the column index of the first value
+         * @param values a pointer to an array of <code>count</code> values
+         * @param count the number of values; may be 0
+         */
+        virtual void outputRow(int row, double height, int first,
+                               const CellValue* values, int count) = 0;
+
+        /** Finishes the output of the current sheet. */
+        virtual void closeSheet() = 0;
+
+        /**
+         * Finishes the output of the file.
+         * @param names the names of all sheets written
+         */
+        virtual void closeFile(const Names& names) = 0;
+
+    private:
+        /** Checks whether a column index fits the grid. */
+        bool fitsColumn(int column) const;
+
+        /** Checks whether a row index fits the grid. */
+        bool fitsRow(int row) const;
+
+        /** Throws unless a sheet is being written. */
+        void checkSheet() const;
+
+        /** Validates the arguments of writeRow(). */
+        void checkRow(int row, int first, const CellValue* values,
+                      int count) const;
+
+        /** Opens the current sheet unless it is open. */
+        void startRows();
+
+        /** Outputs the row that has a height but has not been written. */
+        void flushPending();
+
+    private:
+        /** The number of columns of the grid */
+        int columns;
+
+        /** The number of rows of the grid */
+        int rows;
+
+        /** The names of the sheets started */
+        Names names;
+
+        /** The widths of the columns of the current sheet, until opened */
+        Widths widths;
+
+        /** Indicates whether a sheet is being written */
+        bool inSheet;
+
+        /** Indicates whether the current sheet has been opened */
+        bool sheetOpened;
+
+        /** The index of the last row written to the sheet, or -1 */
+        int lastRow;
+
+        /** The index of the row whose height is set, or -1 */
+        int pendingRow;
+
+        /** The height of <code>pendingRow</code> */
+        double pendingHeight;
+
+        /** Indicates whether the writer is closed */
+        bool closed;
+};
+
+}
+
+#endif // STREAMWRITERBASE_H
@@ -0,0 +1,133 @@
+// File: StringPool.cpp
+// StringPool implementation file
+//
+
+#include "StringPool.h"
+#include "splibint.h"
+
+#include <string.h>
+
+namespace splib {
+
+StringPool::StringPool() : buckets(64, -1), count(0) {
+}
+
+StringPool::~StringPool() {
+    for (std::vector<Entry>::size_type i = 0; i < entries.size(); i++) {
+        delete[] entries[i].text;
+    }
+}
+
+int StringPool::add(const _TCHAR* s) {
+    size_t length;
+    unsigned hash = hashCode(s, length);
+    int b = bucket(s, length, hash);
+    if (buckets[b] != -1) {
+        entries[buckets[b]].refs++;
+        return buckets[b];
+    }
+    _TCHAR* text = new _TCHAR[length + 1];
+    memcpy(text, s, (length + 1) * sizeof(_TCHAR));
+    int id;
+    if (unused.empty()) {
+        id = (int)entries.size();
+        try {
+            entries.push_back(Entry());
+        } catch (...) {
+            delete[] text;
+            throw;
+        }
+    } else {
+        id = unused.back();
+        unused.pop_back();
+    }
+    Entry& e = entries[id];
+    e.text = text;
+    e.length = length;
+    e.hash = hash;
+    e.refs = 1;
+    buckets[b] = id;
+    count++;
+    // keep the load factor below 1/2
+    if (count * 2 > (int)buckets.size()) {
+        rehash();
+    }
+    return id;
+}
+
+void StringPool::release(int id, int n) {
+    Entry& e = entries[id];
+    e.refs -= n;
+    if (e.refs > 0) {
+        return;
+    }
+    // remove the id from the hash table, shifting back the entries
+    // that follow it in the same probe sequence
+    int mask = (int)buckets.size() - 1;
+    int b = bucket(e.text, e.length, e.hash);
+    int next = (b + 1) & mask;
+    while (buckets[next] != -1) {
+        int home = (int)(entries[buckets[next]].hash & mask);
+        // move the entry back unless its home lies cyclically in (b, next]
+        if ((next > b && (home <= b || home > next)) ||
+            (next < b && (home <= b && home > next))) {
+            buckets[b] = buckets[next];
+            b = next;
+        }
+        next = (next + 1) & mask;
+    }
+    buckets[b] = -1;
+    delete[] e.text;
+    e.text = 0;
+    e.refs = 0;
+    unused.push_back(id);
+    count--;
+}
+
+int StringPool::find(const _TCHAR* s) const {
+    size_t length;
+    unsigned hash = hashCode(s, length);
+    return buckets[bucket(s, length, hash)];
+}
+
+unsigned StringPool::hashCode(const _TCHAR* s, size_t& length) {
+    // FNV-1a
+    unsigned hash = 2166136261u;
+    const _TCHAR* p = s;
+    for (; *p; p++) {
+        hash = (hash ^ (unsigned)*p) * 16777619u;
+    }
+    length = p - s;
+    return hash;
+}
+
+int StringPool::bucket(const _TCHAR* s, size_t length, unsigned hash) const {
+    int mask = (int)buckets.size() - 1;
+    int b = (int)(hash & mask);
+    while (buckets[b] != -1) {
+        const Entry& e = entries[buckets[b]];
+        if (e.hash == hash && e.length == length &&
+            memcmp(e.text, s, length * sizeof(_TCHAR)) == 0) {
+            break;
+        }
+        b = (b + 1) & mask;
+    }
+    return b;
+}
+
+void StringPool::rehash() {
+    std::vector<int> old(buckets.size() * 2, -1);
+    old.swap(buckets);
+    int mask = (int)buckets.size() - 1;
+    for (std::vector<int>::size_type i = 0; i < old.size(); i++) {
+        if (old[i] != -1) {
+            int b = (int)(entries[old[i]].hash & mask);
+            while (buckets[b] != -1) {
+                b = (b + 1) & mask;
+            }
+            buckets[b] = old[i];
+        }
+    }
+}
+
+}
@@ -0,0 +1,136 @@
+// File: StringPool.h
+// StringPool declaration file
+//
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include "splib.h"
+
+#include <vector>
+
+namespace splib {
+
+/**
+ * A spreadsheet-wide pool of interned strings. Each distinct string is
+ * stored once and identified by a 32-bit id; cells keep the id of their
+ * text or formula. The pool counts the references to each string and
+ * reuses the id of a string once its last reference is released.
+ * <p>
+ * Ids range from 0 to <code>idLimit() - 1</code>; ids of released
+ * strings are not valid until they are reused. Writers can walk
+ * the distinct strings with <code>isValid()</code> and
+ * <code>get()</code>.
+ * <p>
+ * Each string is kept in a buffer of its own that does not move when
+ * other strings are added, so that the pointers returned by
+ * <code>get()</code> stay valid until the string is released.
+ */
+class StringPool {
+    public:
+        /** Creates a new, empty pool. */
+        StringPool();
+
+        /** Destructor. Frees the strings. */
+        ~StringPool();
+
+        /**
+         * Adds a reference to a string, interning it if necessary.
+         * @param s a pointer to the string
+         * @return the id of the string
+         */
+        int add(const _TCHAR* s);
+
+        /**
+         * Releases references to a string.
+         * @param id the id of the string
+         * @param count the number of references to release
+         */
+        void release(int id, int count = 1);
+
+        /**
+         * Retrieves a string.
+         * @param id the id of the string
+         * @return a pointer to the string; valid as long as the string
+         *         is referenced, even when other strings are added
+         */
+        const _TCHAR* get(int id) const {
+            return entries[id].text;
+        }
+
+        /**
+         * Finds a string without adding a reference to it.
+         * @param s a pointer to the string
+         * @return the id of the string or <code>-1</code>
+         */
+        int find(const _TCHAR* s) const;
+
+        /** Returns an upper bound of the ids in use. */
+        int idLimit() const {
+            return (int)entries.size();
+        }
+
+        /** Checks whether an id refers to a string. */
+        bool isValid(int id) const {
+            return entries[id].refs > 0;
+        }
+
+        /** Returns the number of distinct strings in the pool. */
+        int size() const {
+            return count;
+        }
+
+    private:
+        /** A string of the pool */
+        struct Entry {
+            /** The 0-terminated string, or 0 if the entry is unused */
+            _TCHAR* text;
+
+            /** The length of the string */
+            size_t length;
+
+            /** The hash code of the string */
+            unsigned hash;
+
+            /** The number of references; 0 if the entry is unused */
+            int refs;
+        };
+
+        /** Computes the hash code of a string. */
+        static unsigned hashCode(const _TCHAR* s, size_t& length);
+
+        /**
+         * Finds the bucket that holds a string, or the empty bucket
+         * where it should be placed.
+         */
+        int bucket(const _TCHAR* s, size_t length, unsigned hash) const;
+
+        /** Rebuilds the hash table with twice the number of buckets. */
+        void rehash();
+
+        /** Not implemented; pools are not copied */
+        StringPool(const StringPool&);
+
+        /** Not implemented; pools are not copied */
+        StringPool& operator = (const StringPool&);
+
+    private:
+        /** The strings, indexed by id */
+        std::vector<Entry> entries;
+
+        /** The ids of the unused entries */
+        std::vector<int> unused;
+
+        /**
+         * The open-addressing hash table of ids; the number of buckets
+         * is a power of two and empty buckets hold <code>-1</code>
+         */
+        std::vector<int> buckets;
+
+        /** The number of distinct strings */
+        int count;
+};
+
+}
+
+#endif // STRINGPOOL_H
@@ -0,0 +1,255 @@
+// File: TableBase.cpp
+// TableBase implementation file
+//
+
+#include "TableBase.h"
+#include "Util.h"
+#include "IndexLimits.h"
+#include "splibint.h"
+
+#include <stddef.h>
+#include <string.h>
+
+namespace splib {
+
+TableBase::TableBase(Spreadsheet* sp, StringPool& strings)
+        : spreadsheet(sp), pool(strings) {
+}
+
+TableBase::~TableBase() {
+    for (int i = 0; i < (int)stringRefs.size(); i++) {
+        if (stringRefs[i] > 0) {
+            pool.release(i, stringRefs[i]);
+        }
+    }
+}
+
+Cell& TableBase::cell(const _TCHAR* columnrow) {
+    if (columnrow == 0) {
+        throw IllegalArgumentException();
+    }
+    int column;
+    int row;
+    if (!Util::parseLocation(columnrow, column, row)) {
+        throw IllegalArgumentException();
+    }
+    return cell(column, row);
+}
+
+void TableBase::clearCell(const _TCHAR* columnrow) {
+    if (columnrow == 0) {
+        throw IllegalArgumentException();
+    }
+    int column;
+    int row;
+    if (!Util::parseLocation(columnrow, column, row)) {
+        throw IllegalArgumentException();
+    }
+    clearCell(column, row);
+}
+
+void TableBase::clearRange(int column1, int row1,
+                           int column2, int row2) {
+    if (!IndexLimits::validate(column1, row1)) {
+        throw IllegalArgumentException();
+    }
+    if (!IndexLimits::validate(column2, row2)) {
+        throw IllegalArgumentException();
+    }
+    int left;
+    int right;
+    int top;
+    int bottom;
+    if (column1 < column2) {
+        left = column1;
+        right = column2;
+    } else {
+        left = column2;
+        right = column1;
+    }
+    if (row1 < row2) {
+        top = row1;
+        bottom = row2;
+    } else {
+        top = row2;
+        bottom = row1;
+    }
+    eraseRange(left, top, right, bottom);
+}
+
+void TableBase::clearRange(const _TCHAR* columnrow1,
+                           const _TCHAR* columnrow2) {
+    if (columnrow1 == 0 || columnrow2 == 0) {
+        throw IllegalArgumentException();
+    }
+    int column1;
+    int row1;
+    int column2;
+    int row2;
+    if (!Util::parseLocation(columnrow1, column1, row1)) {
+        throw IllegalArgumentException();
+    }
+    if (!Util::parseLocation(columnrow2, column2, row2)) {
+        throw IllegalArgumentException();
+    }
+    clearRange(column1, row1, column2, row2);
+}
+
+bool TableBase::isEmptyCell(const _TCHAR* columnrow) const {
+    if (columnrow == 0) {
+        throw IllegalArgumentException();
+    }
+    int column;
+    int row;
+    if (!Util::parseLocation(columnrow, column, row)) {
+        throw IllegalArgumentException();
+    }
+    return isEmptyCell(column, row);
+}
+
+const Cell* TableBase::findCell(const _TCHAR* columnrow) const {
+    if (columnrow == 0) {
+        throw IllegalArgumentException();
+    }
+    int column;
+    int row;
+    if (!Util::parseLocation(columnrow, column, row)) {
+        throw IllegalArgumentException();
+    }
+    return findCell(column, row);
+}
+
+int TableBase::addString(const _TCHAR* s) {
+    int id = pool.add(s);
+    if (id >= (int)stringRefs.size()) {
+        stringRefs.resize(pool.idLimit(), 0);
+    }
+    stringRefs[id]++;
+    return id;
+}
+
+void TableBase::releaseString(int id) {
+    stringRefs[id]--;
+    pool.release(id);
+}
+
+void TableBase::setRow(int row, int first, const CellValue* values,
+                       int count) {
+    checkRow(row, first, values, count);
+    storeRow(row, first, values, count);
+}
+
+int TableBase::appendRow(const CellValue* values, int count) {
+    int row = lastRow() + 1;
+    setRow(row, 0, values, count);
+    return row;
+}
+
+void TableBase::checkRow(int row, int first, const CellValue* values,
+                         int count) {
+    if (count < 0 || (values == 0 && count > 0)) {
+        throw IllegalArgumentException();
+    }
+    if (!IndexLimits::validate(first, row)) {
+        throw IllegalArgumentException();
+    }
+    if (count > 0 && !IndexLimits::validateColumn(first + count - 1)) {
+        throw IllegalArgumentException();
+    }
+}
+
+void TableBase::setRange(int column, int row, int width, int height,
+                         const double* values, int stride) {
+    fillRange(column, row, width, height, values, stride);
+}
+
+void TableBase::setRange(int column, int row, int width, int height,
+                         const long* values, int stride) {
+    fillRange(column, row, width, height, values, stride);
+}
+
+void TableBase::setRange(int column, int row, int width, int height,
+                         const _TCHAR* const* values, int stride) {
+    fillRange(column, row, width, height, values, stride);
+}
+
+void TableBase::setRange(int column, int row, int width, int height,
+                         const Date* values, int stride) {
+    fillRange(column, row, width, height, values, stride);
+}
+
+void TableBase::checkRange(int column, int row, int width, int height,
+                           const void* values) {
+    if (width < 0 || height < 0) {
+        throw IllegalArgumentException();
+    }
+    if (width == 0 || height == 0) {
+        return;
+    }
+    if (values == 0 ||
+        !IndexLimits::validate(column, row) ||
+        !IndexLimits::validate(column + width - 1, row + height - 1)) {
+        throw IllegalArgumentException();
+    }
+}
+
+template<class T>
+void TableBase::fillRange(int column, int row, int width, int height,
+                          const T* values, int stride) {
+    checkRange(column, row, width, height, values);
+    CellValue batch[BATCH_SIZE];
+    for (int j = 0; j < height; j++) {
+        const T* v = values + (ptrdiff_t)j * stride;
+        for (int i = 0; i < width; i += BATCH_SIZE) {
+            int n = width - i < BATCH_SIZE ? width - i : BATCH_SIZE;
+            for (int k = 0; k < n; k++) {
+                batch[k] = CellValue(v[i + k]);
+            }
+            storeRow(row + j, column + i, batch, n);
+        }
+    }
+}
+
+void TableBase::removeRows(int row1, int row2) {
+    if (!IndexLimits::validateRow(row1) || !IndexLimits::validateRow(row2)) {
+        throw IllegalArgumentException();
+    }
+    if (row1 < row2) {
+        eraseRows(row1, row2);
+    } else {
+        eraseRows(row2, row1);
+    }
+}
+
+void TableBase::removeColumns(int column1, int column2) {
+    if (!IndexLimits::validateColumn(column1) ||
+        !IndexLimits::validateColumn(column2)) {
+        throw IllegalArgumentException();
+    }
+    int left = column1 < column2 ? column1 : column2;
+    int right = column1 < column2 ? column2 : column1;
+    if (lastRow() >= 0) {
+        eraseRange(left, firstRow(), right, lastRow());
+    }
+    eraseColumns(left, right);
+}
+
+const TableStatistics& TableBase::statistics() const {
+    return stats;
+}
+
+const _TCHAR* TableBase::getName() const {
+    return name.c_str();
+}
+
+void TableBase::setName(const _TCHAR* name) {
+    for (int i = 0; i < spreadsheet->tableCount(); i++) {
+        Table& t = spreadsheet->table(i);
+        if (&t != this && _tcscmp(t.getName(), name) == 0) {
+            throw IllegalArgumentException();
+        }
+    }
+    this->name = name;
+}
+
+}
@@ -0,0 +1,215 @@
+// File: TableBase.h
+// TableBase declaration file
+//
+
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include "splib.h"
+#include "StringPool.h"
+#include "TableStatisticsImpl.h"
+
+namespace splib {
+
+/**
+ * A reusable partial implementation of the <code>Table</code> interface.
+ * It implements the methods that take cell positions as strings on top
+ * of their integer counterparts, as well as the table name. Derived
+ * classes provide the storage of rows, columns, and cells.
+ * <p>
+ * Texts and formulas of the cells are kept in the string pool of the
+ * spreadsheet. The table counts its own references to each string and
+ * releases them all when it is destroyed, so that the cells do not have
+ * to be visited one by one.
+ */
+class TableBase : public Table {
+    public:
+        /** The number of cells stored in one bulk request. */
+        enum {BATCH_SIZE = 64};
+
+    public:
+        /**
+         * Creates a new instance of <code>TableBase</code>.
+         * @param spreadsheet a pointer to the parent spreadsheet;
+         *        used to protect against table name duplications
+         * @param strings the string pool of the spreadsheet
+         */
+        TableBase(Spreadsheet* spreadsheet, StringPool& strings);
+
+        /** Destructor */
+        virtual ~TableBase();
+
+        // inherit doc
+        virtual Cell& cell(int column, int row) = 0;
+
+        // inherit doc
+        virtual Cell& cell(const _TCHAR* columnrow);
+
+        // inherit doc
+        virtual void clearCell(int column, int row) = 0;
+
+        // inherit doc
+        virtual void clearCell(const _TCHAR* columnrow);
+
+        // inherit doc
+        virtual void clearRange(int column1, int row1,
+                                int column2, int row2);
+
+        // inherit doc
+        virtual void clearRange(const _TCHAR* columnrow1,
+                                const _TCHAR* columnrow2);
+
+        // inherit doc
+        virtual void removeRows(int row1, int row2);
+
+        // inherit doc
+        virtual void removeColumns(int column1, int column2);
+
+        // inherit doc
+        virtual bool isEmptyCell(int column, int row) const = 0;
+
+        // inherit doc
+        virtual bool isEmptyCell(const _TCHAR* columnrow) const;
+
+        // inherit doc
+        virtual const Cell* findCell(int column, int row) const = 0;
+
+        // inherit doc
+        virtual const Cell* findCell(const _TCHAR* columnrow) const;
+
+        // inherit doc
+        virtual void setRow(int row, int first, const CellValue* values,
+                            int count);
+
+        // inherit doc
+        virtual int appendRow(const CellValue* values, int count);
+
+        // inherit doc
+        virtual void setRange(int column, int row, int width, int height,
+                              const double* values, int stride);
+
+        // inherit doc
+        virtual void setRange(int column, int row, int width, int height,
+                              const long* values, int stride);
+
+        // inherit doc
+        virtual void setRange(int column, int row, int width, int height,
+                              const _TCHAR* const* values, int stride);
+
+        // inherit doc
+        virtual void setRange(int column, int row, int width, int height,
+                              const Date* values, int stride);
+
+        // inherit doc
+        virtual const _TCHAR* getName() const;
+
+        // inherit doc
+        virtual void setName(const _TCHAR* name);
+
+        // inherit doc
+        virtual const TableStatistics& statistics() const;
+
+        /** Returns the statistics to be updated as cells change. */
+        TableStatisticsImpl& cellStatistics() {
+            return stats;
+        }
+
+        /** Returns the statistics of the cells. */
+        const TableStatisticsImpl& cellStatistics() const {
+            return stats;
+        }
+
+        /** Returns the string pool of the spreadsheet. */
+        const StringPool& strings() const {
+            return pool;
+        }
+
+        /**
+         * Adds a reference to a string held by a cell of the table.
+         * @param s a pointer to the string
+         * @return the id of the string in the pool
+         */
+        int addString(const _TCHAR* s);
+
+        /**
+         * Releases a reference to a string held by a cell of the table.
+         * @param id the id of the string in the pool
+         */
+        void releaseString(int id);
+
+        /**
+         * Retrieves a string held by a cell of the table.
+         * @param id the id of the string in the pool
+         */
+        const _TCHAR* string(int id) const {
+            return pool.get(id);
+        }
+
+    protected:
+        /**
+         * Stores values in consecutive cells of a row, as
+         * <code>setRow()</code> does, once the arguments are validated.
+         */
+        virtual void storeRow(int row, int first, const CellValue* values,
+                              int count) = 0;
+
+        /**
+         * Clears a normalized, validated rectangular range of cells, as
+         * <code>clearRange()</code> does, visiting only existing cells.
+         */
+        virtual void eraseRange(int left, int top, int right,
+                                int bottom) = 0;
+
+        /** Removes a normalized, validated range of rows. */
+        virtual void eraseRows(int first, int last) = 0;
+
+        /**
+         * Removes the column objects of a normalized, validated range
+         * of columns; their cells are already cleared.
+         */
+        virtual void eraseColumns(int first, int last) = 0;
+
+    private:
+        /**
+         * Validates the arguments of <code>setRow()</code>.
+         * @throw IllegalArgumentException if the arguments are not valid
+         */
+        static void checkRow(int row, int first, const CellValue* values,
+                             int count);
+
+        /**
+         * Validates the arguments of <code>setRange()</code>.
+         * @throw IllegalArgumentException if the arguments are not valid
+         */
+        static void checkRange(int column, int row, int width, int height,
+                               const void* values);
+
+        /**
+         * Implements the variants of <code>setRange()</code>; the values
+         * are wrapped into <code>CellValue</code>s one batch at a time
+         * and stored with <code>storeRow()</code>.
+         */
+        template<class T>
+        void fillRange(int column, int row, int width, int height,
+                       const T* values, int stride);
+
+    private:
+        /** The table name */
+        std::basic_string<_TCHAR> name;
+
+        /** A pointer to the parent spreadsheet */
+        Spreadsheet* spreadsheet;
+
+        /** The string pool of the spreadsheet */
+        StringPool& pool;
+
+        /** The number of references the table holds, indexed by id */
+        std::vector<int> stringRefs;
+
+        /** The statistics of the cells */
+        TableStatisticsImpl stats;
+};
+
+}
+
+#endif // TABLEBASE_H
@@ -4,18 +4,20 @@
 
 #include "TableImpl.h"
 #include "CellImpl.h"
-#include "Util.h"
 #include "IndexLimits.h"
 #include "splibint.h"
 
-#include <string.h>
-
 namespace splib {
 
-TableImpl::TableImpl(Spreadsheet* sp) : spreadsheet(sp) {
+TableImpl::TableImpl(Spreadsheet* sp, StringPool& strings)
+        : TableBase(sp, strings), rowsImpl(arena), columnsImpl(arena) {
+    arena.setOwner(this);
 }
 
 TableImpl::~TableImpl() {
+    // the cells hold nothing but the arena memory and string references,
+    // and both are released by the table as a whole
+    arena.close();
 }
 
 Cell& TableImpl::cell(int column, int row) {
@@ -25,18 +27,6 @@ Cell& TableImpl::cell(int column, int row) {
     return rows().get(row).cells().get(column);
 }
 
-Cell& TableImpl::cell(const _TCHAR* columnrow) {
-    if (columnrow == 0) {
-        throw IllegalArgumentException();
-    }
-    int column;
-    int row;
-    if (!Util::parseLocation(columnrow, column, row)) {
-        throw IllegalArgumentException();
-    }
-    return cell(column, row);
-}
-
 void TableImpl::clearCell(int column, int row) {
     if (!IndexLimits::validate(column, row)) {
         throw IllegalArgumentException();
@@ -50,169 +40,111 @@ void TableImpl::clearCell(int column, int row) {
     }
 }
 
-void TableImpl::clearCell(const _TCHAR* columnrow) {
-    if (columnrow == 0) {
-        throw IllegalArgumentException();
-    }
-    int column;
-    int row;
-    if (!Util::parseLocation(columnrow, column, row)) {
-        throw IllegalArgumentException();
+void TableImpl::storeRow(int row, int first, const CellValue* values,
+                         int count) {
+    CellsImpl& cells = (CellsImpl&)rows().get(row).cells();
+    Cell* batch[BATCH_SIZE];
+    int i = 0;
+    while (i < count) {
+        // skip the values that leave their cells untouched, then set
+        // the cells of the following run of values in batches
+        if (values[i].getType() == Cell::NONE) {
+            i++;
+            continue;
+        }
+        int n = 1;
+        while (n < BATCH_SIZE && i + n < count &&
+               values[i + n].getType() != Cell::NONE) {
+            n++;
+        }
+        cells.getRange(first + i, n, batch);
+        for (int j = 0; j < n; j++) {
+            ((CellImpl*)batch[j])->setValue(values[i + j]);
+        }
+        i += n;
     }
-    clearCell(column, row);
 }
 
-void TableImpl::clearRange(int column1, int row1,
-                           int column2, int row2) {
-    if (!IndexLimits::validate(column1, row1)) {
-        throw IllegalArgumentException();
-    }
-    if (!IndexLimits::validate(column2, row2)) {
-        throw IllegalArgumentException();
-    }
-    int left;
-    int right;
-    int top;
-    int bottom;
-    if (column1 < column2) {
-        left = column1;
-        right = column2;
-    } else {
-        left = column2;
-        right = column1;
-    }
-    if (row1 < row2) {
-        top = row1;
-        bottom = row2;
-    } else {
-        top = row2;
-        bottom = row1;
-    }
-    for (int i = left; i <= right; i++) {
-        for (int j = top; j <= bottom; j++) {
-            clearCell(i, j);
+class TableImpl::RangeEraser {
+    public:
+        RangeEraser(int left, int right) : left(left), right(right) {}
+
+        void operator () (int index, Row& row) {
+            CellsImpl& cells = (CellsImpl&)row.cells();
+            cells.removeRange(left, right);
+            if (cells.isEmpty() && row.getHeight() < 0) {
+                emptied.push_back(index);
+            }
         }
+
+        /** The first column of the range */
+        int left;
+
+        /** The last column of the range */
+        int right;
+
+        /** The rows left without cells, to be removed */
+        std::vector<int> emptied;
+};
+
+void TableImpl::eraseRange(int left, int top, int right, int bottom) {
+    RangeEraser eraser(left, right);
+    rowsImpl.forEachInRange(top, bottom, eraser);
+    for (std::vector<int>::size_type i = 0; i < eraser.emptied.size(); i++) {
+        rowsImpl.remove(eraser.emptied[i]);
     }
 }
 
-void TableImpl::clearRange(const _TCHAR* columnrow1,
-                           const _TCHAR* columnrow2) {
-    if (columnrow1 == 0 || columnrow2 == 0) {
-        throw IllegalArgumentException();
-    }
-    int column1;
-    int row1;
-    int column2;
-    int row2;
-    if (!Util::parseLocation(columnrow1, column1, row1)) {
-        throw IllegalArgumentException();
-    }
-    if (!Util::parseLocation(columnrow2, column2, row2)) {
-        throw IllegalArgumentException();
-    }
-    clearRange(column1, row1, column2, row2);
+void TableImpl::eraseRows(int first, int last) {
+    rowsImpl.removeRange(first, last);
+}
+
+void TableImpl::eraseColumns(int first, int last) {
+    columnsImpl.removeRange(first, last);
 }
 
 bool TableImpl::isEmptyCell(int column, int row) const {
-    if (!IndexLimits::validate(column, row)) {
-        throw IllegalArgumentException();
-    }
-    TableImpl* pThis = (TableImpl*)this;
-    if (!pThis->rows().contains(row)) {
-        return true;
-    }
-    Row& r = pThis->rows().get(row);
-    return !r.cells().contains(column);
+    return findCell(column, row) == 0;
 }
 
-bool TableImpl::isEmptyCell(const _TCHAR* columnrow) const {
-    if (columnrow == 0) {
-        throw IllegalArgumentException();
-    }
-    int column;
-    int row;
-    if (!Util::parseLocation(columnrow, column, row)) {
+const Cell* TableImpl::findCell(int column, int row) const {
+    if (!IndexLimits::validate(column, row)) {
         throw IllegalArgumentException();
     }
-    return isEmptyCell(column, row);
+    const Row* r = rowsImpl.find(row);
+    return r != 0 ? r->cells().find(column) : 0;
 }
 
 int TableImpl::firstColumn() const {
-    int res = -1;
-    TableImpl* pThis = (TableImpl*)this;
-    Rows::Iterator* i = pThis->rows().iterator();
-    while (i->hasNext()) {
-        Rows::Entry entry = i->next();
-        Cells& cells = entry.object().cells();
-        if (cells.size() > 0) {
-            int first = cells.first().index();
-            if (res == -1 || first < res) {
-                res = first;
-            }
-        }
-    }
-    delete i;
-    return res;
+    return cellStatistics().firstColumn();
 }
 
 int TableImpl::lastColumn() const {
-    int res = -1;
-    TableImpl* pThis = (TableImpl*)this;
-    Rows::Iterator* i = pThis->rows().iterator();
-    while (i->hasNext()) {
-        Rows::Entry entry = i->next();
-        Cells& cells = entry.object().cells();
-        if (cells.size() > 0) {
-            int last = cells.last().index();
-            if (res == -1 || last > res) {
-                res = last;
-            }
-        }
-    }
-    delete i;
-    return res;
+    return cellStatistics().lastColumn();
 }
 
 int TableImpl::firstRow() const {
-    TableImpl* pThis = (TableImpl*)this;
-    Rows& rows = pThis->rows();
-    if (!rows.isEmpty()) {
-        return rows.first().index();
-    } else {
-        return -1;
-    }
+    return rowsImpl.next(0);
 }
 
 int TableImpl::lastRow() const {
-    TableImpl* pThis = (TableImpl*)this;
-    Rows& rows = pThis->rows();
-    if (!rows.isEmpty()) {
-        return rows.last().index();
-    } else {
-        return -1;
-    }
+    return rowsImpl.previous(IndexLimits::MAX_ROWS - 1);
 }
 
 Rows& TableImpl::rows() {
     return rowsImpl;
 }
 
-Columns& TableImpl::columns() {
-    return columnsImpl;
+const Rows& TableImpl::rows() const {
+    return rowsImpl;
 }
 
-const _TCHAR* TableImpl::getName() const {
-    return name.c_str();
+Columns& TableImpl::columns() {
+    return columnsImpl;
 }
 
-void TableImpl::setName(const _TCHAR* name) {
-    for (int i = 0; i < spreadsheet->tableCount(); i++) {
-        Table& t = spreadsheet->table(i);
-        if (&t != this && _tcscmp(t.getName(), name) == 0) {
-            throw IllegalArgumentException();
-        }
-    }
-    this->name = name;
+const Columns& TableImpl::columns() const {
+    return columnsImpl;
 }
 
 }
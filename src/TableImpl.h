@@ -6,49 +6,43 @@
 #define TABLEIMPL_H
 
 #include "splib.h"
+#include "TableBase.h"
 #include "RowsImpl.h"
 #include "ColumnsImpl.h"
+#include "Arena.h"
 
 namespace splib {
 
 /** Default implementation of the <code>Table</code> interface. */
-class TableImpl : public Table {
+class TableImpl : public TableBase {
     public:
         /**
          * Creates a new instance of <code>TableImpl</code>.
          * @param spreadsheet a pointer to the parent spreadsheet;
          *        used to protect against table name duplications
+         * @param strings the string pool of the spreadsheet
          */
-        TableImpl(Spreadsheet* spreadsheet);
+        TableImpl(Spreadsheet* spreadsheet, StringPool& strings);
 
         /** Destructor */
         virtual ~TableImpl();
 
-        // inherit doc
-        virtual Cell& cell(int column, int row);
+        using TableBase::cell;
+        using TableBase::clearCell;
+        using TableBase::isEmptyCell;
+        using TableBase::findCell;
 
         // inherit doc
-        virtual Cell& cell(const _TCHAR* columnrow);
+        virtual Cell& cell(int column, int row);
 
         // inherit doc
         virtual void clearCell(int column, int row);
 
-        // inherit doc
-        virtual void clearCell(const _TCHAR* columnrow);
-
-        // inherit doc
-        virtual void clearRange(int column1, int row1,
-                                int column2, int row2);
-
-        // inherit doc
-        virtual void clearRange(const _TCHAR* columnrow1,
-                                const _TCHAR* columnrow2);
-
         // inherit doc
         virtual bool isEmptyCell(int column, int row) const;
 
         // inherit doc
-        virtual bool isEmptyCell(const _TCHAR* columnrow) const;
+        virtual const Cell* findCell(int column, int row) const;
 
         // inherit doc
         virtual int firstColumn() const;
@@ -65,27 +59,42 @@ class TableImpl : public Table {
         // inherit doc
         virtual Rows& rows();
 
+        // inherit doc
+        virtual const Rows& rows() const;
+
         // inherit doc
         virtual Columns& columns();
 
         // inherit doc
-        virtual const _TCHAR* getName() const;
+        virtual const Columns& columns() const;
 
+    protected:
         // inherit doc
-        virtual void setName(const _TCHAR* name);
+        virtual void storeRow(int row, int first, const CellValue* values,
+                              int count);
+
+        // inherit doc
+        virtual void eraseRange(int left, int top, int right, int bottom);
+
+        // inherit doc
+        virtual void eraseRows(int first, int last);
+
+        // inherit doc
+        virtual void eraseColumns(int first, int last);
 
     private:
+        /** Clears a range of columns in the rows it visits. */
+        class RangeEraser;
+
+    private:
+        /** The arena that stores rows, columns, and cells */
+        Arena arena;
+
         /** The collection of rows */
         RowsImpl rowsImpl;
 
         /** The collection of columns */
         ColumnsImpl columnsImpl;
-
-        /** The table name */
-        std::basic_string<_TCHAR> name;
-
-        /** A pointer to the parent spreadsheet */
-        Spreadsheet* spreadsheet;
 };
 
 }
@@ -0,0 +1,35 @@
+// File: TableStatisticsImpl.cpp
+// TableStatisticsImpl implementation file
+//
+
+#include "TableStatisticsImpl.h"
+#include "splibint.h"
+
+namespace splib {
+
+TableStatisticsImpl::TableStatisticsImpl() : first(-1), last(-1) {
+}
+
+void TableStatisticsImpl::cellRemoved(int column, Cell::Type type) {
+    counts[type]--;
+    total--;
+    if (--columnCells[column] > 0) {
+        return;
+    }
+    if (total == 0) {
+        first = last = -1;
+        return;
+    }
+    if (column == first) {
+        while (columnCells[first] == 0) {
+            first++;
+        }
+    }
+    if (column == last) {
+        while (columnCells[last] == 0) {
+            last--;
+        }
+    }
+}
+
+}
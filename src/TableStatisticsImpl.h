@@ -0,0 +1,93 @@
+// File: TableStatisticsImpl.h
+// TableStatisticsImpl declaration file
+//
+
+#ifndef TABLESTATISTICSIMPL_H
+#define TABLESTATISTICSIMPL_H
+
+#include "splib.h"
+
+#include <vector>
+
+namespace splib {
+
+/**
+ * Default implementation of <code>TableStatistics</code>. The tables
+ * report every cell they create and remove and every change of a cell
+ * type. Besides the counts by type, the object counts the cells of each
+ * column, which gives the first and last columns of the table in
+ * constant time; only removing the last cell of the first or last column
+ * looks for the next non-empty column.
+ */
+class TableStatisticsImpl : public TableStatistics {
+    public:
+        /** Creates statistics of an empty table. */
+        TableStatisticsImpl();
+
+        /**
+         * Records the creation of an empty cell.
+         * @param column the column index of the cell
+         */
+        void cellAdded(int column) {
+            counts[Cell::NONE]++;
+            total++;
+            if (column >= (int)columnCells.size()) {
+                columnCells.resize(column + 1, 0);
+            }
+            if (columnCells[column]++ == 0) {
+                if (first == -1 || column < first) {
+                    first = column;
+                }
+                if (column > last) {
+                    last = column;
+                }
+            }
+        }
+
+        /**
+         * Records the removal of a cell.
+         * @param column the column index of the cell
+         * @param type the type of the cell
+         */
+        void cellRemoved(int column, Cell::Type type);
+
+        /**
+         * Records the change of a cell type.
+         * @param from the old type
+         * @param to the new type
+         */
+        void typeChanged(Cell::Type from, Cell::Type to) {
+            counts[from]--;
+            counts[to]++;
+        }
+
+        /**
+         * Returns the index of the first column with cells.
+         * @return the column index or <code>-1</code>
+         */
+        int firstColumn() const {
+            return first;
+        }
+
+        /**
+         * Returns the index of the last column with cells.
+         * @return the column index or <code>-1</code>
+         */
+        int lastColumn() const {
+            return last;
+        }
+
+    private:
+        /** The number of cells in each column, indexed by column */
+        std::vector<int> columnCells;
+
+        /** The index of the first column with cells, or -1 */
+        int first;
+
+        /** The index of the last column with cells, or -1 */
+        int last;
+};
+
+}
+
+#endif // TABLESTATISTICSIMPL_H
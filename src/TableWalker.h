@@ -0,0 +1,138 @@
+// File: TableWalker.h
+// TableWalker declaration file
+//
+
+#ifndef TABLEWALKER_H
+#define TABLEWALKER_H
+
+#include "splib.h"
+#include "TableImpl.h"
+#include "RowsImpl.h"
+#include "CellsImpl.h"
+#include "ColumnarTableImpl.h"
+#include "ColumnarRow.h"
+#include "ColumnarCell.h"
+
+namespace splib {
+
+/**
+ * Walks the rows and cells of a table in the order of their indices
+ * without allocating iterators. The walker finds out once which
+ * implementation stores the table and then traverses its storage
+ * directly; tables of other implementations are walked with the
+ * iterators of the <code>Table</code> interface.
+ * <p>
+ * A visitor is any object with the methods
+ * <code>void row(int index, Row& row)</code> and
+ * <code>void cell(int column, Cell& cell)</code>. The references passed
+ * to the visitor are only valid during the call, and the table must not
+ * be modified while it is walked.
+ */
+class TableWalker {
+    public:
+        /**
+         * Creates a new instance of <code>TableWalker</code>.
+         * @param table the table to walk
+         */
+        explicit TableWalker(Table& table)
+            : table(table),
+              rowTable(dynamic_cast<TableImpl*>(&table)),
+              columnarTable(dynamic_cast<ColumnarTableImpl*>(&table)) {}
+
+        /**
+         * Calls <code>visitor.row()</code> for each row of the table.
+         * @param visitor the visitor
+         */
+        template<class V>
+        void forEachRow(V& visitor) {
+            if (rowTable != 0) {
+                RowCall<V> call(visitor);
+                ((RowsImpl&)rowTable->rows()).forEach(call);
+            } else if (columnarTable != 0) {
+                ColumnarRow view;
+                for (int r = columnarTable->nextRow(0); r != -1;
+                     r = columnarTable->nextRow(r + 1)) {
+                    view.bind(columnarTable, r);
+                    visitor.row(r, view);
+                }
+            } else {
+                Rows::Iterator* i = table.rows().iterator();
+                while (i->hasNext()) {
+                    Rows::Entry entry = i->next();
+                    visitor.row(entry.index(), entry.object());
+                }
+                delete i;
+            }
+        }
+
+        /**
+         * Calls <code>visitor.cell()</code> for each cell of a row.
+         * @param index the row index
+         * @param row the row, as passed to <code>visitor.row()</code>
+         * @param visitor the visitor
+         */
+        template<class V>
+        void forEachCell(int index, Row& row, V& visitor) {
+            if (rowTable != 0) {
+                CellCall<V> call(visitor);
+                ((CellsImpl&)row.cells()).forEach(call);
+            } else if (columnarTable != 0) {
+                ColumnarCell view;
+                for (int c = columnarTable->nextCell(index, 0); c != -1;
+                     c = columnarTable->nextCell(index, c + 1)) {
+                    view.bind(columnarTable, c, index);
+                    visitor.cell(c, view);
+                }
+            } else {
+                Cells::Iterator* i = row.cells().iterator();
+                while (i->hasNext()) {
+                    Cells::Entry entry = i->next();
+                    visitor.cell(entry.index(), entry.object());
+                }
+                delete i;
+            }
+        }
+
+    private:
+        /** Forwards the rows of a collection to a visitor. */
+        template<class V>
+        class RowCall {
+            public:
+                RowCall(V& visitor) : visitor(visitor) {}
+
+                void operator () (int index, Row& row) {
+                    visitor.row(index, row);
+                }
+
+            private:
+                V& visitor;
+        };
+
+        /** Forwards the cells of a collection to a visitor. */
+        template<class V>
+        class CellCall {
+            public:
+                CellCall(V& visitor) : visitor(visitor) {}
+
+                void operator () (int column, Cell& cell) {
+                    visitor.cell(column, cell);
+                }
+
+            private:
+                V& visitor;
+        };
+
+    private:
+        /** The table to walk */
+        Table& table;
+
+        /** The table if it is a <code>TableImpl</code>, or 0 */
+        TableImpl* rowTable;
+
+        /** The table if it is a <code>ColumnarTableImpl</code>, or 0 */
+        ColumnarTableImpl* columnarTable;
+};
+
+}
+
+#endif // TABLEWALKER_H
@@ -0,0 +1,68 @@
+// File: Thread.cpp
+// Thread implementation file
+//
+
+#include "splib.h"
+#include "Thread.h"
+#ifdef WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include "splibint.h"
+
+namespace splib {
+
+Thread::Thread(Runnable& runnable) : joined(false) {
+#ifdef WIN32
+    handle = (HANDLE)_beginthreadex(0, 0, start, &runnable, 0, 0);
+    bool started = handle != 0;
+#else
+    bool started = pthread_create(&handle, 0, start, &runnable) == 0;
+#endif
+    if (!started) {
+        throw IllegalStateException(_T("error starting a thread"));
+    }
+}
+
+Thread::~Thread() {
+    join();
+}
+
+void Thread::join() {
+    if (joined) {
+        return;
+    }
+#ifdef WIN32
+    WaitForSingleObject(handle, INFINITE);
+    CloseHandle(handle);
+#else
+    pthread_join(handle, 0);
+#endif
+    joined = true;
+}
+
+int Thread::processors() {
+#ifdef WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int n = (int)info.dwNumberOfProcessors;
+#else
+    int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return n > 0 ? n : 1;
+}
+
+#ifdef WIN32
+unsigned __stdcall Thread::start(void* runnable) {
+    ((Runnable*)runnable)->run();
+    return 0;
+}
+#else
+void* Thread::start(void* runnable) {
+    ((Runnable*)runnable)->run();
+    return 0;
+}
+#endif
+
+}
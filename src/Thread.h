@@ -0,0 +1,92 @@
+// File: Thread.h
+// Thread declaration file
+//
+
+#ifndef THREAD_H
+#define THREAD_H
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/**
+ * Declares a variable of which each thread has its own copy. The type of
+ * the variable must be a POD type, and it cannot have an initializer
+ * other than a constant.
+ */
+#ifdef _MSC_VER
+#define SPLIB_THREAD_LOCAL __declspec(thread)
+#else
+#define SPLIB_THREAD_LOCAL __thread
+#endif
+
+namespace splib {
+
+/**
+ * A thread of the operating system. The thread starts when the object is
+ * created and runs a <code>Runnable</code>; it is joined at the latest
+ * when the object is destroyed.
+ */
+class Thread {
+    public:
+        /** The code run by a thread. */
+        class Runnable {
+            public:
+                /**
+                 * Runs the code. Exceptions must not escape this method.
+                 */
+                virtual void run() = 0;
+
+                /** Empty virtual destructor */
+                virtual ~Runnable() {}
+        };
+
+    public:
+        /**
+         * Starts a new thread.
+         * @param runnable the code to run; must live until the thread
+         *        is joined
+         * @throw IllegalStateException if the thread cannot be started
+         */
+        explicit Thread(Runnable& runnable);
+
+        /** Destructor. Joins the thread unless it has been joined. */
+        ~Thread();
+
+        /** Waits until the thread finishes, unless it has been joined. */
+        void join();
+
+        /** Retrieves the number of processors available. */
+        static int processors();
+
+    private:
+        /** The entry point of the thread */
+#ifdef WIN32
+        static unsigned __stdcall start(void* runnable);
+#else
+        static void* start(void* runnable);
+#endif
+
+        /** Not implemented; threads are not copied */
+        Thread(const Thread&);
+
+        /** Not implemented; threads are not copied */
+        Thread& operator = (const Thread&);
+
+    private:
+        /** The handle of the thread */
+#ifdef WIN32
+        HANDLE handle;
+#else
+        pthread_t handle;
+#endif
+
+        /** Indicates whether the thread has been joined */
+        bool joined;
+};
+
+}
+
+#endif // THREAD_H
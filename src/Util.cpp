@@ -3,11 +3,48 @@
 //
 
 #include "Util.h"
-#include <sstream>
+#include "NumberFormat.h"
+#include <string.h>
 #include "splibint.h"
 
 namespace splib {
 
+// the names of the columns whose names start with a prefix, in order
+#define SPLIB_COLUMNS1(p) p "A", p "B", p "C", p "D", p "E", p "F", p "G", \
+    p "H", p "I", p "J", p "K", p "L", p "M", p "N", p "O", p "P", p "Q", \
+    p "R", p "S", p "T", p "U", p "V", p "W", p "X", p "Y", p "Z"
+#define SPLIB_COLUMNS2(p) SPLIB_COLUMNS1(p "A"), SPLIB_COLUMNS1(p "B"), \
+    SPLIB_COLUMNS1(p "C"), SPLIB_COLUMNS1(p "D"), SPLIB_COLUMNS1(p "E"), \
+    SPLIB_COLUMNS1(p "F"), SPLIB_COLUMNS1(p "G"), SPLIB_COLUMNS1(p "H"), \
+    SPLIB_COLUMNS1(p "I"), SPLIB_COLUMNS1(p "J"), SPLIB_COLUMNS1(p "K"), \
+    SPLIB_COLUMNS1(p "L"), SPLIB_COLUMNS1(p "M"), SPLIB_COLUMNS1(p "N"), \
+    SPLIB_COLUMNS1(p "O"), SPLIB_COLUMNS1(p "P"), SPLIB_COLUMNS1(p "Q"), \
+    SPLIB_COLUMNS1(p "R"), SPLIB_COLUMNS1(p "S"), SPLIB_COLUMNS1(p "T"), \
+    SPLIB_COLUMNS1(p "U"), SPLIB_COLUMNS1(p "V"), SPLIB_COLUMNS1(p "W"), \
+    SPLIB_COLUMNS1(p "X"), SPLIB_COLUMNS1(p "Y"), SPLIB_COLUMNS1(p "Z")
+
+/**
+ * The names of the columns, from A to XZZ, which is past the last column
+ * of xlsx, XFD; the names of one, two, and three letters start at the
+ * indices 0, 26, and 702.
+ */
+static const char COLUMN_NAMES[][4] = {
+    SPLIB_COLUMNS1(""),
+    SPLIB_COLUMNS2(""),
+    SPLIB_COLUMNS2("A"), SPLIB_COLUMNS2("B"), SPLIB_COLUMNS2("C"),
+    SPLIB_COLUMNS2("D"), SPLIB_COLUMNS2("E"), SPLIB_COLUMNS2("F"),
+    SPLIB_COLUMNS2("G"), SPLIB_COLUMNS2("H"), SPLIB_COLUMNS2("I"),
+    SPLIB_COLUMNS2("J"), SPLIB_COLUMNS2("K"), SPLIB_COLUMNS2("L"),
+    SPLIB_COLUMNS2("M"), SPLIB_COLUMNS2("N"), SPLIB_COLUMNS2("O"),
+    SPLIB_COLUMNS2("P"), SPLIB_COLUMNS2("Q"), SPLIB_COLUMNS2("R"),
+    SPLIB_COLUMNS2("S"), SPLIB_COLUMNS2("T"), SPLIB_COLUMNS2("U"),
+    SPLIB_COLUMNS2("V"), SPLIB_COLUMNS2("W"), SPLIB_COLUMNS2("X")
+};
+
+/** The number of columns in the table of names */
+static const int COLUMN_NAME_COUNT =
+    (int)(sizeof(COLUMN_NAMES) / sizeof(COLUMN_NAMES[0]));
+
 bool Util::parseLocation(const _TCHAR* str, int& col, int& row) {
     int c, r;
     if (!parseEmbeddedLocation(str, c, r)) {
@@ -22,35 +59,30 @@ bool Util::parseLocation(const _TCHAR* str, int& col, int& row) {
 }
 
 bool Util::parseEmbeddedLocation(const _TCHAR*& str, int& col, int& row) {
-    // parse letter part (determine its length first)
+    // parse letter part; the letters form a bijective base-26 number,
+    // A to Z standing for 1 to 26
     const _TCHAR* s = str;
-    int len = 0;
-    while(*s >= 'A' && *s <= 'Z') {
-        s++;
-        len++;
-    }
-    if (len < 1) {
-        return false;
-    }
-    s = str;
-    // now actual parsing
     int c = 0;
     int BASE = 'Z' - 'A' + 1;
     while(*s >= 'A' && *s <= 'Z') {
-        c = c * BASE + (*s - 'A');
-        // the most significant symbol should be +1 if the length
-        // is greater than 1. That's why that initial length
-        // calculation was necessary
-        if (s == str && len > 1) {
-            c++;
+        if (s - str == MAX_LETTERS) {
+            return false;
         }
+        c = c * BASE + (*s - 'A' + 1);
         s++;
     }
+    if (c == 0) {
+        return false;
+    }
+    c--;
     // parse number part
     int r = 0;
     bool specified = false;
     BASE = 10;
     while(*s >= '0' && *s <= '9') {
+        if (r > MAX_ROW_NUMBER) {
+            return false;
+        }
         r = r * BASE + (*s - '0');
         specified = true;
         s++;
@@ -71,30 +103,22 @@ bool Util::parseEmbeddedLocation(const _TCHAR*& str, int& col, int& row) {
 }
 
 bool Util::parseColumn(const _TCHAR* str, int& col) {
-    // determine length first
+    // the letters form a bijective base-26 number, A to Z standing
+    // for 1 to 26
     const _TCHAR* s = str;
-    int len = 0;
-    while(*s >= 'A' && *s <= 'Z') {
-        s++;
-        len++;
-    }
-    if (len < 1) {
-        return false;
-    }
-    s = str;
-    // now actual parsing
     int c = 0;
     int BASE = 'Z' - 'A' + 1;
     while(*s >= 'A' && *s <= 'Z') {
-        c = c * BASE + (*s - 'A');
-        // the most significant symbol should be +1 if the length
-        // is greater than 1. That's why that initial length
-        // calculation was necessary
-        if (s == str && len > 1) {
-            c++;
+        if (s - str == MAX_LETTERS) {
+            return false;
         }
+        c = c * BASE + (*s - 'A' + 1);
         s++;
     }
+    if (c == 0) {
+        return false;
+    }
+    c--;
     if (*s) {
         return false;
     }
@@ -104,19 +128,29 @@ bool Util::parseColumn(const _TCHAR* str, int& col) {
 }
 
 std::basic_string<char> Util::buildLocation(int col, int row) {
-    std::basic_string<char> column;
-    const int BASE = 'Z' - 'A' + 1;
-    do {
-        char c = 'A' + (char)(col % BASE);
-        if (column.length() > 0) {
-            c--;
+    char buffer[LOCATION_SIZE];
+    return std::basic_string<char>(buffer, formatLocation(col, row, buffer));
+}
+
+int Util::formatLocation(int col, int row, char* buffer) {
+    char* p = buffer;
+    if (col >= 0 && col < COLUMN_NAME_COUNT) {
+        ::memcpy(p, COLUMN_NAMES[col], 4);
+        p += col < 26 ? 1 : col < 702 ? 2 : 3;
+    } else {
+        const int BASE = 'Z' - 'A' + 1;
+        // bijective base-26, A to Z standing for 1 to 26
+        char letters[8];
+        int n = 0;
+        for (unsigned u = (unsigned)col + 1; u > 0; u = (u - 1) / BASE) {
+            letters[n++] = (char)('A' + (u - 1) % BASE);
         }
-        column.insert(column.begin(), c);
-        col = col / BASE;
-    } while (col > 0);
-    std::basic_stringstream<char> res;
-    res << column << row + 1;
-    return res.str();
+        while (n > 0) {
+            *p++ = letters[--n];
+        }
+    }
+    p += NumberFormat::format((long)row + 1, p);
+    return (int)(p - buffer);
 }
 
 }
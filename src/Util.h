@@ -12,6 +12,12 @@ namespace splib {
 /** Static methods for parsing and producing cell locations. */
 class Util {
     public:
+        /**
+         * The size of a buffer that holds any location formatted by
+         * <code>formatLocation()</code>
+         */
+        enum {LOCATION_SIZE = 24};
+
         /**
          * Parses a cell location string, e.g. "A10".
          * @param s a pointer to the string to parse
@@ -46,6 +52,18 @@ class Util {
          */
         static std::basic_string<char> buildLocation(int col, int row);
 
+        /**
+         * Formats a location from column and row indices into a buffer,
+         * without allocating. The names of the columns are looked up in
+         * a table, up to column XZZ.
+         * @param col column index
+         * @param row row index
+         * @param buffer a pointer to at least <code>LOCATION_SIZE</code>
+         *        characters; the result, e.g. "A10", is 0-terminated
+         * @return the number of characters, the terminating 0 excluded
+         */
+        static int formatLocation(int col, int row, char* buffer);
+
         /**
          * Parses a column specification string, for example, "AA".
          * @param s a pointer to the string to parse
@@ -55,6 +73,14 @@ class Util {
          *         false otherwise
          */
         static bool parseColumn(const _TCHAR* s, int& col);
+
+    private:
+        /**
+         * The longest column name and the largest row number parsed;
+         * longer names and larger numbers are rejected before they can
+         * overflow an int. Both are well past the limits of the table.
+         */
+        enum {MAX_LETTERS = 6, MAX_ROW_NUMBER = 99999999};
 };
 
 }
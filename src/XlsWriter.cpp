@@ -12,4 +12,8 @@ void XlsWriter::write(Spreadsheet& spreadsheet, const _TCHAR* pathname) {
     XlsWriterImpl::write(spreadsheet, pathname);
 }
 
+void XlsWriter::write(Spreadsheet& spreadsheet, OutputSink& sink) {
+    XlsWriterImpl::write(spreadsheet, sink);
+}
+
 }
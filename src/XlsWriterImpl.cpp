@@ -4,22 +4,98 @@
 
 #include "splib.h"
 #include "XlsWriterImpl.h"
-#include "ByteArray.h"
-#include "BasicExcel.h"
+#include "CompoundFileWriter.h"
 #include "ToUTF16.h"
 #include "ExcelUtil.h"
 #include "Formulas.h"
+#include "TableWalker.h"
+#include "IndexLimits.h"
 #include "splibint.h"
 
 namespace splib {
 
+class XlsWriterImpl::RowWriter {
+    public:
+        RowWriter(TableWalker& walker, CompoundFileWriter& out)
+            : walker(walker), out(out), current(0) {}
+
+        void row(int index, Row& row) {
+            double height = row.getHeight();
+            Cells& cells = row.cells();
+            if (cells.size() == 0 && height < 0) {
+                return;
+            }
+            ushort firstCell = 0;
+            ushort lastCell = (ushort)-1;
+            if (cells.size() > 0) {
+                firstCell = (ushort)cells.first().index();
+                lastCell = (ushort)cells.last().index();
+            }
+            // ROW 0x0208
+            // Offset   Size    Contents
+            // 0        2       Index of this row
+            // 2        2       Index to column of the first cell
+            // 4        2       Index to column of the last cell + 1
+            // 6        2       Bit     Mask    Contents
+            //                  14-0    7FFFH   Height of the row, in twips
+            //                                  (= 1/20 of a point)
+            //                  15      8000H   0 = Row has custom height;
+            //                                  1 = Row has default height
+            // 8        2       Not used
+            // 10       2       Not used
+            // 12       4       Option flags and default row formatting:
+            //                  0x00000100 works just fine. 0x04 should be
+            //                  added to apply custom height
+            byte ROW[] = {
+                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+                0x06, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00};
+            write2bytes((ushort)index, ROW);
+            write2bytes(firstCell, ROW + 2);
+            write2bytes(lastCell + 1, ROW + 4);
+            if (height >= 0) {
+                write2bytes(((ushort)(height * 20)) & 0x7FFF, ROW + 6);
+                write4bytes(0x00000140, ROW + 12);
+            }
+            writeRecord(0x0208, sizeof(ROW), ROW, out);
+            // now the cells should go
+            current = (ushort)index;
+            walker.forEachCell(index, row, *this);
+        }
+
+        void cell(int column, Cell& cell) {
+            if (cell.getType() != Cell::NONE) {
+                writeCell(cell, (ushort)column, current, out);
+            }
+        }
+
+    private:
+        /** The walker of the table */
+        TableWalker& walker;
+
+        /** The workbook stream to write to */
+        CompoundFileWriter& out;
+
+        /** The index of the row being written */
+        ushort current;
+};
+
 void XlsWriterImpl::write(Spreadsheet& spreadsheet, const _TCHAR* pathname) {
-    ByteArray byteArray;
-    write(spreadsheet, byteArray);
-    outputCompoundFile(byteArray, pathname);
+    IndexLimits::checkSpreadsheet(spreadsheet, IndexLimits::XLS_COLUMNS,
+                                  IndexLimits::XLS_ROWS);
+    CompoundFileWriter out(pathname, "Workbook");
+    write(spreadsheet, out);
+    out.close();
+}
+
+void XlsWriterImpl::write(Spreadsheet& spreadsheet, OutputSink& sink) {
+    IndexLimits::checkSpreadsheet(spreadsheet, IndexLimits::XLS_COLUMNS,
+                                  IndexLimits::XLS_ROWS);
+    CompoundFileWriter out(sink, "Workbook");
+    write(spreadsheet, out);
+    out.close();
 }
 
-void XlsWriterImpl::write(Spreadsheet& sp, ByteArray& out) {
+void XlsWriterImpl::write(Spreadsheet& sp, CompoundFileWriter& out) {
     // BOF 0x0809
     byte BOF[] = {
         0x00, 0x06, 0x05, 0x00, 0xF2, 0x15, 0xCC, 0x07,
@@ -44,33 +120,21 @@ void XlsWriterImpl::write(Spreadsheet& sp, ByteArray& out) {
     // EOF
     writeRecord(0x000A, 0, 0, out);
     // write each table as a sheet stream
+    std::vector<int> sheetOffsets;
     for (int i = 0; i < sp.tableCount(); i++) {
-        // fill reference to this sheet first
-        write4bytes(out.size(), out.data() + sheetRefOffsets[i]);
+        sheetOffsets.push_back(out.size());
         Table& table = sp.table(i);
         writeTable(table, out);
     }
-}
-
-void XlsWriterImpl::outputCompoundFile(const ByteArray& contents,
-                                       const _TCHAR* pathname) {
-    const char* data = (const char*)contents.data();
-    int size = contents.size();
-    YCompoundFiles::CompoundFile file;
-    if (!file.Create(pathname)) {
-        throw IOException(_T("error creating compound file"));
-    }
-    file.MakeFile(_T("Workbook"));
-    if (file.WriteFile(_T("Workbook"), (const char*)data, size)
-            != YCompoundFiles::CompoundFile::SUCCESS) {
-        throw IOException(_T("error writing workbook stream"));
-    }
-    if (!file.Close()) {
-        throw IOException(_T("error closing compound file"));
+    // fill references to the sheets
+    for (int i = 0; i < sp.tableCount(); i++) {
+        byte offset[4];
+        write4bytes(sheetOffsets[i], offset);
+        out.patch(sheetRefOffsets[i], offset, sizeof(offset));
     }
 }
 
-void XlsWriterImpl::writeXFs(ByteArray& out) {
+void XlsWriterImpl::writeXFs(CompoundFileWriter& out) {
     // XF 0x00E0
     // Offset   Size    Contents
     // 0        2       Index to FONT record
@@ -151,7 +215,7 @@ XlsWriterImpl::ushort XlsWriterImpl::xfIndex(Cell& cell) {
     return (ushort)(i * 3 * 6 + j * 3 + k + 16);
 }
 
-int XlsWriterImpl::writeBoundsheet(const _TCHAR* sheetName, ByteArray& out) {
+int XlsWriterImpl::writeBoundsheet(const _TCHAR* sheetName, CompoundFileWriter& out) {
     // BOUNDSHEET 0x0085
     // Offset   Size    Contents
     // 0        4       Sheet's BOF stream position, 0 is OK
@@ -171,7 +235,7 @@ int XlsWriterImpl::writeBoundsheet(const _TCHAR* sheetName, ByteArray& out) {
     return retval;
 }
 
-void XlsWriterImpl::writeTable(Table& table, ByteArray& out) {
+void XlsWriterImpl::writeTable(Table& table, CompoundFileWriter& out) {
     // BOF 0x0809
     byte BOF[] = {
         0x00, 0x06, 0x10, 0x00, 0xF2, 0x15, 0xCC, 0x07,
@@ -179,13 +243,36 @@ void XlsWriterImpl::writeTable(Table& table, ByteArray& out) {
     writeRecord(0x0809, sizeof(BOF), BOF, out);
     // columns
     writeColumns(table, out);
+    // dimensions
+    writeDimensions(table, out);
     // rows
     writeRows(table, out);    
     // EOF
     writeRecord(0x000A, 0, 0, out);
 }
 
-void XlsWriterImpl::writeColumns(Table& table, ByteArray& out) {
+void XlsWriterImpl::writeDimensions(Table& table, CompoundFileWriter& out) {
+    const TableStatistics& stats = table.statistics();
+    // DIMENSIONS 0x0200
+    // Offset   Size    Contents
+    // 0        4       Index to first used row
+    // 4        4       Index to last used row + 1
+    // 8        2       Index to first used column
+    // 10       2       Index to last used column + 1
+    // 12       2       Not used
+    byte DIMENSIONS[] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    if (stats.getCellCount() > 0) {
+        write4bytes(table.firstRow(), DIMENSIONS);
+        write4bytes(table.lastRow() + 1, DIMENSIONS + 4);
+        write2bytes((ushort)table.firstColumn(), DIMENSIONS + 8);
+        write2bytes((ushort)(table.lastColumn() + 1), DIMENSIONS + 10);
+    }
+    writeRecord(0x0200, sizeof(DIMENSIONS), DIMENSIONS, out);
+}
+
+void XlsWriterImpl::writeColumns(Table& table, CompoundFileWriter& out) {
     Columns::Iterator* colIt = table.columns().iterator();
     while (colIt->hasNext()) {
         Columns::Entry entry = colIt->next();
@@ -221,66 +308,14 @@ void XlsWriterImpl::writeColumns(Table& table, ByteArray& out) {
     delete colIt;
 }
 
-void XlsWriterImpl::writeRows(Table& table, ByteArray& out) {
-    Rows::Iterator* rowIt = table.rows().iterator();
-    while (rowIt->hasNext()) {
-        Rows::Entry entry = rowIt->next();
-        int row = entry.index();
-        double height = entry.object().getHeight();
-        Cells& cells = entry.object().cells();
-        if (cells.size() == 0 && height < 0) {
-            continue;
-        }
-        ushort firstCell = 0;
-        ushort lastCell = (ushort)-1;
-        if (cells.size() > 0) {
-            firstCell = (ushort)cells.first().index();
-            lastCell = (ushort)cells.last().index();
-        }
-        // ROW 0x0208
-        // Offset   Size    Contents
-        // 0        2       Index of this row
-        // 2        2       Index to column of the first cell
-        // 4        2       Index to column of the last cell + 1
-        // 6        2       Bit     Mask    Contents
-        //                  14-0    7FFFH   Height of the row, in twips
-        //                                  (= 1/20 of a point)
-        //                  15      8000H   0 = Row has custom height;
-        //                                  1 = Row has default height
-        // 8        2       Not used
-        // 10       2       Not used
-        // 12       4       Option flags and default row formatting:
-        //                  0x00000100 works just fine. 0x04 should be
-        //                  added to apply custom height
-        byte ROW[] = {
-            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
-            0x06, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00};
-        write2bytes((ushort)row, ROW);
-        write2bytes(firstCell, ROW + 2);
-        write2bytes(lastCell + 1, ROW + 4);
-        if (height >= 0) {
-            write2bytes(((ushort)(height * 20)) & 0x7FFF, ROW + 6);
-            write4bytes(0x00000140, ROW + 12);
-        }
-        writeRecord(0x0208, sizeof(ROW), ROW, out);
-        // now the cells should go
-        Cells::Iterator* cellIt = cells.iterator();
-        while (cellIt->hasNext()) {
-            Cells::Entry entry = cellIt->next();
-            int col = entry.index();
-            Cell& cell = entry.object();
-            if (cell.getType() == Cell::NONE) {
-                continue;
-            }
-            writeCell(cell, (ushort)col, (ushort)row, out);
-        }
-        delete cellIt;
-    }
-    delete rowIt;
+void XlsWriterImpl::writeRows(Table& table, CompoundFileWriter& out) {
+    TableWalker walker(table);
+    RowWriter writer(walker, out);
+    walker.forEachRow(writer);
 }
 
 void XlsWriterImpl::writeCell(Cell& cell, ushort col, ushort row,
-                              ByteArray& out) {
+                              CompoundFileWriter& out) {
     if (cell.getType() == Cell::TEXT) {
         // LABEL 0x0204
         // Offset   Size    Contents
@@ -368,6 +403,7 @@ void XlsWriterImpl::writeCell(Cell& cell, ushort col, ushort row,
         // 14       2       Option flags: 0x0002 = Calculate on open
         // 16       4       Not used
         // 20       var     Formula data (RPN token array)
+        // the ranges have been checked against the grid by write()
         int c1, r1, c2, r2;
         Formulas::parse(cell.getFormula(), c1, r1, c2, r2);
         byte FORMULA[] = {
@@ -391,17 +427,17 @@ void XlsWriterImpl::writeCell(Cell& cell, ushort col, ushort row,
 }
 
 void XlsWriterImpl::writeRecord(ushort id, ushort len, const byte* data,
-                                ByteArray& out) {
+                                CompoundFileWriter& out) {
     writeRecordHeader(id, len, out);
     out.write(data, len);
 }
 
-void XlsWriterImpl::writeRecordHeader(ushort id, ushort len, ByteArray& out) {
+void XlsWriterImpl::writeRecordHeader(ushort id, ushort len, CompoundFileWriter& out) {
     write2bytes(id, out);
     write2bytes(len, out);
 }
 
-void XlsWriterImpl::write2bytes(ushort value, ByteArray& out) {
+void XlsWriterImpl::write2bytes(ushort value, CompoundFileWriter& out) {
     out.write((byte)(value & 0xFF));
     out.write((byte)((value >> 8) & 0xFF));
 }
@@ -411,7 +447,7 @@ void XlsWriterImpl::write2bytes(ushort value, byte* out) {
     out[1] = (byte)((value >> 8) & 0xFF);
 }
 
-void XlsWriterImpl::write4bytes(ulong value, ByteArray& out) {
+void XlsWriterImpl::write4bytes(ulong value, CompoundFileWriter& out) {
     out.write((byte)(value & 0xFF));
     out.write((byte)((value >> 8) & 0xFF));
     out.write((byte)((value >> 16) & 0xFF));
@@ -425,7 +461,7 @@ void XlsWriterImpl::write4bytes(ulong value, byte* out) {
     out[3] = (byte)((value >> 24) & 0xFF);
 }
 
-void XlsWriterImpl::writeDouble(double value, ByteArray& out) {
+void XlsWriterImpl::writeDouble(double value, CompoundFileWriter& out) {
     out.write((byte*)&value, 8);
 }
 
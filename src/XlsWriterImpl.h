@@ -19,6 +19,9 @@ class XlsWriterImpl {
         /** Writes a spreadsheet to a file in xls format. */
         static void write(Spreadsheet& sp, const _TCHAR* pathname);
 
+        /** Writes a spreadsheet to a sink in xls format. */
+        static void write(Spreadsheet& sp, OutputSink& sink);
+
     private:
         /** The type represents a byte */
         typedef unsigned char byte;
@@ -31,19 +34,12 @@ class XlsWriterImpl {
 
         /**
          * Generates byte representation of a spreadsheet in Excel 97/2000
-         * format.
-         */
-        static void write(Spreadsheet& sp, class ByteArray& out);
-
-        /**
-         * Outputs a byte array as an Excel workbook into an OLE compound
-         * file.
+         * format into the workbook stream of a compound file.
          */
-        static void outputCompoundFile(const ByteArray& contents,
-            const _TCHAR* pathname);
+        static void write(Spreadsheet& sp, class CompoundFileWriter& out);
 
         /** Generates necessary XF records. */
-        static void writeXFs(ByteArray& out);
+        static void writeXFs(CompoundFileWriter& out);
 
         /**
          * Determines the index to an XF record for a given cell. This is
@@ -52,42 +48,48 @@ class XlsWriterImpl {
         static ushort xfIndex(Cell& cell);
 
         /** Generates a BOUNDSHEET record for a sheet. */
-        static int writeBoundsheet(const _TCHAR* sheetName, ByteArray& out);
+        static int writeBoundsheet(const _TCHAR* sheetName, CompoundFileWriter& out);
 
         /** Generates byte representation of a table (worksheet) */
-        static void writeTable(Table& table, ByteArray& out);
+        static void writeTable(Table& table, CompoundFileWriter& out);
 
         /** Generates byte representation of table columns */
-        static void writeColumns(Table& table, ByteArray& out);
+        static void writeColumns(Table& table, CompoundFileWriter& out);
+
+        /** Generates the DIMENSIONS record of a table. */
+        static void writeDimensions(Table& table, CompoundFileWriter& out);
         
         /** Generates byte representation of table rows */
-        static void writeRows(Table& table, ByteArray& out);
+        static void writeRows(Table& table, CompoundFileWriter& out);
         
         /** Generates byte representation of a cell */
         static void writeCell(Cell& cell, ushort col, ushort row,
-            ByteArray& out);
+            CompoundFileWriter& out);
+
+        /** Visitor that generates byte representation of table rows */
+        class RowWriter;
 
-        /** Writes a BIFF record to a byte array. */
+        /** Writes a BIFF record to the workbook stream. */
         static void writeRecord(ushort id, ushort len, const byte* data,
-            ByteArray& out);
+            CompoundFileWriter& out);
 
         /** Writes a BIFF record header without the actual record */
-        static void writeRecordHeader(ushort id, ushort len, ByteArray& out);
+        static void writeRecordHeader(ushort id, ushort len, CompoundFileWriter& out);
 
-        /** Adds two bytes to a byte array */
-        static void write2bytes(ushort value, ByteArray& out);
+        /** Adds two bytes to the workbook stream */
+        static void write2bytes(ushort value, CompoundFileWriter& out);
 
         /** Writes two bytes at a specified location */
         static void write2bytes(ushort value, byte* out);
 
-        /** Adds four bytes to a byte array */
-        static void write4bytes(ulong value, ByteArray& out);
+        /** Adds four bytes to the workbook stream */
+        static void write4bytes(ulong value, CompoundFileWriter& out);
 
         /** Writes four bytes at a specified location */
         static void write4bytes(ulong value, byte* out);
 
-        /** Adds a double value to a byte array */
-        static void writeDouble(double value, ByteArray& out);
+        /** Adds a double value to the workbook stream */
+        static void writeDouble(double value, CompoundFileWriter& out);
 };
 
 }
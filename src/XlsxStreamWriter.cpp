@@ -0,0 +1,66 @@
+// File: XlsxStreamWriter.cpp
+// XlsxStreamWriter implementation file
+//
+
+#include "splib.h"
+#include "XlsxStreamWriterImpl.h"
+#include "splibint.h"
+
+namespace splib {
+
+XlsxStreamWriter::XlsxStreamWriter(const _TCHAR* pathname) {
+    impl = new XlsxStreamWriterImpl(pathname);
+}
+
+XlsxStreamWriter::XlsxStreamWriter(OutputSink& sink) {
+    impl = new XlsxStreamWriterImpl(sink);
+}
+
+XlsxStreamWriter::~XlsxStreamWriter() {
+    if (!impl->isClosed()) {
+        try {
+            impl->close();
+        } catch (Exception&) {
+        }
+    }
+    delete impl;
+}
+
+void XlsxStreamWriter::setCompression(const CompressionOptions& compression) {
+    impl->setCompression(compression);
+}
+
+void XlsxStreamWriter::setSharedStrings(bool sharedStrings) {
+    impl->setSharedStrings(sharedStrings);
+}
+
+void XlsxStreamWriter::setCompact(bool compact) {
+    impl->setCompact(compact);
+}
+
+void XlsxStreamWriter::beginSheet(const _TCHAR* name) {
+    impl->beginSheet(name);
+}
+
+void XlsxStreamWriter::setColumnWidth(int column, double width) {
+    impl->setColumnWidth(column, width);
+}
+
+void XlsxStreamWriter::setRowHeight(int row, double height) {
+    impl->setRowHeight(row, height);
+}
+
+void XlsxStreamWriter::writeRow(int row, int first, const CellValue* values,
+                                int count) {
+    impl->writeRow(row, first, values, count);
+}
+
+void XlsxStreamWriter::endSheet() {
+    impl->endSheet();
+}
+
+void XlsxStreamWriter::close() {
+    impl->close();
+}
+
+}
@@ -0,0 +1,72 @@
+// File: XlsxStreamWriterImpl.cpp
+// XlsxStreamWriterImpl implementation file
+//
+
+#include "XlsxStreamWriterImpl.h"
+#include "XlsxWriterImpl.h"
+#include "IndexLimits.h"
+#include "splibint.h"
+
+namespace splib {
+
+XlsxStreamWriterImpl::XlsxStreamWriterImpl(const _TCHAR* pathname)
+        : StreamWriterBase(IndexLimits::XLSX_COLUMNS, IndexLimits::XLSX_ROWS),
+          ar(pathname), xml(ar), sharedStrings(false),
+          compact(false), sheet(0, false) {
+}
+
+XlsxStreamWriterImpl::XlsxStreamWriterImpl(OutputSink& sink)
+        : StreamWriterBase(IndexLimits::XLSX_COLUMNS, IndexLimits::XLSX_ROWS),
+          ar(sink), xml(ar), sharedStrings(false),
+          compact(false), sheet(0, false) {
+}
+
+void XlsxStreamWriterImpl::setCompression(
+        const CompressionOptions& compression) {
+    ar.setCompression(compression);
+}
+
+void XlsxStreamWriterImpl::setSharedStrings(bool sharedStrings) {
+    this->sharedStrings = sharedStrings;
+}
+
+void XlsxStreamWriterImpl::setCompact(bool compact) {
+    this->compact = compact;
+}
+
+void XlsxStreamWriterImpl::openSheet(int index, const _TCHAR* name,
+                                     const Widths& widths) {
+    sheet = XlsxWriterImpl::SheetState(0, compact);
+    XlsxWriterImpl::openSheet(index + 1, sheet, xml);
+    XlsxWriterImpl::writeColumns(widths, sheet, xml);
+}
+
+void XlsxStreamWriterImpl::outputRow(int row, double height, int first,
+                                     const CellValue* values, int count) {
+    sheet.strings = sharedStrings ? &strings : 0;
+    XlsxWriterImpl::writeRowStart(row, height, count > 0 ? first : -1,
+                                  first + count - 1, sheet, xml);
+    for (int i = 0; i < count; i++) {
+        int xf = XlsxWriterImpl::xfIndex(values[i].getType(),
+                                         Cell::HADEFAULT, Cell::VADEFAULT);
+        XlsxWriterImpl::writeValue(values[i], xf, first + i, row, sheet,
+                                   xml);
+    }
+    XlsxWriterImpl::writeRowEnd(sheet, xml);
+}
+
+void XlsxStreamWriterImpl::closeSheet() {
+    XlsxWriterImpl::closeSheet(sheet, xml);
+}
+
+void XlsxStreamWriterImpl::closeFile(const Names& names) {
+    // the table is written if texts went into it at any time
+    bool shared = sharedStrings || strings.size() > 0;
+    if (shared) {
+        XlsxWriterImpl::writeSharedStrings(strings, xml);
+    }
+    XlsxWriterImpl::writeWorkbookParts(names, shared, xml);
+    ar.close();
+}
+
+}
@@ -0,0 +1,88 @@
+// File: XlsxStreamWriterImpl.h
+// XlsxStreamWriterImpl declaration file
+//
+
+#ifndef XLSXSTREAMWRITERIMPL_H
+#define XLSXSTREAMWRITERIMPL_H
+
+#include "splib.h"
+#include "StreamWriterBase.h"
+#include "ZipArchive.h"
+#include "XmlWriter.h"
+#include "SharedStrings.h"
+#include "XlsxWriterImpl.h"
+
+namespace splib {
+
+/**
+ * The implementation of <code>XlsxStreamWriter</code>. The sheets are
+ * written to the package as they arrive, and the parts that list them,
+ * such as the workbook and the content types, when the writer is closed.
+ */
+class XlsxStreamWriterImpl : public StreamWriterBase {
+    public:
+        /**
+         * Creates a new instance of <code>XlsxStreamWriterImpl</code>.
+         * @param pathname a pointer to the path name of the file to write
+         */
+        XlsxStreamWriterImpl(const _TCHAR* pathname);
+
+        /**
+         * Creates a new instance of <code>XlsxStreamWriterImpl</code>.
+         * @param sink the sink to write the file to
+         */
+        XlsxStreamWriterImpl(OutputSink& sink);
+
+        /** Sets the compression of the entries opened from now on. */
+        void setCompression(const CompressionOptions& compression);
+
+        /**
+         * Sets whether the texts of the rows written from now on go into
+         * the shared string table.
+         */
+        void setSharedStrings(bool sharedStrings);
+
+        /**
+         * Sets whether the sheets begun from now on are written in the
+         * compact encoding.
+         */
+        void setCompact(bool compact);
+
+    protected:
+        // inherit doc
+        virtual void openSheet(int index, const _TCHAR* name,
+                               const Widths& widths);
+
+        // inherit doc
+        virtual void outputRow(int row, double height, int first,
+                               const CellValue* values, int count);
+
+        // inherit doc
+        virtual void closeSheet();
+
+        // inherit doc
+        virtual void closeFile(const Names& names);
+
+    private:
+        /** The package */
+        ZipArchive ar;
+
+        /** The writer of the entries of the package */
+        XmlWriter xml;
+
+        /** The shared string table */
+        SharedStrings strings;
+
+        /** Indicates whether texts go into the shared string table */
+        bool sharedStrings;
+
+        /** Indicates whether the sheets begun are in the compact encoding */
+        bool compact;
+
+        /** The state of the current sheet */
+        XlsxWriterImpl::SheetState sheet;
+};
+
+}
+
+#endif // XLSXSTREAMWRITERIMPL_H
@@ -4,12 +4,59 @@
 
 #include "splib.h"
 #include "XlsxWriterImpl.h"
+#include "Thread.h"
 #include "splibint.h"
 
 namespace splib {
 
+XlsxWriter::XlsxWriter() : threads(1), sharedStrings(false), compact(false) {
+}
+
+void XlsxWriter::setThreads(int threads) {
+    if (threads < 0) {
+        throw IllegalArgumentException();
+    }
+    this->threads = threads;
+}
+
+int XlsxWriter::getThreads() const {
+    return threads;
+}
+
+void XlsxWriter::setCompression(const CompressionOptions& compression) {
+    this->compression = compression;
+}
+
+const CompressionOptions& XlsxWriter::getCompression() const {
+    return compression;
+}
+
+void XlsxWriter::setSharedStrings(bool sharedStrings) {
+    this->sharedStrings = sharedStrings;
+}
+
+bool XlsxWriter::getSharedStrings() const {
+    return sharedStrings;
+}
+
+void XlsxWriter::setCompact(bool compact) {
+    this->compact = compact;
+}
+
+bool XlsxWriter::getCompact() const {
+    return compact;
+}
+
 void XlsxWriter::write(Spreadsheet& sp, const _TCHAR* pathname) {
-    XlsxWriterImpl::write(sp, pathname);
+    int n = threads > 0 ? threads : Thread::processors();
+    XlsxWriterImpl::write(sp, pathname, n, compression, sharedStrings,
+                          compact);
+}
+
+void XlsxWriter::write(Spreadsheet& sp, OutputSink& sink) {
+    int n = threads > 0 ? threads : Thread::processors();
+    XlsxWriterImpl::write(sp, sink, n, compression, sharedStrings,
+                          compact);
 }
 
 }
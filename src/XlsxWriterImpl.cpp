@@ -5,34 +5,283 @@
 #include "splib.h"
 #include "XlsxWriterImpl.h"
 #include "ZipArchive.h"
-#include "ToUTF8.h"
-#include "Strings.h"
+#include "XmlWriter.h"
+#include "SharedStrings.h"
 #include <sstream>
 #include "ExcelUtil.h"
 #include "Util.h"
+#include "TableWalker.h"
+#include "IndexLimits.h"
+#include "AtomicCounter.h"
+#include "Thread.h"
+#include <new>
 #include "splibint.h"
 
 namespace splib {
 
-void XlsxWriterImpl::write(Spreadsheet& sp, const _TCHAR* pathname) {
+class XlsxWriterImpl::RowWriter {
+    public:
+        RowWriter(TableWalker& walker, int first, int last,
+                  SheetState& sheet, XmlWriter& xml)
+            : walker(walker), first(first), last(last), sheet(sheet),
+              xml(xml), current(-1) {}
+
+        void row(int index, Row& row) {
+            writeRowStart(index, row.getHeight(), first, last, sheet, xml);
+            current = index;
+            walker.forEachCell(index, row, *this);
+            writeRowEnd(sheet, xml);
+        }
+
+        void cell(int column, Cell& cell) {
+            if (cell.getType() != Cell::NONE) {
+                writeCell(cell, column, current, sheet, xml);
+            }
+        }
+
+    private:
+        /** The walker of the sheet */
+        TableWalker& walker;
+
+        /** The first column of the spans hint of the rows, or -1 */
+        int first;
+
+        /** The last column of the spans hint of the rows */
+        int last;
+
+        /** The state of the sheet */
+        SheetState& sheet;
+
+        /** The archive to write to */
+        XmlWriter& xml;
+
+        /** The index of the row being written */
+        int current;
+};
+
+class XlsxWriterImpl::StringCollector {
+    public:
+        StringCollector(TableWalker& walker, SharedStrings& strings)
+            : walker(walker), strings(strings) {}
+
+        void row(int index, Row& row) {
+            walker.forEachCell(index, row, *this);
+        }
+
+        void cell(int column, Cell& cell) {
+            if (cell.getType() == Cell::TEXT) {
+                strings.add(cell.getText());
+            }
+        }
+
+    private:
+        /** The walker of the sheet */
+        TableWalker& walker;
+
+        /** The table to add the texts to */
+        SharedStrings& strings;
+};
+
+class XlsxWriterImpl::SheetWriter : public Thread::Runnable {
+    public:
+        SheetWriter(Spreadsheet& sp, const CompressionOptions& compression,
+                    SharedStrings* strings, bool compact)
+            : sp(sp), strings(strings), compact(compact),
+              sheets(sp.tableCount()),
+              failures(sp.tableCount(), NONE), messages(sp.tableCount()) {
+            for (int i = 0; i < (int)sheets.size(); i++) {
+                sheets[i] = new ZipArchive();
+                sheets[i]->setCompression(compression);
+            }
+        }
+
+        virtual ~SheetWriter() {
+            for (int i = 0; i < (int)sheets.size(); i++) {
+                delete sheets[i];
+            }
+        }
+
+        virtual void run() {
+            int count = (int)sheets.size();
+            for (int i = (int)next.next(); i < count; i = (int)next.next()) {
+                try {
+                    XmlWriter xml(*sheets[i]);
+                    writeSheet(sp.table(i), i + 1, strings, compact, xml);
+                } catch (IllegalArgumentException& e) {
+                    fail(i, ILLEGAL_ARGUMENT, e.message());
+                } catch (IllegalStateException& e) {
+                    fail(i, ILLEGAL_STATE, e.message());
+                } catch (IOException& e) {
+                    fail(i, IO, e.message());
+                } catch (std::bad_alloc&) {
+                    fail(i, OUT_OF_MEMORY, _T(""));
+                } catch (...) {
+                    fail(i, IO, _T("error writing sheet"));
+                }
+            }
+        }
+
+        /**
+         * Stores the sheets into a package in order, or throws the error
+         * of the first sheet that failed.
+         */
+        void writeEntries(ZipArchive& ar) {
+            for (int i = 0; i < (int)sheets.size(); i++) {
+                const _TCHAR* message = messages[i].c_str();
+                switch (failures[i]) {
+                    case NONE:
+                        break;
+                    case ILLEGAL_ARGUMENT:
+                        throw IllegalArgumentException(message);
+                    case ILLEGAL_STATE:
+                        throw IllegalStateException(message);
+                    case IO:
+                        throw IOException(message);
+                    case OUT_OF_MEMORY:
+                        throw std::bad_alloc();
+                }
+            }
+            for (int i = 0; i < (int)sheets.size(); i++) {
+                ar.writeEntries(*sheets[i]);
+                delete sheets[i];
+                sheets[i] = 0;
+            }
+        }
+
+    private:
+        /** The kinds of errors */
+        enum Failure {NONE, ILLEGAL_ARGUMENT, ILLEGAL_STATE, IO, OUT_OF_MEMORY};
+
+        /** Records the error of a sheet. */
+        void fail(int sheet, Failure failure, const _TCHAR* message) {
+            failures[sheet] = failure;
+            messages[sheet] = message;
+        }
+
+    private:
+        /** The spreadsheet */
+        Spreadsheet& sp;
+
+        /** The sealed shared string table, or 0 */
+        SharedStrings* strings;
+
+        /** Indicates whether the sheets are written in the compact encoding */
+        bool compact;
+
+        /** The archives that the sheets are written to, by sheet */
+        std::vector<ZipArchive*> sheets;
+
+        /** The errors, by sheet */
+        std::vector<Failure> failures;
+
+        /** The messages of the errors, by sheet */
+        std::vector<std::basic_string<_TCHAR> > messages;
+
+        /** The index of the next sheet to write */
+        AtomicCounter next;
+};
+
+void XlsxWriterImpl::write(Spreadsheet& sp, const _TCHAR* pathname,
+                           int threads,
+                           const CompressionOptions& compression,
+                           bool sharedStrings, bool compact) {
+    IndexLimits::checkSpreadsheet(sp, IndexLimits::XLSX_COLUMNS,
+                                  IndexLimits::XLSX_ROWS);
     ZipArchive ar(pathname);
-    writeContentTypes(sp, ar);
-    writeRels(ar);
-    writeAppDocProps(sp, ar);
-    writeCoreDocProps(ar);
-    writeStyles(ar);
-    writeWorkbookRels(sp, ar);
-    writeWorkbook(sp, ar);
-    writeTheme(ar);
+    ar.setCompression(compression);
+    writePackage(sp, threads, sharedStrings, compact, ar);
+}
+
+void XlsxWriterImpl::write(Spreadsheet& sp, OutputSink& sink, int threads,
+                           const CompressionOptions& compression,
+                           bool sharedStrings, bool compact) {
+    IndexLimits::checkSpreadsheet(sp, IndexLimits::XLSX_COLUMNS,
+                                  IndexLimits::XLSX_ROWS);
+    ZipArchive ar(sink);
+    ar.setCompression(compression);
+    writePackage(sp, threads, sharedStrings, compact, ar);
+}
+
+void XlsxWriterImpl::writePackage(Spreadsheet& sp, int threads,
+                                  bool sharedStrings, bool compact,
+                                  ZipArchive& ar) {
+    Names names;
     for (int i = 0; i < sp.tableCount(); i++) {
-        writeSheet(sp.table(i), i + 1, ar);
+        names.push_back(sp.table(i).getName());
+    }
+    XmlWriter xml(ar);
+    writeWorkbookParts(names, sharedStrings, xml);
+    SharedStrings table;
+    SharedStrings* strings = sharedStrings ? &table : 0;
+    if (threads > 1 && sp.tableCount() > 1) {
+        if (strings != 0) {
+            // the threads only look up the texts, so the table is built
+            // first, with the indexes that writing in order would give
+            collectStrings(sp, table);
+            table.seal();
+        }
+        writeSheets(sp, threads, strings, compact, ar);
+    } else {
+        // a single sheet is compressed in blocks by the threads instead
+        ar.setThreads(threads);
+        for (int i = 0; i < sp.tableCount(); i++) {
+            writeSheet(sp.table(i), i + 1, strings, compact, xml);
+        }
+    }
+    if (strings != 0) {
+        writeSharedStrings(table, xml);
     }
     ar.close();
 }
 
-void XlsxWriterImpl::writeContentTypes(Spreadsheet& sp, ZipArchive& ar) {
-    ar.openEntry("[Content_Types].xml");
-    ar <<
+void XlsxWriterImpl::writeSheets(Spreadsheet& sp, int threads,
+                                 SharedStrings* strings, bool compact,
+                                 ZipArchive& ar) {
+    if (threads > sp.tableCount()) {
+        threads = sp.tableCount();
+    }
+    SheetWriter writer(sp, ar.getCompression(), strings, compact);
+    std::vector<Thread*> workers;
+    workers.reserve(threads - 1);
+    try {
+        for (int i = 1; i < threads; i++) {
+            workers.push_back(new Thread(writer));
+        }
+    } catch (...) {
+        // go on with the threads started
+    }
+    writer.run();
+    for (int i = 0; i < (int)workers.size(); i++) {
+        delete workers[i];
+    }
+    writer.writeEntries(ar);
+}
+
+void XlsxWriterImpl::collectStrings(Spreadsheet& sp, SharedStrings& strings) {
+    for (int i = 0; i < sp.tableCount(); i++) {
+        TableWalker walker(sp.table(i));
+        StringCollector collector(walker, strings);
+        walker.forEachRow(collector);
+    }
+}
+
+void XlsxWriterImpl::writeWorkbookParts(const Names& names,
+                                        bool sharedStrings, XmlWriter& xml) {
+    int sheets = (int)names.size();
+    writeContentTypes(sheets, sharedStrings, xml);
+    writeRels(xml);
+    writeAppDocProps(names, xml);
+    writeCoreDocProps(xml);
+    writeStyles(xml);
+    writeWorkbookRels(sheets, sharedStrings, xml);
+    writeWorkbook(names, xml);
+    writeTheme(xml);
+}
+
+void XlsxWriterImpl::writeContentTypes(int sheets, bool sharedStrings,
+                                       XmlWriter& xml) {
+    xml.openEntry("[Content_Types].xml");
+    xml <<
         "<\?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"\?>\r\n"
         "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">\r\n"
         "<Override PartName=\"/xl/theme/theme1.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.theme+xml\"/>\r\n"
@@ -41,31 +290,35 @@ void XlsxWriterImpl::writeContentTypes(Spreadsheet& sp, ZipArchive& ar) {
         "<Default Extension=\"xml\" ContentType=\"application/xml\"/>\r\n"
         "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>\r\n"
         "<Override PartName=\"/docProps/app.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.extended-properties+xml\"/>\r\n";
-    for (int i = 0; i < sp.tableCount(); i++) {        
-        ar <<
+    for (int i = 0; i < sheets; i++) {
+        xml <<
             "<Override PartName=\"/xl/worksheets/sheet" << i + 1 << ".xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>\r\n";
     }
-    ar <<
+    if (sharedStrings) {
+        xml <<
+            "<Override PartName=\"/xl/sharedStrings.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml\"/>\r\n";
+    }
+    xml <<
         "<Override PartName=\"/docProps/core.xml\" ContentType=\"application/vnd.openxmlformats-package.core-properties+xml\"/>\r\n"
         "</Types>\r\n";
-    ar.closeEntry();
+    xml.closeEntry();
 }
 
-void XlsxWriterImpl::writeRels(ZipArchive& ar) {
-    ar.openEntry("_rels/.rels");
-    ar <<
+void XlsxWriterImpl::writeRels(XmlWriter& xml) {
+    xml.openEntry("_rels/.rels");
+    xml <<
         "<\?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"\?>\r\n"
         "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">\r\n"
         "<Relationship Id=\"rId3\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/extended-properties\" Target=\"docProps/app.xml\"/>\r\n"
         "<Relationship Id=\"rId2\" Type=\"http://schemas.openxmlformats.org/package/2006/relationships/metadata/core-properties\" Target=\"docProps/core.xml\"/>\r\n"
         "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" Target=\"xl/workbook.xml\"/>\r\n"
         "</Relationships>\r\n";
-    ar.closeEntry();
+    xml.closeEntry();
 }
 
-void XlsxWriterImpl::writeAppDocProps(Spreadsheet& sp, ZipArchive& ar) {
-    ar.openEntry("docProps/app.xml");
-    ar <<
+void XlsxWriterImpl::writeAppDocProps(const Names& names, XmlWriter& xml) {
+    xml.openEntry("docProps/app.xml");
+    xml <<
         "<\?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"\?>\r\n"
         "<Properties xmlns=\"http://schemas.openxmlformats.org/officeDocument/2006/extended-properties\" xmlns:vt=\"http://schemas.openxmlformats.org/officeDocument/2006/docPropsVTypes\">\r\n"
         "<Application>Microsoft Excel</Application>\r\n"
@@ -77,17 +330,18 @@ void XlsxWriterImpl::writeAppDocProps(Spreadsheet& sp, ZipArchive& ar) {
         "<vt:lpstr>Worksheets</vt:lpstr>\r\n"
         "</vt:variant>\r\n"
         "<vt:variant>\r\n"
-        "<vt:i4>" << sp.tableCount() << "</vt:i4>\r\n"
+        "<vt:i4>" << (int)names.size() << "</vt:i4>\r\n"
         "</vt:variant>\r\n"
         "</vt:vector>\r\n"
         "</HeadingPairs>\r\n"
         "<TitlesOfParts>\r\n"
-        "<vt:vector size=\"" << sp.tableCount() << "\" baseType=\"lpstr\">\r\n";
-    for (int i = 0; i < sp.tableCount(); i++) {
-        ToUTF8 utf8(Strings::xmlize(sp.table(i).getName()).c_str());
-        ar << "<vt:lpstr>" << utf8.get() << "</vt:lpstr>\r\n";
+        "<vt:vector size=\"" << (int)names.size() << "\" baseType=\"lpstr\">\r\n";
+    for (int i = 0; i < (int)names.size(); i++) {
+        xml << "<vt:lpstr>";
+        xml.writeText(names[i].c_str());
+        xml << "</vt:lpstr>\r\n";
     }
-    ar <<
+    xml <<
         "</vt:vector>\r\n"
         "</TitlesOfParts>\r\n"
         "<Company>N/A</Company>\r\n"
@@ -96,21 +350,21 @@ void XlsxWriterImpl::writeAppDocProps(Spreadsheet& sp, ZipArchive& ar) {
         "<HyperlinksChanged>false</HyperlinksChanged>\r\n"
         "<AppVersion>12.0000</AppVersion>\r\n"
         "</Properties>\r\n";
-    ar.closeEntry();
+    xml.closeEntry();
 }
 
-void XlsxWriterImpl::writeCoreDocProps(ZipArchive& ar) {
-    ar.openEntry("docProps/core.xml");
-    ar <<
+void XlsxWriterImpl::writeCoreDocProps(XmlWriter& xml) {
+    xml.openEntry("docProps/core.xml");
+    xml <<
         "<\?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"\?>\r\n"
         "<cp:coreProperties xmlns:cp=\"http://schemas.openxmlformats.org/package/2006/metadata/core-properties\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\" xmlns:dcterms=\"http://purl.org/dc/terms/\" xmlns:dcmitype=\"http://purl.org/dc/dcmitype/\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\">\r\n"
         "</cp:coreProperties>\r\n";
-    ar.closeEntry();
+    xml.closeEntry();
 }
 
-void XlsxWriterImpl::writeStyles(ZipArchive& ar) {
-    ar.openEntry("xl/styles.xml"); 
-    ar <<
+void XlsxWriterImpl::writeStyles(XmlWriter& xml) {
+    xml.openEntry("xl/styles.xml"); 
+    xml <<
         "<\?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"\?>\r\n"
         "<styleSheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/5/main\">\r\n"
         "<fonts count=\"1\">\r\n"
@@ -144,8 +398,8 @@ void XlsxWriterImpl::writeStyles(ZipArchive& ar) {
         "<xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/>\r\n"
         "</cellStyleXfs>\r\n"
         "<cellXfs>\r\n";
-    writeXFs(ar);
-    ar <<
+    writeXFs(xml);
+    xml <<
         "</cellXfs>\r\n"
         "<cellStyles count=\"1\">\r\n"
         "<cellStyle name=\"Normal\" xfId=\"0\" builtinId=\"0\"/>\r\n"
@@ -154,10 +408,10 @@ void XlsxWriterImpl::writeStyles(ZipArchive& ar) {
         "<tableStyles count=\"0\" defaultTableStyle=\"TableStyleMedium9\" defaultPivotStyle=\"PivotStyleLight16\"/>\r\n"
         "<colors/>\r\n"
         "</styleSheet>\r\n";
-    ar.closeEntry();
+    xml.closeEntry();
 }
 
-void XlsxWriterImpl::writeXFs(ZipArchive& ar) {
+void XlsxWriterImpl::writeXFs(XmlWriter& xml) {
     const int NUM_FMT_GENERAL = 0;
     const int NUM_FMT_DATE = 14;
     const int NUM_FMT_TIME = 21;
@@ -179,9 +433,9 @@ void XlsxWriterImpl::writeXFs(ZipArchive& ar) {
                 if (hAlign != Cell::HADEFAULT || vAlign != Cell::BOTTOM) {
                     applyAlignment = " applyAlignment=\"1\"";
                 }
-                ar << "<xf numFmtId=\"" << numFmt
-                   << "\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\""
-                   << applyNumFmt << applyAlignment << ">\r\n";
+                xml << "<xf numFmtId=\"" << numFmt
+                    << "\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\""
+                    << applyNumFmt << applyAlignment << ">\r\n";
                 if (hAlign != Cell::HADEFAULT || vAlign != Cell::BOTTOM) {
                     const char* horz = "";
                     const char* vert = "";
@@ -210,22 +464,23 @@ void XlsxWriterImpl::writeXFs(ZipArchive& ar) {
                             vert = " vertical=\"center\"";
                             break;
                     }
-                    ar << "<alignment" << horz << vert << "/>\r\n";
+                    xml << "<alignment" << horz << vert << "/>\r\n";
                 }
-                ar << "</xf>\r\n";
+                xml << "</xf>\r\n";
             }
         }
     }
 }
 
-int XlsxWriterImpl::xfIndex(Cell& cell) {
+int XlsxWriterImpl::xfIndex(Cell::Type type, Cell::HAlignment hAlignment,
+                            Cell::VAlignment vAlignment) {
     int i = 0;
-    switch (cell.getType()) {
+    switch (type) {
         case Cell::DATE:        i = 1; break;
         case Cell::TIME:        i = 2; break;
     }
     int j = 0;
-    switch (cell.getHAlignment()) {
+    switch (hAlignment) {
         case Cell::LEFT:        j = 1; break;
         case Cell::CENTER:      j = 2; break;
         case Cell::RIGHT:       j = 3; break;
@@ -233,34 +488,39 @@ int XlsxWriterImpl::xfIndex(Cell& cell) {
         case Cell::FILLED:      j = 5; break;
     }
     int k = 0;
-    switch (cell.getVAlignment()) {
+    switch (vAlignment) {
         case Cell::TOP:         k = 1; break;
         case Cell::MIDDLE:      k = 2; break;
     }
     return i * 3 * 6 + j * 3 + k;
 }
 
-void XlsxWriterImpl::writeWorkbookRels(Spreadsheet& sp, ZipArchive& ar) {
-    ar.openEntry("xl/_rels/workbook.xml.rels");
-    ar <<
+void XlsxWriterImpl::writeWorkbookRels(int sheets, bool sharedStrings,
+                                       XmlWriter& xml) {
+    xml.openEntry("xl/_rels/workbook.xml.rels");
+    xml <<
         "<\?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"\?>\r\n"
         "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">\r\n";
     int i;
-    for (i = 0; i < sp.tableCount(); i++) {
-        ar <<
+    for (i = 0; i < sheets; i++) {
+        xml <<
             "<Relationship Id=\"rId" << i + 1 << "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" "
             "Target=\"worksheets/sheet" << i + 1 << ".xml\"/>\r\n";
     }
-    ar <<
+    xml <<
         "<Relationship Id=\"rId" << i + 1 << "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/theme\" Target=\"theme/theme1.xml\"/>\r\n"
-        "<Relationship Id=\"rId" << i + 2 << "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles\" Target=\"styles.xml\"/>\r\n"
-        "</Relationships>\r\n";
-    ar.closeEntry();
+        "<Relationship Id=\"rId" << i + 2 << "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles\" Target=\"styles.xml\"/>\r\n";
+    if (sharedStrings) {
+        xml <<
+            "<Relationship Id=\"rId" << i + 3 << "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings\" Target=\"sharedStrings.xml\"/>\r\n";
+    }
+    xml << "</Relationships>\r\n";
+    xml.closeEntry();
 }
 
-void XlsxWriterImpl::writeWorkbook(Spreadsheet& sp, ZipArchive& ar) {
-    ar.openEntry("xl/workbook.xml"); 
-    ar <<
+void XlsxWriterImpl::writeWorkbook(const Names& names, XmlWriter& xml) {
+    xml.openEntry("xl/workbook.xml"); 
+    xml <<
         "<\?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"\?>\r\n"
         "<workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/5/main\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">\r\n"
         "<fileVersion lastEdited=\"4\" lowestEdited=\"4\" rupBuild=\"4017\"/>\r\n"
@@ -269,21 +529,21 @@ void XlsxWriterImpl::writeWorkbook(Spreadsheet& sp, ZipArchive& ar) {
         "<workbookView xWindow=\"120\" yWindow=\"45\" windowWidth=\"18975\" windowHeight=\"11955\"/>\r\n"
         "</bookViews>\r\n"
         "<sheets>\r\n";
-    for (int i = 0; i < sp.tableCount(); i++) {
-        ToUTF8 utf8(Strings::xmlize(sp.table(i).getName()).c_str());
-        ar << "<sheet name=\"" << utf8.get() << "\" sheetId=\"" << i + 1
-           << "\" r:id=\"rId" << i + 1 << "\"/>\r\n";
+    for (int i = 0; i < (int)names.size(); i++) {
+        xml << "<sheet name=\"";
+        xml.writeText(names[i].c_str());
+        xml << "\" sheetId=\"" << i + 1 << "\" r:id=\"rId" << i + 1 << "\"/>\r\n";
     }
-    ar <<
+    xml <<
         "</sheets>\r\n"
         "<calcPr calcId=\"122211\"/>\r\n"
         "</workbook>\r\n";
-    ar.closeEntry();
+    xml.closeEntry();
 }
 
-void XlsxWriterImpl::writeTheme(ZipArchive& ar) {
-    ar.openEntry("xl/theme/theme1.xml");
-    ar <<
+void XlsxWriterImpl::writeTheme(XmlWriter& xml) {
+    xml.openEntry("xl/theme/theme1.xml");
+    xml <<
         "<\?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"\?>\r\n"
         "<a:theme xmlns:a=\"http://schemas.openxmlformats.org/drawingml/2006/3/main\" name=\"Office Theme\">\r\n"
         "<a:themeElements>\r\n"
@@ -562,90 +822,182 @@ void XlsxWriterImpl::writeTheme(ZipArchive& ar) {
         "<a:objectDefaults/>\r\n"
         "<a:extraClrSchemeLst/>\r\n"
         "</a:theme>\r\n";
-    ar.closeEntry();
+    xml.closeEntry();
 }
 
-void XlsxWriterImpl::writeSheet(Table& table, int id, ZipArchive& ar) {
-    std::basic_stringstream<char> entryName;
-    entryName << "xl/worksheets/sheet" << id << ".xml";
-    ar.openEntry(entryName.str().c_str());
-    ar << "<\?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"\?>\r\n"
-          "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/5/main\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">\r\n";        
+void XlsxWriterImpl::writeSheet(Table& table, int id, SharedStrings* strings,
+                                bool compact, XmlWriter& xml) {
+    SheetState sheet(strings, compact);
+    openSheet(id, sheet, xml);
+
+    // dimension
+    int first = -1;
+    int last = -1;
+    if (table.statistics().getCellCount() > 0) {
+        first = table.firstColumn();
+        last = table.lastColumn();
+        char from[Util::LOCATION_SIZE];
+        char to[Util::LOCATION_SIZE];
+        Util::formatLocation(first, table.firstRow(), from);
+        Util::formatLocation(last, table.lastRow(), to);
+        xml << "<dimension ref=\"" << from << ":" << to << "\"/>";
+        if (!compact) {
+            xml << "\r\n";
+        }
+    }
 
     // columns
-    if (table.columns().size() > 0) {
-        ar << "<cols>\r\n";
-        Columns::Iterator* colIt = table.columns().iterator();
-        while (colIt->hasNext()) {
-            Columns::Entry entry = colIt->next();
-            int col = entry.index();
-            double width = entry.object().getWidth();
-            if (width >= 0) {
-                double w = ExcelUtil::columnWidthUnits(width);
-                ar << "<col min=\"" << col + 1 << "\" max=\"" << col + 1 << "\" width=\"" << w << "\" customWidth=\"1\"/>\r\n";
-            }
+    Widths widths;
+    const Columns& columns = table.columns();
+    for (int col = columns.next(0); col != -1; col = columns.next(col + 1)) {
+        double width = columns.find(col)->getWidth();
+        if (width >= 0) {
+            widths[col] = width;
         }
-        delete colIt;
-        ar << "</cols>\r\n";
     }
+    writeColumns(widths, sheet, xml);
+
+    // rows; the columns of the sheet are a valid spans hint for every row
+    TableWalker walker(table);
+    RowWriter writer(walker, first, last, sheet, xml);
+    walker.forEachRow(writer);
+
+    closeSheet(sheet, xml);
+}
 
-    ar << "<sheetData>\r\n";
-
-    // rows
-    Rows::Iterator* rowIt = table.rows().iterator();
-    while (rowIt->hasNext()) {
-        Rows::Entry entry = rowIt->next();
-        int row = entry.index();
-        ar << "<row r=\"" << row + 1 << "\"";
-        double height = entry.object().getHeight();
-        if (height >= 0) {
-            ar << " ht=\"" << height << "\" customHeight=\"1\"";
-        }            
-        ar << ">\r\n";
-        Cells::Iterator* cellIt = entry.object().cells().iterator();
-        while (cellIt->hasNext()) {
-            Cells::Entry entry = cellIt->next();
-            int col = entry.index();
-            Cell& cell = entry.object();
-            if (cell.getType() == Cell::NONE) {
-                continue;
+void XlsxWriterImpl::openSheet(int id, const SheetState& sheet,
+                               XmlWriter& xml) {
+    std::basic_stringstream<char> entryName;
+    entryName << "xl/worksheets/sheet" << id << ".xml";
+    xml.openEntry(entryName.str().c_str());
+    const char* nl = sheet.compact ? "" : "\r\n";
+    xml << "<\?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"\?>" << nl
+        << "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/5/main\" xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">" << nl;
+}
+
+void XlsxWriterImpl::writeColumns(const Widths& widths,
+                                  const SheetState& sheet, XmlWriter& xml) {
+    const char* nl = sheet.compact ? "" : "\r\n";
+    if (!widths.empty()) {
+        xml << "<cols>" << nl;
+        Widths::const_iterator i = widths.begin();
+        while (i != widths.end()) {
+            int min = i->first;
+            int max = min;
+            double width = i->second;
+            ++i;
+            if (sheet.compact) {
+                // a range of neighboring columns of the same width
+                for (; i != widths.end() && i->first == max + 1 &&
+                       i->second == width; ++i) {
+                    max++;
+                }
             }
-            writeCell(cell, col, row, ar);
+            double w = ExcelUtil::columnWidthUnits(width);
+            xml << "<col min=\"" << min + 1 << "\" max=\"" << max + 1 << "\" width=\"" << w << "\" customWidth=\"1\"/>" << nl;
         }
-        delete cellIt;            
-        ar << "</row>\r\n";
+        xml << "</cols>" << nl;
     }
-    delete rowIt;
+    xml << "<sheetData>" << nl;
+}
 
-    ar << "</sheetData>\r\n"
-          "</worksheet>\r\n";
-    ar.closeEntry();
+void XlsxWriterImpl::writeRowStart(int row, double height, int first,
+                                   int last, SheetState& sheet,
+                                   XmlWriter& xml) {
+    xml << "<row";
+    // a row that follows the previous one needs no reference
+    if (!sheet.compact || row != sheet.row + 1) {
+        xml << " r=\"" << row + 1 << "\"";
+    }
+    if (sheet.compact && first >= 0) {
+        xml << " spans=\"" << first + 1 << ":" << last + 1 << "\"";
+    }
+    if (height >= 0) {
+        xml << " ht=\"" << height << "\" customHeight=\"1\"";
+    }
+    xml << (sheet.compact ? ">" : ">\r\n");
+    sheet.row = row;
+    sheet.column = -1;
 }
 
-void XlsxWriterImpl::writeCell(Cell& cell, int col, int row, ZipArchive& ar) {
-    std::basic_string<char> loc = Util::buildLocation(col, row);
-    ar << "<c r=\"" << loc.c_str() << "\"";
-    int s = xfIndex(cell);
-    if (s != 0) {
-        ar << " s=\"" << s << "\"";
+void XlsxWriterImpl::writeRowEnd(const SheetState& sheet, XmlWriter& xml) {
+    xml << (sheet.compact ? "</row>" : "</row>\r\n");
+}
+
+void XlsxWriterImpl::closeSheet(const SheetState& sheet, XmlWriter& xml) {
+    const char* nl = sheet.compact ? "" : "\r\n";
+    xml << "</sheetData>" << nl << "</worksheet>" << nl;
+    xml.closeEntry();
+}
+
+void XlsxWriterImpl::writeCell(Cell& cell, int col, int row,
+                               SheetState& sheet, XmlWriter& xml) {
+    int xf = xfIndex(cell.getType(), cell.getHAlignment(),
+                     cell.getVAlignment());
+    writeValue(CellValue::of(cell), xf, col, row, sheet, xml);
+}
+
+void XlsxWriterImpl::writeValue(const CellValue& value, int xf, int col,
+                                int row, SheetState& sheet, XmlWriter& xml) {
+    Cell::Type type = value.getType();
+    if (type == Cell::NONE) {
+        return;
     }
-    ar << ">\r\n";
-    if (cell.getType() == Cell::TEXT) {
-        ToUTF8 utf8(Strings::xmlize(cell.getText()).c_str());
-        ar << "<is><t>" << utf8.get() << "</t></is>\r\n";
-    } else if (cell.getType() == Cell::LONG) {
-        ar << "<v>" << cell.getLong() << "</v>\r\n";
-    } else if (cell.getType() == Cell::DOUBLE) {
-        ar << "<v>" << cell.getDouble() << "</v>\r\n";
-    } else if (cell.getType() == Cell::DATE) {
-        ar << "<v>" << ExcelUtil::date(cell.getDate()) << "</v>\r\n";
-    } else if (cell.getType() == Cell::TIME) {
-        ar << "<v>" << ExcelUtil::time(cell.getTime()) << "</v>\r\n";
-    } else if (cell.getType() == Cell::FORMULA) {
-        ToUTF8 utf8(cell.getFormula());
-        ar << "<f>" << utf8.get() << "</f>\r\n";
+    const char* nl = sheet.compact ? "" : "\r\n";
+    xml << "<c";
+    // a cell that follows the previous one needs no reference
+    if (!sheet.compact || col != sheet.column + 1) {
+        char loc[Util::LOCATION_SIZE];
+        Util::formatLocation(col, row, loc);
+        xml << " r=\"" << loc << "\"";
+    }
+    sheet.column = col;
+    if (xf != 0) {
+        xml << " s=\"" << xf << "\"";
+    }
+    SharedStrings* strings = sheet.strings;
+    if (type == Cell::TEXT && strings != 0) {
+        const _TCHAR* text = value.getText() != 0 ? value.getText() : _T("");
+        int index = strings->isSealed() ? strings->find(text)
+                                        : strings->add(text);
+        xml << " t=\"s\">" << nl << "<v>" << index << "</v>" << nl << "</c>" << nl;
+        return;
+    }
+    xml << ">" << nl;
+    if (type == Cell::TEXT) {
+        xml << "<is><t>";
+        xml.writeText(value.getText());
+        xml << "</t></is>" << nl;
+    } else if (type == Cell::LONG) {
+        xml << "<v>" << value.getLong() << "</v>" << nl;
+    } else if (type == Cell::DOUBLE) {
+        xml << "<v>" << value.getDouble() << "</v>" << nl;
+    } else if (type == Cell::DATE) {
+        xml << "<v>" << ExcelUtil::date(value.getDate()) << "</v>" << nl;
+    } else if (type == Cell::TIME) {
+        xml << "<v>" << ExcelUtil::time(value.getTime()) << "</v>" << nl;
+    } else if (type == Cell::FORMULA) {
+        xml << "<f>";
+        xml.writeText(value.getFormula());
+        xml << "</f>" << nl;
+    }
+    xml << "</c>" << nl;
+}
+
+void XlsxWriterImpl::writeSharedStrings(const SharedStrings& strings,
+                                        XmlWriter& xml) {
+    xml.openEntry("xl/sharedStrings.xml");
+    xml << "<\?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"\?>\r\n"
+           "<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/5/main\" count=\""
+        << strings.references() << "\" uniqueCount=\"" << strings.size()
+        << "\">\r\n";
+    for (int i = 0; i < strings.size(); i++) {
+        xml << "<si><t>";
+        xml.writeText(strings.get(i));
+        xml << "</t></si>\r\n";
     }
-    ar << "</c>\r\n";
+    xml << "</sst>\r\n";
+    xml.closeEntry();
 }
 
 }
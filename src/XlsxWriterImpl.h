@@ -6,6 +6,9 @@
 #define XLSXWRITERIMPL_H
 
 #include "splib.h"
+#include <map>
+#include <string>
+#include <vector>
 
 namespace splib {
 
@@ -16,48 +19,209 @@ namespace splib {
 class XlsxWriterImpl {
 
     public:
-        /** Writes a spreadsheet to a file in xlsx format. */
-        static void write(Spreadsheet& sp, const _TCHAR* pathname);
+        /** The names of the sheets of a package */
+        typedef std::vector<std::basic_string<_TCHAR> > Names;
+
+        /** The widths of the columns of a sheet, by column index */
+        typedef std::map<int, double> Widths;
+
+        /**
+         * The encoding of a sheet being written, and the position of the
+         * last row and cell written, which the compact encoding needs to
+         * leave out the references that follow from the previous ones.
+         */
+        struct SheetState {
+            /**
+             * Creates the state of a sheet before its first row.
+             * @param strings the shared string table, or 0
+             * @param compact true for the compact encoding
+             */
+            SheetState(class SharedStrings* strings, bool compact)
+                : strings(strings), compact(compact), row(-1), column(-1) {}
+
+            /**
+             * The shared string table that texts are added to, or found
+             * in once it is sealed; 0 to write texts into the cells
+             */
+            SharedStrings* strings;
+
+            /**
+             * Indicates whether the sheet is written without whitespace,
+             * without the references of rows and cells that follow the
+             * previous ones, and with the columns of equal widths merged
+             */
+            bool compact;
+
+            /** The index of the last row started, or -1 */
+            int row;
+
+            /** The index of the last cell written in the row, or -1 */
+            int column;
+        };
+
+    public:
+        /**
+         * Writes a spreadsheet to a file in xlsx format.
+         * @param threads the number of threads that write the sheets
+         * @param compression the compression of the entries
+         * @param sharedStrings true to write the texts into a shared
+         *        string table, false to write them into the cells
+         * @param compact true to write the sheets in the compact encoding
+         */
+        static void write(Spreadsheet& sp, const _TCHAR* pathname,
+                          int threads, const CompressionOptions& compression,
+                          bool sharedStrings, bool compact);
+
+        /**
+         * Writes a spreadsheet to a sink in xlsx format.
+         * @param threads the number of threads that write the sheets
+         * @param compression the compression of the entries
+         * @param sharedStrings true to write the texts into a shared
+         *        string table, false to write them into the cells
+         * @param compact true to write the sheets in the compact encoding
+         */
+        static void write(Spreadsheet& sp, OutputSink& sink, int threads,
+                          const CompressionOptions& compression,
+                          bool sharedStrings, bool compact);
+
+        /**
+         * Writes the entries of the xlsx package that describe the
+         * workbook: the content types, the relationships, the document
+         * properties, the styles, the workbook, and the theme.
+         * @param names the names of the sheets, in order
+         * @param sharedStrings true if the package has a shared string
+         *        table
+         */
+        static void writeWorkbookParts(const Names& names, bool sharedStrings,
+                                       class XmlWriter& xml);
+
+        /** Writes the xl/sharedStrings.xml entry of the xlsx package. */
+        static void writeSharedStrings(const class SharedStrings& strings,
+                                       XmlWriter& xml);
+
+        /**
+         * Opens the entry of a sheet and writes the start of the sheet,
+         * up to but not including the dimension.
+         */
+        static void openSheet(int id, const SheetState& sheet,
+                              XmlWriter& xml);
+
+        /**
+         * Writes the widths of the columns of a sheet, if any, and starts
+         * the sheet data. The compact encoding merges the neighboring
+         * columns of equal widths into ranges.
+         */
+        static void writeColumns(const Widths& widths, const SheetState& sheet,
+                                 XmlWriter& xml);
+
+        /**
+         * Writes the start tag of a row.
+         * @param first the index of the first column of the cells of the
+         *        row, for the spans hint of the compact encoding; -1
+         *        for none
+         * @param last the index of the last column of the cells of the row
+         */
+        static void writeRowStart(int row, double height, int first,
+                                  int last, SheetState& sheet,
+                                  XmlWriter& xml);
+
+        /** Writes the end tag of a row. */
+        static void writeRowEnd(const SheetState& sheet, XmlWriter& xml);
+
+        /**
+         * Writes a value as a cell to the current zip entry. Values of
+         * type <code>Cell::NONE</code> are not written.
+         * @param value the value
+         * @param xf the index of the XF record of the cell
+         * @param col the column index
+         * @param row the row index
+         * @param sheet the state of the sheet
+         * @param xml the writer of the entry
+         */
+        static void writeValue(const CellValue& value, int xf, int col,
+                               int row, SheetState& sheet, XmlWriter& xml);
+
+        /**
+         * Determines the index to an XF record for a cell of a given type
+         * and alignments. This is coupled with writeXFs().
+         */
+        static int xfIndex(Cell::Type type, Cell::HAlignment hAlignment,
+                           Cell::VAlignment vAlignment);
+
+        /** Writes the end of a sheet and closes its entry. */
+        static void closeSheet(const SheetState& sheet, XmlWriter& xml);
 
     private:
+        /** Writes all entries of the xlsx package and closes it. */
+        static void writePackage(Spreadsheet& sp, int threads,
+                                 bool sharedStrings, bool compact,
+                                 class ZipArchive& ar);
+
         /** Writes the [Content_Types].xml entry of the xlsx package. */
-        static void writeContentTypes(Spreadsheet& sp, class ZipArchive& ar);
+        static void writeContentTypes(int sheets, bool sharedStrings,
+                                      XmlWriter& xml);
         
         /** Writes the _rel/.rels entry of the xlsx package. */
-        static void writeRels(ZipArchive& ar);
+        static void writeRels(XmlWriter& xml);
         
         /** Writes the docProps/app.xml entry of the xlsx package. */
-        static void writeAppDocProps(Spreadsheet& sp, ZipArchive& ar);
+        static void writeAppDocProps(const Names& names, XmlWriter& xml);
         
         /** Writes the docProps/core.xml entry of the xlsx package. */
-        static void writeCoreDocProps(ZipArchive& ar);
+        static void writeCoreDocProps(XmlWriter& xml);
         
         /** Writes the xl/styles.xml entry of the xlsx package. */
-        static void writeStyles(ZipArchive& ar);
+        static void writeStyles(XmlWriter& xml);
         
         /** Writes XF entries to the current entry. */
-        static void writeXFs(ZipArchive& ar);
+        static void writeXFs(XmlWriter& xml);
 
-        /**
-         * Determines the index to an XF record for a given cell. This is
-         * coupled with writeXFs().
-         */
-        static int xfIndex(Cell& cell);
-        
         /** Writes the xl/_rels/workbook.xml.rels entry of the xlsx package. */
-        static void writeWorkbookRels(Spreadsheet& sp, ZipArchive& ar);
+        static void writeWorkbookRels(int sheets, bool sharedStrings,
+                                      XmlWriter& xml);
         
         /** Writes the xl/workbook.xml entry of the xlsx package. */
-        static void writeWorkbook(Spreadsheet& sp, ZipArchive& ar);
+        static void writeWorkbook(const Names& names, XmlWriter& xml);
         
         /** Writes the xl/theme/theme1.xml entry of the xlsx package. */
-        static void writeTheme(ZipArchive& ar);
-        
-        /** Writes a sheet entry to an xlsx package. */
-        static void writeSheet(Table& table, int id, ZipArchive& ar);
+        static void writeTheme(XmlWriter& xml);
         
+        /**
+         * Writes a sheet entry to an xlsx package.
+         * @param strings the shared string table, or 0
+         * @param compact true for the compact encoding
+         */
+        static void writeSheet(Table& table, int id, SharedStrings* strings,
+                               bool compact, XmlWriter& xml);
+
+        /**
+         * Writes the sheet entries of all tables to an xlsx package,
+         * compressing them on several threads as the package would.
+         * @param strings the sealed shared string table, or 0
+         * @param compact true for the compact encoding
+         */
+        static void writeSheets(Spreadsheet& sp, int threads,
+                                SharedStrings* strings, bool compact,
+                                ZipArchive& ar);
+
+        /**
+         * Adds the texts of all tables to a shared string table, in the
+         * order the sheets would add them.
+         */
+        static void collectStrings(Spreadsheet& sp, SharedStrings& strings);
+
         /** Writes a cell to the current zip entry. */
-        static void writeCell(Cell& cell, int col, int row, ZipArchive& ar);
+        static void writeCell(Cell& cell, int col, int row,
+                              SheetState& sheet, XmlWriter& xml);
+
+        /** Visitor that writes the rows of a sheet. */
+        class RowWriter;
+
+        /** Visitor that adds the texts of a sheet to a string table. */
+        class StringCollector;
+
+        /** Task that writes sheets into archives in memory. */
+        class SheetWriter;
 };
 
 }
@@ -0,0 +1,386 @@
+// File: XmlText.cpp
+// XmlText implementation file
+//
+
+#include "XmlText.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define XMLTEXT_X86
+#define XMLTEXT_TARGET(name) __attribute__((target(name)))
+#if defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+#define XMLTEXT_AVX2
+#endif
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define XMLTEXT_X86
+#define XMLTEXT_TARGET(name)
+#if _MSC_VER >= 1700
+#define XMLTEXT_AVX2
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+#include <intrin.h>
+#endif
+
+#include "splibint.h"
+
+namespace splib {
+
+/** The replacement character U+FFFD in UTF-8 */
+static const char REPLACEMENT[] = "\xEF\xBF\xBD";
+
+/** A function that searches text */
+typedef unsigned (*SearchFunction)(const char* text, unsigned length);
+
+/** The type of the words searched by the scalar kernel */
+typedef unsigned long long Word;
+
+/** A word with all bytes set to 0x01 */
+static const Word ONES = 0x0101010101010101ULL;
+
+/** A word with the high bits of all bytes set */
+static const Word HIGHS = 0x8080808080808080ULL;
+
+/** Indicates whether a byte is copied as it is. */
+static inline bool isPlain(unsigned char c) {
+    if (c < 0x20) {
+        return c == '\t' || c == '\n' || c == '\r';
+    }
+    return c < 0x80 && c != '&' && c != '<' && c != '>' && c != '"';
+}
+
+// '"' and '&' differ from 0x26 only in bit 2, and '<' and '>' from 0x3E
+// only in bit 1, so two comparisons find the four characters; the bytes
+// that are not ASCII have their high bit set; the control characters are
+// below 0x20, and the tabs and line ends among them are told apart byte
+// by byte
+
+/**
+ * Indicates whether all bytes of a word are copied as they are, except
+ * perhaps for tabs and line ends; the bytes equal to a character are found
+ * as the zero bytes of the word xor the character, and the bytes below
+ * 0x20 as those that borrow when 0x20 is subtracted.
+ */
+static inline bool isPlain(Word w) {
+    Word quotAmp = (w | ONES * 4) ^ (ONES * 0x26);
+    Word ltGt = (w | ONES * 2) ^ (ONES * 0x3E);
+    Word zeros = ((quotAmp - ONES) & ~quotAmp) | ((ltGt - ONES) & ~ltGt);
+    Word controls = (w - ONES * 0x20) & ~w;
+    return ((zeros | controls | w) & HIGHS) == 0;
+}
+
+static unsigned plainLengthScalar(const char* text, unsigned length) {
+    unsigned i = 0;
+    for (; i + sizeof(Word) <= length; i += sizeof(Word)) {
+        Word w;
+        ::memcpy(&w, text + i, sizeof(w));
+        if (!isPlain(w)) {
+            for (unsigned j = 0; j < sizeof(Word); j++) {
+                if (!isPlain((unsigned char)text[i + j])) {
+                    return i + j;
+                }
+            }
+        }
+    }
+    while (i < length && isPlain((unsigned char)text[i])) {
+        i++;
+    }
+    return i;
+}
+
+#ifdef XMLTEXT_X86
+
+/** Retrieves the index of the lowest bit set in a mask that is not 0. */
+static inline unsigned lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+// the kernels below make the comparisons of isPlain() on 16 or 32 bytes
+
+XMLTEXT_TARGET("sse2")
+static unsigned plainLengthSse2(const char* text, unsigned length) {
+    if (length < 16) {
+        return plainLengthScalar(text, length);
+    }
+    const __m128i bit2 = _mm_set1_epi8(4);
+    const __m128i quotAmp = _mm_set1_epi8(0x26);
+    const __m128i bit1 = _mm_set1_epi8(2);
+    const __m128i ltGt = _mm_set1_epi8(0x3E);
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    unsigned i = 0;
+    for (;;) {
+        if (i + 16 > length) {
+            // the last block overlaps bytes known to be plain
+            i = length - 16;
+        }
+        __m128i v = _mm_loadu_si128((const __m128i*)(text + i));
+        __m128i special = _mm_or_si128(
+            _mm_cmpeq_epi8(_mm_or_si128(v, bit2), quotAmp),
+            _mm_cmpeq_epi8(_mm_or_si128(v, bit1), ltGt));
+        // the signed comparison also finds the bytes that are not ASCII
+        __m128i whitespace = _mm_or_si128(_mm_cmpeq_epi8(v, tab),
+            _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+        special = _mm_or_si128(special,
+            _mm_andnot_si128(whitespace, _mm_cmplt_epi8(v, space)));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(v, special));
+        if (mask != 0) {
+            return i + lowestBit(mask);
+        }
+        i += 16;
+        if (i == length) {
+            return length;
+        }
+    }
+}
+
+#ifdef XMLTEXT_AVX2
+
+XMLTEXT_TARGET("avx2")
+static unsigned plainLengthAvx2(const char* text, unsigned length) {
+    if (length < 32) {
+        return plainLengthSse2(text, length);
+    }
+    const __m256i bit2 = _mm256_set1_epi8(4);
+    const __m256i quotAmp = _mm256_set1_epi8(0x26);
+    const __m256i bit1 = _mm256_set1_epi8(2);
+    const __m256i ltGt = _mm256_set1_epi8(0x3E);
+    const __m256i space = _mm256_set1_epi8(0x20);
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    unsigned i = 0;
+    for (;;) {
+        if (i + 32 > length) {
+            // the last block overlaps bytes known to be plain
+            i = length - 32;
+        }
+        __m256i v = _mm256_loadu_si256((const __m256i*)(text + i));
+        __m256i special = _mm256_or_si256(
+            _mm256_cmpeq_epi8(_mm256_or_si256(v, bit2), quotAmp),
+            _mm256_cmpeq_epi8(_mm256_or_si256(v, bit1), ltGt));
+        // the signed comparison also finds the bytes that are not ASCII
+        __m256i whitespace = _mm256_or_si256(_mm256_cmpeq_epi8(v, tab),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, lf),
+                            _mm256_cmpeq_epi8(v, cr)));
+        special = _mm256_or_si256(special,
+            _mm256_andnot_si256(whitespace, _mm256_cmpgt_epi8(space, v)));
+        unsigned mask =
+            (unsigned)_mm256_movemask_epi8(_mm256_or_si256(v, special));
+        if (mask != 0) {
+            return i + lowestBit(mask);
+        }
+        i += 32;
+        if (i == length) {
+            return length;
+        }
+    }
+}
+
+#endif // XMLTEXT_AVX2
+
+#endif // XMLTEXT_X86
+
+/** Retrieves the function of a kernel; the kernel must be supported. */
+static SearchFunction searchFunction(XmlText::Kernel kernel) {
+    switch (kernel) {
+#ifdef XMLTEXT_X86
+        case XmlText::SSE2:
+            return plainLengthSse2;
+#ifdef XMLTEXT_AVX2
+        case XmlText::AVX2:
+            return plainLengthAvx2;
+#endif
+#endif
+        default:
+            return plainLengthScalar;
+    }
+}
+
+/** Retrieves the fastest kernel supported by the processor. */
+static XmlText::Kernel bestKernel() {
+    if (XmlText::isSupported(XmlText::AVX2)) {
+        return XmlText::AVX2;
+    }
+    if (XmlText::isSupported(XmlText::SSE2)) {
+        return XmlText::SSE2;
+    }
+    return XmlText::SCALAR;
+}
+
+/** The kernel used, chosen when the library is loaded */
+static XmlText::Kernel currentKernel = bestKernel();
+
+/** The function of the kernel used */
+static SearchFunction search = searchFunction(currentKernel);
+
+void XmlText::escape(const char*& text, const char* end,
+                     char*& out, char* outEnd) {
+    const char* p = text;
+    char* q = out;
+    while (p < end) {
+        unsigned space = (unsigned)(outEnd - q);
+        unsigned length = (unsigned)(end - p);
+        unsigned n = search(p, length < space ? length : space);
+        ::memcpy(q, p, n);
+        p += n;
+        q += n;
+        if (p == end || n == space) {
+            break;
+        }
+        const char* replacement;
+        unsigned replacementLength;
+        unsigned consumed = 1;
+        switch (*p) {
+            case '&':
+                replacement = "&amp;";
+                replacementLength = 5;
+                break;
+            case '<':
+                replacement = "&lt;";
+                replacementLength = 4;
+                break;
+            case '>':
+                replacement = "&gt;";
+                replacementLength = 4;
+                break;
+            case '"':
+                replacement = "&quot;";
+                replacementLength = 6;
+                break;
+            default:
+                // control characters count as invalid sequences
+                consumed = (unsigned char)*p < 0x20 ? 0 :
+                           sequenceLength(p, (unsigned)(end - p));
+                if (consumed > 0) {
+                    replacement = p;
+                    replacementLength = consumed;
+                } else {
+                    replacement = REPLACEMENT;
+                    replacementLength = 3;
+                    consumed = 1;
+                }
+        }
+        if (replacementLength > (unsigned)(outEnd - q)) {
+            break;
+        }
+        ::memcpy(q, replacement, replacementLength);
+        p += consumed;
+        q += replacementLength;
+    }
+    text = p;
+    out = q;
+}
+
+unsigned XmlText::plainLength(const char* text, unsigned length) {
+    return search(text, length);
+}
+
+unsigned XmlText::sequenceLength(const char* text, unsigned length) {
+    const unsigned char* s = (const unsigned char*)text;
+    if (length == 0) {
+        return 0;
+    }
+    unsigned char c = s[0];
+    if (c < 0x80) {
+        return 1;
+    }
+    // the range of the second byte excludes overlong forms, surrogates,
+    // and code points above U+10FFFF
+    unsigned n;
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    if (c < 0xC2) {
+        return 0;
+    } else if (c < 0xE0) {
+        n = 2;
+    } else if (c < 0xF0) {
+        n = 3;
+        if (c == 0xE0) {
+            low = 0xA0;
+        } else if (c == 0xED) {
+            high = 0x9F;
+        }
+    } else if (c < 0xF5) {
+        n = 4;
+        if (c == 0xF0) {
+            low = 0x90;
+        } else if (c == 0xF4) {
+            high = 0x8F;
+        }
+    } else {
+        return 0;
+    }
+    if (length < n || s[1] < low || s[1] > high) {
+        return 0;
+    }
+    for (unsigned i = 2; i < n; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+    return n;
+}
+
+XmlText::Kernel XmlText::getKernel() {
+    return currentKernel;
+}
+
+bool XmlText::setKernel(Kernel kernel) {
+    if (!isSupported(kernel)) {
+        return false;
+    }
+    currentKernel = kernel;
+    search = searchFunction(kernel);
+    return true;
+}
+
+bool XmlText::isSupported(Kernel kernel) {
+    if (kernel == SCALAR) {
+        return true;
+    }
+#if defined(XMLTEXT_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (kernel == SSE2) {
+        return __builtin_cpu_supports("sse2") != 0;
+    }
+#ifdef XMLTEXT_AVX2
+    if (kernel == AVX2) {
+        return __builtin_cpu_supports("avx2") != 0;
+    }
+#endif
+#elif defined(XMLTEXT_X86)
+    int info[4];
+    __cpuid(info, 1);
+    if (kernel == SSE2) {
+        return (info[3] & (1 << 26)) != 0;
+    }
+#ifdef XMLTEXT_AVX2
+    // the system must save the AVX registers, and the processor support
+    // AVX2
+    const int osxsave = 1 << 27;
+    const int avx = 1 << 28;
+    int features = info[2];
+    __cpuid(info, 0);
+    if (kernel == AVX2 && info[0] >= 7 &&
+        (features & (osxsave | avx)) == (osxsave | avx) &&
+        (_xgetbv(0) & 6) == 6) {
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }
+#endif
+#endif
+    return false;
+}
+
+}
@@ -0,0 +1,74 @@
+// File: XmlText.h
+// XmlText declaration file
+//
+
+#ifndef XMLTEXT_H
+#define XMLTEXT_H
+
+namespace splib {
+
+/**
+ * Static methods that escape UTF-8 text for XML. The characters
+ * <code>&amp;</code>, <code>&lt;</code>, <code>&gt;</code>, and
+ * <code>&quot;</code> are replaced by entity references. The control
+ * characters that XML does not allow, that is, those below U+0020 other
+ * than tab, line feed, and carriage return, and the bytes that are not
+ * part of a valid UTF-8 sequence are replaced by the replacement
+ * character U+FFFD, so that the output is always well-formed.
+ * <p>
+ * Most text is plain ASCII, so the text is searched for the bytes that
+ * need attention 16 or 32 bytes at a time with SSE2 or AVX2 instructions,
+ * and the runs of plain bytes between them are copied as a whole. The
+ * kernel that searches is chosen when the library is loaded, according
+ * to the processor; on other processors, a scalar kernel is used.
+ */
+class XmlText {
+    public:
+        /** The kernels that search text */
+        enum Kernel {SCALAR, SSE2, AVX2};
+
+        /**
+         * Escapes text into a buffer, as much of it as fits. A character
+         * is never split.
+         * @param text the start of the text; on return, the start of the
+         *        text not escaped yet
+         * @param end the end of the text
+         * @param out the start of the buffer; on return, the end of the
+         *        output
+         * @param outEnd the end of the buffer
+         */
+        static void escape(const char*& text, const char* end,
+                           char*& out, char* outEnd);
+
+        /**
+         * Finds the first byte of a text that is not plain ASCII, or that
+         * is one of the characters escaped or replaced.
+         * @return the number of plain bytes before it, or
+         *         <code>length</code> if there is none
+         */
+        static unsigned plainLength(const char* text, unsigned length);
+
+        /**
+         * Checks the UTF-8 sequence that starts a text. Overlong forms,
+         * surrogates, and code points above U+10FFFF are not valid.
+         * @return the length of the sequence, or 0 if it is not valid
+         */
+        static unsigned sequenceLength(const char* text, unsigned length);
+
+        /** Retrieves the kernel used to search text. */
+        static Kernel getKernel();
+
+        /**
+         * Sets the kernel used to search text, for testing and benchmarks.
+         * Must not be called while text is being escaped.
+         * @return false if the processor does not support the kernel
+         */
+        static bool setKernel(Kernel kernel);
+
+        /** Indicates whether the processor supports a kernel. */
+        static bool isSupported(Kernel kernel);
+};
+
+}
+
+#endif // XMLTEXT_H
@@ -0,0 +1,173 @@
+// File: XmlWriter.cpp
+// XmlWriter implementation file
+//
+
+#include "XmlWriter.h"
+#include "ZipArchive.h"
+#include "NumberFormat.h"
+#include "ToUTF8.h"
+#include "XmlText.h"
+#include <string.h>
+#include "splibint.h"
+
+namespace splib {
+
+XmlWriter::XmlWriter(ZipArchive& ar) : ar(ar), used(0) {
+}
+
+XmlWriter::~XmlWriter() {
+}
+
+void XmlWriter::openEntry(const char* entryName) {
+    flush();
+    ar.openEntry(entryName);
+}
+
+void XmlWriter::closeEntry() {
+    flush();
+    ar.closeEntry();
+}
+
+void XmlWriter::write(const char* data, unsigned length) {
+    if (length > BUFFER_SIZE - used) {
+        flush();
+        if (length > BUFFER_SIZE) {
+            ar.write(data, length);
+            return;
+        }
+    }
+    ::memcpy(buffer + used, data, length);
+    used += length;
+}
+
+void XmlWriter::writeText(const _TCHAR* text) {
+    if (text == 0) {
+        return;
+    }
+#if defined(WIN32) && !defined(_UNICODE)
+    // the code page of the text is converted first
+    ToUTF8 utf8(text);
+    writeEscaped(utf8.get());
+#else
+    writeEscaped(text);
+#endif
+}
+
+void XmlWriter::flush() {
+    if (used > 0) {
+        // the buffer is emptied first, so that a failed write is not retried
+        unsigned length = used;
+        used = 0;
+        ar.write(buffer, length);
+    }
+}
+
+void XmlWriter::writeEscaped(const char* text) {
+    const char* end = text + ::strlen(text);
+    for (;;) {
+        char* out = buffer + used;
+        XmlText::escape(text, end, out, buffer + BUFFER_SIZE);
+        used = (unsigned)(out - buffer);
+        if (text == end) {
+            return;
+        }
+        flush();
+    }
+}
+
+#if defined(WIN32) && defined(_UNICODE)
+void XmlWriter::writeEscaped(const wchar_t* text) {
+    // the longest output of a character is an entity reference of 6 bytes
+    for (const wchar_t* p = text; *p != 0; p++) {
+        if (used + 6 > BUFFER_SIZE) {
+            flush();
+        }
+        unsigned long c = *p;
+        char* out = buffer + used;
+        if (c < 0x80) {
+            switch (c) {
+                case L'&':
+                    ::memcpy(out, "&amp;", 5);
+                    used += 5;
+                    break;
+                case L'<':
+                    ::memcpy(out, "&lt;", 4);
+                    used += 4;
+                    break;
+                case L'>':
+                    ::memcpy(out, "&gt;", 4);
+                    used += 4;
+                    break;
+                case L'"':
+                    ::memcpy(out, "&quot;", 6);
+                    used += 6;
+                    break;
+                case L'\t':
+                case L'\n':
+                case L'\r':
+                    *out = (char)c;
+                    used++;
+                    break;
+                default:
+                    if (c < 0x20) {
+                        // a control character that XML does not allow
+                        ::memcpy(out, "\xEF\xBF\xBD", 3);
+                        used += 3;
+                    } else {
+                        *out = (char)c;
+                        used++;
+                    }
+            }
+            continue;
+        }
+        if (c >= 0xD800 && c < 0xDC00 && p[1] >= 0xDC00 && p[1] < 0xE000) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (p[1] - 0xDC00);
+            p++;
+        } else if (c >= 0xD800 && c < 0xE000) {
+            // an unpaired surrogate
+            c = 0xFFFD;
+        }
+        if (c < 0x800) {
+            out[0] = (char)(0xC0 | (c >> 6));
+            out[1] = (char)(0x80 | (c & 0x3F));
+            used += 2;
+        } else if (c < 0x10000) {
+            out[0] = (char)(0xE0 | (c >> 12));
+            out[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+            out[2] = (char)(0x80 | (c & 0x3F));
+            used += 3;
+        } else {
+            out[0] = (char)(0xF0 | (c >> 18));
+            out[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+            out[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+            out[3] = (char)(0x80 | (c & 0x3F));
+            used += 4;
+        }
+    }
+}
+#endif
+
+XmlWriter& operator << (XmlWriter& xml, int val) {
+    char buffer[NumberFormat::BUFFER_SIZE];
+    xml.write(buffer, NumberFormat::format((long)val, buffer));
+    return xml;
+}
+
+XmlWriter& operator << (XmlWriter& xml, long val) {
+    char buffer[NumberFormat::BUFFER_SIZE];
+    xml.write(buffer, NumberFormat::format(val, buffer));
+    return xml;
+}
+
+XmlWriter& operator << (XmlWriter& xml, double val) {
+    char buffer[NumberFormat::BUFFER_SIZE];
+    xml.write(buffer, NumberFormat::format(val, buffer));
+    return xml;
+}
+
+XmlWriter& operator << (XmlWriter& xml, const char* val) {
+    xml.write(val, (unsigned)::strlen(val));
+    return xml;
+}
+
+}
@@ -0,0 +1,93 @@
+// File: XmlWriter.h
+// XmlWriter declaration file
+//
+
+#ifndef XMLWRITER_H
+#define XMLWRITER_H
+
+#include "splib.h"
+
+namespace splib {
+
+class ZipArchive;
+
+/**
+ * A buffered writer of XML into the entries of a zip archive. Markup is
+ * copied into a buffer that is written to the archive when full, so that
+ * the archive sees few large writes instead of one per piece of markup.
+ * Text is escaped and converted to UTF-8 in a single pass, straight into
+ * the buffer; UTF-8 text is escaped by <code>XmlText</code>, which also
+ * replaces invalid sequences.
+ * <p>
+ * The buffer is written to the archive before an entry is closed,
+ * through the methods of this writer; the archive itself must not be
+ * written to while the buffer holds data.
+ */
+class XmlWriter {
+    public:
+        /**
+         * Creates a new instance of <code>XmlWriter</code>.
+         * @param ar the archive to write to; must live as long as the writer
+         */
+        XmlWriter(ZipArchive& ar);
+
+        /** Destructor. The data left in the buffer is discarded. */
+        ~XmlWriter();
+
+        /** Opens an entry in the archive. */
+        void openEntry(const char* entryName);
+
+        /** Writes the buffer into the current entry and closes it. */
+        void closeEntry();
+
+        /** Writes markup, which is copied as it is. */
+        void write(const char* data, unsigned length);
+
+        /**
+         * Writes text, with the characters that have a meaning in XML
+         * replaced by entity references, and converted to UTF-8.
+         * @param text the text; 0 is written as an empty text
+         */
+        void writeText(const _TCHAR* text);
+
+        /** Writes the buffer into the archive. */
+        void flush();
+
+    private:
+        /** The size of the buffer */
+        enum {BUFFER_SIZE = 16384};
+
+        /** Writes UTF-8 text escaped by <code>XmlText</code>. */
+        void writeEscaped(const char* text);
+
+#if defined(WIN32) && defined(_UNICODE)
+        /** Writes UTF-16 text escaped and converted to UTF-8. */
+        void writeEscaped(const wchar_t* text);
+#endif
+
+        /** Not implemented; writers are not copied */
+        XmlWriter(const XmlWriter&);
+
+        /** Not implemented; writers are not copied */
+        XmlWriter& operator = (const XmlWriter&);
+
+    private:
+        /** The archive */
+        ZipArchive& ar;
+
+        /** The data not written to the archive yet */
+        char buffer[BUFFER_SIZE];
+
+        /** The number of bytes in the buffer */
+        unsigned used;
+};
+
+// convenience operators
+XmlWriter& operator << (XmlWriter& xml, int val);
+XmlWriter& operator << (XmlWriter& xml, long val);
+XmlWriter& operator << (XmlWriter& xml, double val);
+XmlWriter& operator << (XmlWriter& xml, const char* val);
+
+}
+
+#endif // XMLWRITER_H
@@ -3,15 +3,17 @@
 //
 
 #include "ZipArchive.h"
+#include "NumberFormat.h"
+#include "ParallelDeflater.h"
 #include <time.h>
-#include <sstream>
 #include "splibint.h"
 
 #include <string.h>
 
 namespace splib {
 
-ZipArchive::ZipArchive(const _TCHAR* pathname) {
+ZipArchive::ZipArchive(const _TCHAR* pathname)
+        : inMemory(false), stream(0), threads(1), deflater(0) {
     zf = zipOpen(pathname, APPEND_STATUS_CREATE);
     if (zf == 0) {
         std::basic_string<_TCHAR> msg;
@@ -23,64 +25,154 @@ ZipArchive::ZipArchive(const _TCHAR* pathname) {
     entryOpened = false;
 }
 
+ZipArchive::ZipArchive(OutputSink& sink)
+        : inMemory(false), stream(0), threads(1), deflater(0) {
+    zlib_filefunc_def filefunc;
+    fill_sink_filefunc(&filefunc, &sink);
+    zf = zipOpen2(0, APPEND_STATUS_CREATE, 0, &filefunc);
+    if (zf == 0) {
+        throw IOException(_T("error opening sink for writing"));
+    }
+    entryOpened = false;
+}
+
+ZipArchive::ZipArchive()
+        : zf(0), entryOpened(false), inMemory(true), stream(0), threads(1),
+          deflater(0) {
+}
+
 ZipArchive::~ZipArchive() {
-    if (entryOpened) {
-        closeEntry();
+    // errors are ignored; the destructor may run because of one
+    try {
+        if (entryOpened) {
+            closeEntry();
+        }
+    } catch (...) {
     }
     if (zf != 0) {
-        close();
+        zipClose(zf, 0);
+        zf = 0;
     }
-
+    if (stream != 0) {
+        deflateEnd(stream);
+        delete stream;
+    }
+    delete deflater;
 }
 
 void ZipArchive::openEntry(const char* entryName) {
-    if (zf == 0) {
+    if (zf == 0 && !inMemory) {
         throw IllegalStateException();
     }
     if (entryOpened) {
         throw IllegalStateException();
     }
-    time_t timeValue = time(0);
-#pragma warning (disable : 4996)
-    struct tm* timeStruct = localtime(&timeValue);
-#pragma warning (default : 4996)
+    int level = compression.getEntryLevel(entryName);
+    int method = level == CompressionOptions::STORE ? 0 : Z_DEFLATED;
+    if (inMemory) {
+        if (method == Z_DEFLATED) {
+            stream = new z_stream;
+            ::memset(stream, 0, sizeof(z_stream));
+            if (deflateInit2(stream, level, Z_DEFLATED,
+                             -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                delete stream;
+                stream = 0;
+                throw IOException(_T("error opening zip entry"));
+            }
+        }
+        entries.push_back(Entry());
+        entries.back().name = entryName;
+        entries.back().crc = crc32(0, Z_NULL, 0);
+        entries.back().size = 0;
+        entries.back().flushed = 0;
+        entries.back().method = method;
+        entries.back().level = level;
+        entryOpened = true;
+        return;
+    }
     zip_fileinfo zi;
-    zi.tmz_date.tm_sec = timeStruct->tm_sec;
-    zi.tmz_date.tm_min = timeStruct->tm_min;
-    zi.tmz_date.tm_hour = timeStruct->tm_hour;
-    zi.tmz_date.tm_mday = timeStruct->tm_mday;
-    zi.tmz_date.tm_mon = timeStruct->tm_mon;
-    zi.tmz_date.tm_year = timeStruct->tm_year + 1900;
-    zi.dosDate = 0;
-    zi.internal_fa = 0;
-    zi.external_fa = 0;
-    int err = zipOpenNewFileInZip(zf, entryName, &zi,
-        0, 0, 0, 0, 0, Z_DEFLATED, Z_DEFAULT_COMPRESSION);
+    fileInfo(zi);
+    // the blocks compressed by the threads are stored as raw data
+    bool parallel = threads > 1 && method == Z_DEFLATED;
+    int err = zipOpenNewFileInZip2(zf, entryName, &zi,
+        0, 0, 0, 0, 0, method, level, parallel);
     if (err != ZIP_OK) {
         throw IOException(_T("error opening zip entry"));
     }
+    if (parallel) {
+        deflater = new ParallelDeflater(threads, level);
+    }
     entryOpened = true;
 }
 
 void ZipArchive::write(const void* buffer, unsigned length) {
-    if (zf == 0) {
+    if (zf == 0 && !inMemory) {
         throw IllegalStateException();
     }
     if (!entryOpened) {
         throw IllegalStateException();
     }
+    if (inMemory) {
+        Entry& entry = entries.back();
+        entry.crc = crc32(entry.crc, (const Bytef*)buffer, length);
+        entry.size += length;
+        if (stream == 0) {
+            entry.data.append((const char*)buffer, length);
+        } else {
+            deflateEntry(buffer, length, Z_NO_FLUSH);
+        }
+        return;
+    }
+    if (deflater != 0) {
+        deflater->write(buffer, length);
+        writeDeflated();
+        return;
+    }
     if (zipWriteInFileInZip(zf, buffer, length) < 0) {
         throw IOException(_T("error writing zip entry"));
     }
 }
 
 void ZipArchive::closeEntry() {
-    if (zf == 0) {
+    if (zf == 0 && !inMemory) {
         throw IllegalStateException();
     }
     if (!entryOpened) {
         throw IllegalStateException();
     }
+    if (inMemory) {
+        entryOpened = false;
+        Entry& entry = entries.back();
+        if (stream != 0) {
+            deflateEntry(0, 0, Z_SYNC_FLUSH);
+            entry.flushed = (unsigned long)entry.data.size();
+            deflateEntry(0, 0, Z_FINISH);
+            deflateEnd(stream);
+            delete stream;
+            stream = 0;
+        } else {
+            entry.flushed = (unsigned long)entry.data.size();
+        }
+        return;
+    }
+    if (deflater != 0) {
+        entryOpened = false;
+        try {
+            deflater->finish();
+            writeDeflated();
+        } catch (...) {
+            delete deflater;
+            deflater = 0;
+            throw;
+        }
+        int err = zipCloseFileInZipRaw(zf, deflater->size(), deflater->crc());
+        delete deflater;
+        deflater = 0;
+        if (err != ZIP_OK) {
+            throw IOException(_T("error closing current zip entry"));
+        }
+        return;
+    }
     if (zipCloseFileInZip(zf) != ZIP_OK) {
         throw IOException(_T("error closing current zip entry"));
     }
@@ -100,25 +192,117 @@ void ZipArchive::close() {
     zf = 0;
 }
 
+void ZipArchive::writeEntries(const ZipArchive& ar) {
+    if (zf == 0 || entryOpened || ar.entryOpened) {
+        throw IllegalStateException();
+    }
+    for (Entries::const_iterator i = ar.entries.begin();
+         i != ar.entries.end(); ++i) {
+        zip_fileinfo zi;
+        fileInfo(zi);
+        int err = zipOpenNewFileInZip2(zf, i->name.c_str(), &zi,
+            0, 0, 0, 0, 0, i->method, i->level, 1);
+        if (err != ZIP_OK) {
+            throw IOException(_T("error opening zip entry"));
+        }
+        if (zipWriteInFileInZip(zf, i->data.data(),
+                                (unsigned)i->data.size()) < 0) {
+            throw IOException(_T("error writing zip entry"));
+        }
+        if (zipCloseFileInZipRaw(zf, i->size, i->crc) != ZIP_OK) {
+            throw IOException(_T("error closing current zip entry"));
+        }
+    }
+}
+
+void ZipArchive::appendEntry(const ZipArchive& ar) {
+    if (!inMemory || !ar.inMemory || entries.empty() || ar.entries.empty()
+        || entryOpened || ar.entryOpened) {
+        throw IllegalStateException();
+    }
+    Entry& entry = entries.back();
+    const Entry& part = ar.entries.back();
+    if (entry.method != part.method) {
+        throw IllegalArgumentException();
+    }
+    // the end of the first stream is replaced by the second stream
+    entry.data.resize(entry.flushed);
+    entry.data.append(part.data);
+    entry.flushed += part.flushed;
+    entry.crc = crc32_combine(entry.crc, part.crc, part.size);
+    entry.size += part.size;
+}
+
+void ZipArchive::setThreads(int threads) {
+    this->threads = threads;
+}
+
+void ZipArchive::setCompression(const CompressionOptions& options) {
+    compression = options;
+}
+
+const CompressionOptions& ZipArchive::getCompression() const {
+    return compression;
+}
+
+void ZipArchive::fileInfo(zip_fileinfo& zi) {
+    time_t timeValue = time(0);
+#pragma warning (disable : 4996)
+    struct tm* timeStruct = localtime(&timeValue);
+#pragma warning (default : 4996)
+    zi.tmz_date.tm_sec = timeStruct->tm_sec;
+    zi.tmz_date.tm_min = timeStruct->tm_min;
+    zi.tmz_date.tm_hour = timeStruct->tm_hour;
+    zi.tmz_date.tm_mday = timeStruct->tm_mday;
+    zi.tmz_date.tm_mon = timeStruct->tm_mon;
+    zi.tmz_date.tm_year = timeStruct->tm_year + 1900;
+    zi.dosDate = 0;
+    zi.internal_fa = 0;
+    zi.external_fa = 0;
+}
+
+void ZipArchive::deflateEntry(const void* buffer, unsigned length,
+                              int flush) {
+    std::basic_string<char>& data = entries.back().data;
+    char out[DEFLATE_BUFFER_SIZE];
+    stream->next_in = (Bytef*)buffer;
+    stream->avail_in = length;
+    do {
+        stream->next_out = (Bytef*)out;
+        stream->avail_out = sizeof(out);
+        if (deflate(stream, flush) == Z_STREAM_ERROR) {
+            throw IOException(_T("error writing zip entry"));
+        }
+        data.append(out, sizeof(out) - stream->avail_out);
+    } while (stream->avail_out == 0);
+}
+
+void ZipArchive::writeDeflated() {
+    std::basic_string<char>& data = deflater->output();
+    if (data.empty()) {
+        return;
+    }
+    if (zipWriteInFileInZip(zf, data.data(), (unsigned)data.size()) < 0) {
+        throw IOException(_T("error writing zip entry"));
+    }
+    data.clear();
+}
+
 ZipArchive& operator << (ZipArchive& ar, int val) {
-    std::basic_stringstream<char> str;
-    str << val;
-    ar << str.str().c_str();
+    char buffer[NumberFormat::BUFFER_SIZE];
+    ar.write(buffer, NumberFormat::format((long)val, buffer));
     return ar;
 }
 
 ZipArchive& operator << (ZipArchive& ar, long val) {
-    std::basic_stringstream<char> str;
-    str << val;
-    ar << str.str().c_str();
+    char buffer[NumberFormat::BUFFER_SIZE];
+    ar.write(buffer, NumberFormat::format(val, buffer));
     return ar;
 }
 
 ZipArchive& operator << (ZipArchive& ar, double val) {
-    std::basic_stringstream<char> str;
-    str.precision(17);
-    str << val;
-    ar << str.str().c_str();
+    char buffer[NumberFormat::BUFFER_SIZE];
+    ar.write(buffer, NumberFormat::format(val, buffer));
     return ar;
 }
 
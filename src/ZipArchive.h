@@ -7,10 +7,25 @@
 
 #include "splib.h"
 #include "zip.h"
+#include <string>
+#include <vector>
 
 namespace splib {
 
-/** A writable zip archive. */
+class ParallelDeflater;
+
+/**
+ * A writable zip archive. An archive is either a file, or kept in memory
+ * until its entries are stored into a file archive; the entries of an
+ * archive in memory are compressed as they are written, so that several
+ * entries can be compressed at the same time by different threads, each
+ * into its own archive. The entries of a file archive can also be
+ * compressed by several threads, each compressing a part of the entry.
+ * <p>
+ * The deflate stream of an entry in memory is sync flushed before it is
+ * ended, so that the stream of another entry can be joined to it there;
+ * an entry can thus be written in parts that are compressed apart.
+ */
 class ZipArchive {
     public:
         /**
@@ -19,9 +34,20 @@ class ZipArchive {
          */
         ZipArchive(const _TCHAR* pathname);
 
+        /**
+         * Creates a new zip archive that is written to a sink. If the sink
+         * cannot seek, each entry is followed by its CRC-32 and sizes.
+         * @param sink the sink; must live until the archive is closed
+         */
+        ZipArchive(OutputSink& sink);
+
+        /** Creates a new zip archive in memory. */
+        ZipArchive();
+
         /**
          * Destructor. Closes the currently opened entry if it is not closed
-         * yet. Closes the archive if it is not closed yet.
+         * yet. Closes the archive if it is not closed yet. Errors are
+         * ignored.
          */
         virtual ~ZipArchive();
 
@@ -46,12 +72,120 @@ class ZipArchive {
          */
         void close();
 
+        /**
+         * Stores the entries of an archive in memory into this archive,
+         * in the order they were written, without compressing them again.
+         * @param ar the archive in memory; its last entry must be closed
+         */
+        void writeEntries(const ZipArchive& ar);
+
+        /**
+         * Appends the last entry of an archive in memory to the last entry
+         * of this archive in memory, without compressing it again. The
+         * deflate streams are joined at the sync flush that precedes the
+         * end of the first one, and their CRC-32 are combined.
+         * @param ar the archive in memory; its last entry must be closed
+         *        and have the compression method of the last entry of
+         *        this archive
+         * @throw IllegalStateException if either archive is not in memory,
+         *        has no entry, or has an opened entry
+         * @throw IllegalArgumentException if the compression methods of
+         *        the entries differ
+         */
+        void appendEntry(const ZipArchive& ar);
+
+        /**
+         * Sets the number of threads that compress the entries opened
+         * from now on. With more than one thread, the data of an entry is
+         * compressed in blocks, a batch of blocks at a time. Ignored by an
+         * archive in memory.
+         * @param threads the number of threads, including the calling one
+         */
+        void setThreads(int threads);
+
+        /**
+         * Sets the compression of the entries opened from now on. An entry
+         * of level <code>CompressionOptions::STORE</code> is stored without
+         * compression.
+         */
+        void setCompression(const CompressionOptions& options);
+
+        /** Retrieves the compression of the entries. */
+        const CompressionOptions& getCompression() const;
+
+    private:
+        /** An entry of an archive in memory */
+        struct Entry {
+            /** The name of the entry */
+            std::basic_string<char> name;
+
+            /** The compressed data */
+            std::basic_string<char> data;
+
+            /** The CRC-32 of the data before compression */
+            unsigned long crc;
+
+            /** The size of the data before compression */
+            unsigned long size;
+
+            /**
+             * The size of the compressed data up to the sync flush that
+             * precedes the end of the deflate stream
+             */
+            unsigned long flushed;
+
+            /** The compression method */
+            int method;
+
+            /** The compression level */
+            int level;
+        };
+
+        /** The entries of an archive in memory */
+        typedef std::vector<Entry> Entries;
+
+        /** The size of the buffer used to compress data in memory */
+        enum {DEFLATE_BUFFER_SIZE = 16384};
+
+        /** Fills in the file information of a new entry. */
+        static void fileInfo(zip_fileinfo& zi);
+
+        /**
+         * Compresses data into the current entry of an archive in memory.
+         * @param flush the flush parameter of <code>deflate()</code>
+         */
+        void deflateEntry(const void* buffer, unsigned length, int flush);
+
+        /** Writes the data compressed by the deflater into the entry. */
+        void writeDeflated();
+
     private:
         /** A handle to the underlying zip archive */
         zipFile zf;
 
         /** Indicates whether there is a currently opened entry */
         bool entryOpened;
+
+        /** Indicates whether the archive is kept in memory */
+        bool inMemory;
+
+        /** The entries of an archive in memory */
+        Entries entries;
+
+        /**
+         * The stream that compresses the current entry in memory, or 0
+         * if the entry is stored
+         */
+        z_stream* stream;
+
+        /** The compression of the entries */
+        CompressionOptions compression;
+
+        /** The number of threads that compress an entry of a file */
+        int threads;
+
+        /** The compressor of the current entry in blocks, or 0 */
+        ParallelDeflater* deflater;
 };
 
 // convenience operators
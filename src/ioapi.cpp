@@ -1,7 +1,7 @@
 /* 
   This file is copied from the minizip package
   (http://www.winimage.com/zLibDll/minizip.html) and modified to support
-  Unicode on Windows. Below is the original file header.
+  Unicode on Windows, and output sinks. Below is the original file header.
 */
 
 /* ioapi.c -- IO base function header for compress/uncompress .zip
@@ -190,3 +190,149 @@ void fill_fopen_filefunc (
     pzlib_filefunc_def->zerror_file = ferror_file_func;
     pzlib_filefunc_def->opaque = NULL;
 }
+
+
+/* The state of a stream that writes to an output sink */
+typedef struct sink_stream_s
+{
+    splib::OutputSink* sink;
+    uLong position;
+    int error;
+} sink_stream;
+
+voidpf ZCALLBACK sink_open_file_func (
+   voidpf opaque,
+   const _TCHAR* filename,
+   int mode)
+{
+    filename;
+    if ((mode & ZLIB_FILEFUNC_MODE_WRITE) == 0)
+        return NULL;
+    sink_stream* s = (sink_stream*)malloc(sizeof(sink_stream));
+    if (s != NULL)
+    {
+        s->sink = (splib::OutputSink*)opaque;
+        s->position = 0;
+        s->error = 0;
+    }
+    return s;
+}
+
+uLong ZCALLBACK sink_read_file_func (
+   voidpf opaque,
+   voidpf stream,
+   void* buf,
+   uLong size)
+{
+    opaque;
+    stream;
+    buf;
+    size;
+    return 0;
+}
+
+uLong ZCALLBACK sink_write_file_func (
+   voidpf opaque,
+   voidpf stream,
+   const void* buf,
+   uLong size)
+{
+    opaque;
+    sink_stream* s = (sink_stream*)stream;
+    try
+    {
+        s->sink->write(buf, (unsigned)size);
+    }
+    catch (...)
+    {
+        s->error = 1;
+        return 0;
+    }
+    s->position += size;
+    return size;
+}
+
+long ZCALLBACK sink_tell_file_func (
+   voidpf opaque,
+   voidpf stream)
+{
+    opaque;
+    return (long)((sink_stream*)stream)->position;
+}
+
+long ZCALLBACK sink_seek_file_func (
+   voidpf opaque,
+   voidpf stream,
+   uLong offset,
+   int origin)
+{
+    opaque;
+    sink_stream* s = (sink_stream*)stream;
+    uLong position;
+    switch (origin)
+    {
+    case ZLIB_FILEFUNC_SEEK_CUR :
+        position = s->position + offset;
+        break;
+    case ZLIB_FILEFUNC_SEEK_SET :
+        position = offset;
+        break;
+    default: return -1;
+    }
+    try
+    {
+        s->sink->seek(position);
+    }
+    catch (...)
+    {
+        s->error = 1;
+        return -1;
+    }
+    s->position = position;
+    return 0;
+}
+
+int ZCALLBACK sink_close_file_func (
+   voidpf opaque,
+   voidpf stream)
+{
+    opaque;
+    sink_stream* s = (sink_stream*)stream;
+    int ret = s->error ? -1 : 0;
+    if (ret == 0)
+    {
+        try
+        {
+            s->sink->flush();
+        }
+        catch (...)
+        {
+            ret = -1;
+        }
+    }
+    free(s);
+    return ret;
+}
+
+int ZCALLBACK sink_error_file_func (
+   voidpf opaque,
+   voidpf stream)
+{
+    opaque;
+    return ((sink_stream*)stream)->error;
+}
+
+void fill_sink_filefunc (
+  zlib_filefunc_def* pzlib_filefunc_def,
+  splib::OutputSink* sink)
+{
+    pzlib_filefunc_def->zopen_file = sink_open_file_func;
+    pzlib_filefunc_def->zread_file = sink_read_file_func;
+    pzlib_filefunc_def->zwrite_file = sink_write_file_func;
+    pzlib_filefunc_def->ztell_file = sink_tell_file_func;
+    pzlib_filefunc_def->zseek_file =
+        sink->isSeekable() ? sink_seek_file_func : NULL;
+    pzlib_filefunc_def->zclose_file = sink_close_file_func;
+    pzlib_filefunc_def->zerror_file = sink_error_file_func;
+    pzlib_filefunc_def->opaque = sink;
+}
@@ -66,6 +66,11 @@ typedef struct zlib_filefunc_def_s
 
 void fill_fopen_filefunc OF((zlib_filefunc_def* pzlib_filefunc_def));
 
+/* Fills in functions that write to an output sink, ignoring the file name.
+   The seek function is left NULL when the sink cannot seek. */
+void fill_sink_filefunc OF((zlib_filefunc_def* pzlib_filefunc_def,
+                            splib::OutputSink* sink));
+
 #define ZREAD(filefunc,filestream,buf,size) ((*((filefunc).zread_file))((filefunc).opaque,filestream,buf,size))
 #define ZWRITE(filefunc,filestream,buf,size) ((*((filefunc).zwrite_file))((filefunc).opaque,filestream,buf,size))
 #define ZTELL(filefunc,filestream) ((*((filefunc).ztell_file))((filefunc).opaque,filestream))
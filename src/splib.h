@@ -29,6 +29,7 @@ namespace splib {
 
 // forward declarations
 class Table;
+class StringPool;
 
 /**
  * A spreadsheet object. The spreadsheet consists of a number of tables.
@@ -49,6 +50,25 @@ class SPLIB_API Spreadsheet {
          */
         virtual Table& insertTable(int index, const _TCHAR* name) = 0;
 
+        /**
+         * Creates a new columnar table and inserts it into the spreadsheet.
+         * A columnar table stores its cells column by column in typed
+         * arrays, which makes it much more compact than the table created
+         * by insertTable() when the table holds mostly numbers. The
+         * <code>Cell</code> and <code>Row</code> references obtained from
+         * a columnar table are lightweight views that each thread reuses
+         * after a number of subsequent lookups, so they should not be
+         * kept for long.
+         * @param index the index at which to insert the table
+         * @param name a pointer to the name of the table
+         * @return a reference to the newly created table
+         * @throw IllegalArgumentException if <code>index</code> is negative
+         *        or greater than the value returned by tableCount();
+         *        or if <code>name</code> is 0;
+         *        or if a table with the specified name already exists
+         */
+        virtual Table& insertColumnarTable(int index, const _TCHAR* name) = 0;
+
         /**
          * Retrieves a table by index.
          * @param index the index at which to retrieve the table
@@ -109,12 +129,19 @@ class SPLIB_API Spreadsheet {
 
 // forward declarations
 class Cell;
+class CellValue;
+class Date;
+class TableStatistics;
 class Rows;
 class Columns;
 
 /**
  * A spreadsheet table. This interface provides methods for accessing
  * table cells as well as other table properties.
+ * <p>
+ * Column indices range from 0 to 16383 (A to XFD) and row indices from
+ * 0 to 1048575, the grid of the Excel 2007 format. Formats with smaller
+ * grids are checked when the spreadsheet is written.
  */
 class SPLIB_API Table {
     public:
@@ -176,7 +203,9 @@ class SPLIB_API Table {
         /**
          * Clears a rectangular range of cells. The range is identified by
          * the positions of the two corners of the rectangle. The rectangle
-         * does not have to be normalized.
+         * does not have to be normalized. The cost of the operation
+         * depends on the number of existing cells in the range, not on
+         * its area.
          * @param column1 column index of the top left corner of the range
          * @param row1 row index of the top left corner of the range
          * @param column2 column index of the bottom right corner of the range
@@ -204,6 +233,30 @@ class SPLIB_API Table {
         virtual void clearRange(const _TCHAR* columnrow1,
                                 const _TCHAR* columnrow2) = 0;
 
+        /**
+         * Removes a range of rows together with their cells and heights.
+         * The cost of the operation depends on the number of existing
+         * rows in the range, not on its length. The range does not have
+         * to be normalized.
+         * @param row1 index of the first row of the range
+         * @param row2 index of the last row of the range
+         * @throw IllegalArgumentException if <code>row1</code> or
+         *        <code>row2</code> is invalid
+         */
+        virtual void removeRows(int row1, int row2) = 0;
+
+        /**
+         * Removes a range of columns together with their cells and
+         * widths. Rows left without cells and without a custom height
+         * are removed as well, as <code>clearRange()</code> does. The
+         * range does not have to be normalized.
+         * @param column1 index of the first column of the range
+         * @param column2 index of the last column of the range
+         * @throw IllegalArgumentException if <code>column1</code> or
+         *        <code>column2</code> is invalid
+         */
+        virtual void removeColumns(int column1, int column2) = 0;
+
         /**
          * Determines if the specified position is empty.
          * @param column column index
@@ -226,6 +279,109 @@ class SPLIB_API Table {
          */
         virtual bool isEmptyCell(const _TCHAR* columnrow) const = 0;
 
+        /**
+         * Retrieves the cell at the specified position without creating
+         * it. Unlike <code>cell()</code>, this method allocates nothing
+         * and can be called by several threads at once.
+         * @param column column index
+         * @param row row index
+         * @return a pointer to the cell, or 0 if no cell exists at the
+         *         position
+         * @throw IllegalArgumentException if <code>column</code> or
+         *        <code>row</code> is invalid
+         */
+        virtual const Cell* findCell(int column, int row) const = 0;
+
+        /**
+         * Retrieves the cell at the specified position without creating
+         * it.
+         * @param columnrow a string in the
+         *        &lt;column&nbsp;letter(s)&gt;&lt;row&nbsp;number&gt; format
+         * @return a pointer to the cell, or 0 if no cell exists at the
+         *         position
+         * @throw IllegalArgumentException if <code>columnrow</code> is
+         *        invalid
+         */
+        virtual const Cell* findCell(const _TCHAR* columnrow) const = 0;
+
+        /**
+         * Sets the values of a number of consecutive cells of a row.
+         * The row and the cells are created as necessary. Values of
+         * type <code>Cell::NONE</code> leave their cells untouched.
+         * This method validates the indices once and allocates the cells
+         * in bulk, so it is much faster than setting the cells one by one.
+         * @param row the row index
+         * @param first the column index of the first cell to set
+         * @param values a pointer to the array of values
+         * @param count the number of values
+         * @throw IllegalArgumentException if <code>row</code> is not valid;
+         *        or if <code>count</code> is positive and any of the
+         *        column indices <code>first</code> to
+         *        <code>first + count - 1</code> is not valid;
+         *        or if <code>count</code> is negative;
+         *        or if <code>values</code> is 0 and <code>count</code>
+         *        is positive;
+         *        or if a formula value is not valid
+         */
+        virtual void setRow(int row, int first, const CellValue* values,
+                            int count) = 0;
+
+        /**
+         * Appends a row after the last row of the table and sets the
+         * values of its cells starting from the first column.
+         * @param values a pointer to the array of values
+         * @param count the number of values
+         * @return the index of the new row
+         * @throw IllegalArgumentException if the table has no room for
+         *        another row; or for any of the reasons listed for
+         *        setRow()
+         */
+        virtual int appendRow(const CellValue* values, int count) = 0;
+
+        /**
+         * Sets the cells of a rectangular region to numbers of type
+         * <code>Cell::DOUBLE</code>. The value of the cell at column
+         * <code>column + i</code> and row <code>row + j</code> is
+         * <code>values[j * stride + i]</code>; the rows and the cells are
+         * created as necessary. Like <code>setRow()</code>, this method
+         * validates the region once and allocates the cells in bulk.
+         * @param column the index of the leftmost column of the region
+         * @param row the index of the topmost row of the region
+         * @param width the number of columns of the region
+         * @param height the number of rows of the region
+         * @param values a pointer to the first value
+         * @param stride the distance between the first values of two
+         *        consecutive rows, in array elements
+         * @throw IllegalArgumentException if <code>width</code> or
+         *        <code>height</code> is negative;
+         *        or if the region is not empty and any of its corners is
+         *        not a valid position;
+         *        or if <code>values</code> is 0 and the region is not empty
+         */
+        virtual void setRange(int column, int row, int width, int height,
+                              const double* values, int stride) = 0;
+
+        /**
+         * Sets the cells of a rectangular region to numbers of type
+         * <code>Cell::LONG</code>. See the <code>double</code> variant.
+         */
+        virtual void setRange(int column, int row, int width, int height,
+                              const long* values, int stride) = 0;
+
+        /**
+         * Sets the cells of a rectangular region to texts. A null text
+         * pointer sets an empty text. See the <code>double</code> variant.
+         */
+        virtual void setRange(int column, int row, int width, int height,
+                              const _TCHAR* const* values, int stride) = 0;
+
+        /**
+         * Sets the cells of a rectangular region to dates. See the
+         * <code>double</code> variant.
+         */
+        virtual void setRange(int column, int row, int width, int height,
+                              const Date* values, int stride) = 0;
+
         /**
          * Determines the first (leftmost) table column containing
          * non-empty cells.
@@ -258,18 +414,38 @@ class SPLIB_API Table {
          */
         virtual int lastRow() const = 0;
 
+        /**
+         * Returns the statistics of the cells of the table. The table
+         * keeps them up to date as cells are created, changed, and
+         * removed, so reading them costs nothing.
+         * @return a reference to the statistics
+         */
+        virtual const TableStatistics& statistics() const = 0;
+
         /**
          * Retrieves the collection of rows.
          * @return collection of rows.
          */
         virtual Rows& rows() = 0;
 
+        /**
+         * Retrieves the collection of rows for reading.
+         * @return collection of rows.
+         */
+        virtual const Rows& rows() const = 0;
+
         /**
          * Retrieves the collection of columns.
          * @return collection of columns.
          */
         virtual Columns& columns() = 0;
 
+        /**
+         * Retrieves the collection of columns for reading.
+         * @return collection of columns.
+         */
+        virtual const Columns& columns() const = 0;
+
         /**
          * Retrieves the name of the table.
          * @return a pointer to the string containing the name of the table
@@ -359,11 +535,11 @@ class SPLIB_API Cell {
          * The method succeeds if the current cell type is
          * <code>DATE</code>, otherwise IllegalStateException
          * is thrown.
-         * @return the date stored in the cell
+         * @return a copy of the date stored in the cell
          * @throw IllegalStateException if the current cell type is not
          *        <code>DATE</code>
          */
-        virtual const Date& getDate() const = 0;
+        virtual Date getDate() const = 0;
 
         /**
          * Sets the cell type to <code>DATE</code> and updates the date
@@ -377,11 +553,11 @@ class SPLIB_API Cell {
          * The method succeeds if the current cell type is
          * <code>TIME</code>, otherwise IllegalStateException
          * is thrown.
-         * @return the time stored in the cell
+         * @return a copy of the time stored in the cell
          * @throw IllegalStateException if the current cell type is not
          *        <code>DATE</code>
          */
-        virtual const Time& getTime() const = 0;
+        virtual Time getTime() const = 0;
 
         /**
          * Sets the cell type to <code>TIME</code> and updates the time
@@ -502,9 +678,61 @@ class SPLIB_API Cell {
         virtual ~Cell() {}
 };
 
+/**
+ * The numbers of cells of a table, in total and by type, as returned by
+ * <code>Table::statistics()</code>. Writers use them, for example, to
+ * preallocate their buffers.
+ */
+class TableStatistics {
+    public:
+        /**
+         * Returns the number of cells of the table, empty ones included.
+         * @return the number of cells
+         */
+        int getCellCount() const {
+            return total;
+        }
+
+        /**
+         * Returns the number of cells of a specific type.
+         * @param type the cell type
+         * @return the number of cells of type <code>type</code>
+         */
+        int getCellCount(Cell::Type type) const {
+            return counts[type];
+        }
+
+    protected:
+        /** The number of cell types */
+        enum {TYPE_COUNT = Cell::FORMULA + 1};
+
+        /** Creates statistics of an empty table. */
+        TableStatistics() : total(0) {
+            for (int i = 0; i < TYPE_COUNT; i++) {
+                counts[i] = 0;
+            }
+        }
+
+    protected:
+        /** The number of cells of each type */
+        int counts[TYPE_COUNT];
+
+        /** The number of cells */
+        int total;
+};
+
 /**
  * An indexed collection of objects. Each object is accessible by an integer
  * index. The objects are kept sorted by their indices.
+ * <p>
+ * The const methods neither create objects nor allocate memory, so any
+ * number of threads may call them at once as long as no thread modifies
+ * the collection. They also allow iterating without an iterator:
+ * <pre>
+ * for (int i = c.next(0); i != -1; i = c.next(i + 1)) {
+ *     const T* object = c.find(i);
+ * }
+ * </pre>
  */
 template<class T>
 class IndexedCollection {
@@ -596,7 +824,24 @@ class IndexedCollection {
          * @return true if this collection contains the specified index,
          *         false otherwise
          */
-        virtual bool contains(int index) = 0;
+        virtual bool contains(int index) const = 0;
+
+        /**
+         * Retrieves an object by index without creating it.
+         * @param index index of the object
+         * @return a pointer to the object, or 0 if this collection does
+         *         not contain the specified index
+         */
+        virtual const T* find(int index) const = 0;
+
+        /**
+         * Finds the smallest index of an object that is not less than
+         * a specified index.
+         * @param index the index to start from; may be past the valid
+         *        indices
+         * @return the index of the object, or -1 if there is none
+         */
+        virtual int next(int index) const = 0;
 
         /**
          * Removes the object with the given index if it is present in this
@@ -677,6 +922,12 @@ class SPLIB_API Row {
          */
         virtual Cells& cells() = 0;
 
+        /**
+         * Returns the collection of cells of this row for reading.
+         * @return the collection of cells of this row
+         */
+        virtual const Cells& cells() const = 0;
+
         /** Empty virtual destructor */
         virtual ~Row() {}
 };
@@ -1033,6 +1284,230 @@ class SPLIB_API Time {
 #pragma warning (default: 4251)
 };
 
+/**
+ * A destination of the bytes of a file, to write a file to something other
+ * than a path name. The writers write a file from its start to its end;
+ * a sink that can move back to an earlier position lets them complete
+ * headers in place. Otherwise, each entry of a zip package is followed by
+ * its sizes, and the workbook stream of an xls file is kept in memory
+ * until the file is complete, since the header of the file precedes it.
+ */
+class SPLIB_API OutputSink {
+    public:
+        /**
+         * Writes bytes at the current position, and moves the position
+         * past them.
+         * @param data a pointer to the bytes to write
+         * @param length the number of bytes to write
+         * @throw IOException if writing fails
+         */
+        virtual void write(const void* data, unsigned length) = 0;
+
+        /**
+         * Checks whether the sink can move to an earlier position. This
+         * implementation returns <code>false</code>.
+         */
+        virtual bool isSeekable() const;
+
+        /**
+         * Moves the current position. This implementation throws
+         * <code>IllegalStateException</code>.
+         * @param position the new position, from the first byte written
+         *        to the sink; not past the last byte written
+         * @throw IOException if seeking fails
+         * @throw IllegalStateException if the sink cannot seek
+         */
+        virtual void seek(unsigned long position);
+
+        /**
+         * Called when the file is complete. This implementation does
+         * nothing.
+         * @throw IOException if writing fails
+         */
+        virtual void flush();
+
+        /** Empty virtual destructor */
+        virtual ~OutputSink() {}
+};
+
+/**
+ * A sink that keeps a file in memory. The sink can seek.
+ */
+class SPLIB_API MemorySink : public OutputSink {
+    public:
+        /** Creates an empty sink. */
+        MemorySink();
+
+        // inherit doc
+        virtual void write(const void* data, unsigned length);
+
+        // inherit doc
+        virtual bool isSeekable() const;
+
+        // inherit doc
+        virtual void seek(unsigned long position);
+
+        /**
+         * Retrieves the bytes written.
+         * @return a pointer to the bytes, valid until the sink is modified
+         *         or destroyed; 0 if the sink is empty
+         */
+        const unsigned char* getData() const;
+
+        /** Retrieves the number of bytes written. */
+        unsigned long getSize() const;
+
+        /** Discards the bytes written, to reuse the sink. */
+        void clear();
+
+    private:
+#pragma warning (disable: 4251)
+        /** The bytes written */
+        std::vector<unsigned char> data;
+#pragma warning (default: 4251)
+
+        /** The current position */
+        unsigned long position;
+};
+
+/**
+ * A sink that writes to a file descriptor that is already open, such as
+ * that of a file, a pipe, or a socket. The sink can seek if the file
+ * descriptor can; positions are counted from the position of the file
+ * descriptor when the sink is created.
+ */
+class SPLIB_API FileDescriptorSink : public OutputSink {
+    public:
+        /**
+         * Creates a new instance of <code>FileDescriptorSink</code>.
+         * @param fd the file descriptor, open for writing; it is not
+         *        closed by the sink
+         */
+        explicit FileDescriptorSink(int fd);
+
+        // inherit doc
+        virtual void write(const void* data, unsigned length);
+
+        // inherit doc
+        virtual bool isSeekable() const;
+
+        // inherit doc
+        virtual void seek(unsigned long position);
+
+    private:
+        /** The file descriptor */
+        int fd;
+
+        /** The offset of the first byte written, or -1 if not seekable */
+        long start;
+};
+
+/**
+ * A sink that passes the bytes to a function supplied by the user, for
+ * example one that sends them to the body of an HTTP response. The sink
+ * cannot seek.
+ */
+class SPLIB_API CallbackSink : public OutputSink {
+    public:
+        /**
+         * The function that receives the bytes, in order.
+         * @param context the context passed to the constructor
+         * @param data a pointer to the bytes
+         * @param length the number of bytes
+         * @return <code>true</code> if the bytes have been consumed;
+         *         <code>false</code> makes the writer fail
+         */
+        typedef bool (*Callback)(void* context, const void* data,
+                                 unsigned length);
+
+        /**
+         * Creates a new instance of <code>CallbackSink</code>.
+         * @param callback the function that receives the bytes
+         * @param context a value passed to the function
+         * @throw IllegalArgumentException if <code>callback</code> is 0
+         */
+        CallbackSink(Callback callback, void* context);
+
+        // inherit doc
+        virtual void write(const void* data, unsigned length);
+
+    private:
+        /** The function that receives the bytes */
+        Callback callback;
+
+        /** The value passed to the function */
+        void* context;
+};
+
+/**
+ * The compression of the entries of a zip package, such as an xlsx or an
+ * ods file. Levels go from 1, the fastest, to 9, the smallest output;
+ * 0 stores the entries without compressing them, and -1 is the default
+ * of zlib. A level can be set for the entries whose names start with a
+ * prefix, for example "xl/worksheets/" for the sheets of an xlsx file,
+ * or "content.xml" for the tables of an ods file; the longest prefix that
+ * matches the name of an entry applies.
+ */
+class SPLIB_API CompressionOptions {
+    public:
+        /** Levels with a special meaning */
+        enum {
+            DEFAULT_LEVEL = -1,
+            STORE = 0,
+            BEST_SPEED = 1,
+            BEST_COMPRESSION = 9
+        };
+
+    public:
+        /**
+         * Creates a new instance of <code>CompressionOptions</code>.
+         * @param level the level of all entries
+         * @throw IllegalArgumentException if the level is invalid
+         */
+        explicit CompressionOptions(int level = DEFAULT_LEVEL);
+
+        /**
+         * Sets the level of the entries that no prefix matches.
+         * @throw IllegalArgumentException if the level is invalid
+         */
+        void setLevel(int level);
+
+        /** Retrieves the level of the entries that no prefix matches. */
+        int getLevel() const;
+
+        /**
+         * Sets the level of the entries whose names start with a prefix,
+         * replacing the level set before for the same prefix.
+         * @param prefix a pointer to the prefix
+         * @param level the level of the entries
+         * @throw IllegalArgumentException if <code>prefix</code> is 0 or
+         *        the level is invalid
+         */
+        void setEntryLevel(const char* prefix, int level);
+
+        /** Removes the levels set for prefixes. */
+        void clearEntryLevels();
+
+        /**
+         * Retrieves the level that applies to an entry.
+         * @param entryName a pointer to the name of the entry
+         */
+        int getEntryLevel(const char* entryName) const;
+
+    private:
+        /** Checks a level. */
+        static void checkLevel(int level);
+
+    private:
+        /** The level of the entries that no prefix matches */
+        int level;
+
+#pragma warning (disable: 4251)
+        /** The prefixes and their levels */
+        std::vector<std::pair<std::string, int> > entryLevels;
+#pragma warning (default: 4251)
+};
+
 /** An object that can output a spreadsheet to a file. */
 class SPLIB_API Writer {
     public:
@@ -1042,10 +1517,22 @@ class SPLIB_API Writer {
          * @param pathname a pointer to a 0-terminated path name
          *        to a file to write the spreadsheet to
          * @throws IOException if file creation or writing fails
+         * @throws IllegalArgumentException if a table exceeds the grid
+         *         of the format
          */
         virtual void write(Spreadsheet& spreadsheet,
                            const _TCHAR* pathname) = 0;
 
+        /**
+         * Writes a spreadsheet to a sink.
+         * @param spreadsheet the spreadsheet to write
+         * @param sink the sink to write the file to
+         * @throws IOException if writing fails
+         * @throws IllegalArgumentException if a table exceeds the grid
+         *         of the format
+         */
+        virtual void write(Spreadsheet& spreadsheet, OutputSink& sink) = 0;
+
         /** Empty virtual destructor */
         virtual ~Writer() {}
 };
@@ -1062,6 +1549,9 @@ class SPLIB_API SpreadsheetImpl : public Spreadsheet {
         // inherit doc
         virtual Table& insertTable(int index, const _TCHAR* name);
 
+        // inherit doc
+        virtual Table& insertColumnarTable(int index, const _TCHAR* name);
+
         // inherit doc
         virtual Table& table(int index);
 
@@ -1084,32 +1574,386 @@ class SPLIB_API SpreadsheetImpl : public Spreadsheet {
         /** Finds a table with the specified name and returns its index. */
         int find(const _TCHAR* name);
 
+        /** Validates the arguments of the table insertion methods. */
+        void checkInsert(int index, const _TCHAR* name);
+
     private:
 #pragma warning (disable: 4251)
         /** The collection of tables. */
         std::vector<Table*> tables;
 #pragma warning (default: 4251)
+
+        /** The pool of the texts and formulas of all tables. */
+        StringPool* strings;
 };
 
-/** Writer that outputs spreadsheets in Excel 97/2000 format. */
+/**
+ * Writer that outputs spreadsheets in Excel 97/2000 format. The tables
+ * must fit a grid of 256 columns and 65536 rows.
+ */
 class SPLIB_API XlsWriter : public Writer {
     public:
         // inherit doc
         virtual void write(Spreadsheet& spreadsheet, const _TCHAR* pathname);
+
+        // inherit doc
+        virtual void write(Spreadsheet& spreadsheet, OutputSink& sink);
 };
 
-/** Writer that outputs spreadsheets in Excel 2007 format. */
+/**
+ * Writer that outputs spreadsheets in Excel 2007 format. The sheets can
+ * be written by several threads at the same time, each sheet being
+ * compressed into memory by one of them; the sheets are then stored
+ * into the file in order. A spreadsheet with a single sheet is instead
+ * compressed by all the threads, in blocks. The spreadsheet must not be
+ * modified while it is written.
+ */
 class SPLIB_API XlsxWriter : public Writer {
     public:
+        /** Creates a writer that writes on the calling thread only. */
+        XlsxWriter();
+
+        /**
+         * Sets the number of threads that write the sheets. With more
+         * than one thread, memory use grows by the compressed size of
+         * the sheets.
+         * @param threads the number of threads, including the calling
+         *        one; 1 writes the sheets on the calling thread; 0 uses
+         *        one thread per processor
+         * @throw IllegalArgumentException if <code>threads</code> is
+         *        negative
+         */
+        void setThreads(int threads);
+
+        /**
+         * Retrieves the number of threads that write the sheets.
+         * @return the number of threads, or 0 for one per processor
+         */
+        int getThreads() const;
+
+        /**
+         * Sets the compression of the entries of the package. The sheets
+         * are the entries whose names start with "xl/worksheets/".
+         */
+        void setCompression(const CompressionOptions& compression);
+
+        /** Retrieves the compression of the entries of the package. */
+        const CompressionOptions& getCompression() const;
+
+        /**
+         * Sets whether texts are written into a shared string table. The
+         * distinct texts of the spreadsheet are then written once, into
+         * the entry "xl/sharedStrings.xml", and the cells refer to them
+         * by index, which makes repeated texts cheaper to store and to
+         * load. Otherwise, which is the default, each cell holds its text.
+         */
+        void setSharedStrings(bool sharedStrings);
+
+        /** Indicates whether texts are written into a shared string table. */
+        bool getSharedStrings() const;
+
+        /**
+         * Sets whether the sheets are written in a compact encoding: the
+         * markup has no whitespace between elements, the rows and cells
+         * that follow the previous ones have no reference, the
+         * neighboring columns of equal widths are written as ranges, and
+         * the rows have spans hints. The sheets are then smaller to
+         * compress and to load. The default is the usual encoding, with
+         * one element per line and all references written.
+         */
+        void setCompact(bool compact);
+
+        /** Indicates whether the sheets are written in a compact encoding. */
+        bool getCompact() const;
+
         // inherit doc
         virtual void write(Spreadsheet& spreadsheet, const _TCHAR* pathname);
+
+        // inherit doc
+        virtual void write(Spreadsheet& spreadsheet, OutputSink& sink);
+
+    private:
+        /** The number of threads, or 0 for one per processor */
+        int threads;
+
+        /** The compression of the entries */
+        CompressionOptions compression;
+
+        /** Indicates whether texts are written into a shared string table */
+        bool sharedStrings;
+
+        /** Indicates whether the sheets are written in a compact encoding */
+        bool compact;
 };
 
-/** Writer that outputs spreadsheets in OpenDocument format. */
+/**
+ * Writer that outputs spreadsheets in OpenDocument format. The tables
+ * must fit a grid of 1024 columns and 1048576 rows, which is what
+ * OpenOffice.org Calc reads.
+ */
 class SPLIB_API OdsWriter : public Writer {
     public:
+        /**
+         * Sets the compression of the entries of the package. The tables
+         * are in the entry named "content.xml".
+         */
+        void setCompression(const CompressionOptions& compression);
+
+        /** Retrieves the compression of the entries of the package. */
+        const CompressionOptions& getCompression() const;
+
         // inherit doc
         virtual void write(Spreadsheet& spreadsheet, const _TCHAR* pathname);
+
+        // inherit doc
+        virtual void write(Spreadsheet& spreadsheet, OutputSink& sink);
+
+    private:
+        /** The compression of the entries */
+        CompressionOptions compression;
+};
+
+/**
+ * An object that writes a spreadsheet to a file as it is produced,
+ * without keeping it in memory. The sheets are written one after another,
+ * and the rows of a sheet in ascending order:
+ * <pre>
+ * writer.beginSheet(name);
+ * writer.setColumnWidth(0, 40);
+ * for (int row = 0; row < rows; row++) {
+ *     writer.writeRow(row, 0, values, count);
+ * }
+ * writer.endSheet();
+ * writer.close();
+ * </pre>
+ * Cells are written with the default alignments. Row and column indices
+ * are valid if they fit the grid of the format written.
+ */
+class SPLIB_API StreamWriter {
+    public:
+        /**
+         * Starts a new sheet.
+         * @param name a pointer to the name of the sheet
+         * @throw IllegalArgumentException if <code>name</code> is 0 or
+         *        a sheet with the specified name has already been started
+         * @throw IllegalStateException if a sheet is being written or the
+         *        writer is closed
+         */
+        virtual void beginSheet(const _TCHAR* name) = 0;
+
+        /**
+         * Sets the width of a column of the current sheet. The widths
+         * must be set before the first row of the sheet is written.
+         * @param column column index
+         * @param width the width of the column, or a negative value for
+         *        the default width
+         * @throw IllegalArgumentException if <code>column</code> is invalid
+         * @throw IllegalStateException if no sheet is being written or
+         *        a row of the sheet has already been written
+         */
+        virtual void setColumnWidth(int column, double width) = 0;
+
+        /**
+         * Sets the height of a row of the current sheet. The row must not
+         * have been written yet; it is written, without cells unless
+         * <code>writeRow()</code> follows for it, before any later row.
+         * @param row row index
+         * @param height the height of the row
+         * @throw IllegalArgumentException if <code>row</code> is invalid
+         *        or not greater than the last row written
+         * @throw IllegalStateException if no sheet is being written
+         */
+        virtual void setRowHeight(int row, double height) = 0;
+
+        /**
+         * Writes a row of the current sheet. The row index must be greater
+         * than that of any row written before to the sheet. Values of type
+         * <code>Cell::NONE</code> leave their cells empty.
+         * @param row row index
+         * @param first the column index of the first value
+         * @param values a pointer to an array of <code>count</code> values
+         * @param count the number of values
+         * @throw IllegalArgumentException if <code>row</code> is invalid
+         *        or not greater than the last row written;
+         *        if <code>first</code> or <code>first + count - 1</code>
+         *        is invalid; if <code>count</code> is negative;
+         *        if <code>values</code> is 0 and <code>count</code> is
+         *        positive; or if a formula value is not valid
+         * @throw IllegalStateException if no sheet is being written
+         * @throw IOException if writing fails
+         */
+        virtual void writeRow(int row, int first, const CellValue* values,
+                              int count) = 0;
+
+        /**
+         * Finishes the current sheet.
+         * @throw IllegalStateException if no sheet is being written
+         * @throw IOException if writing fails
+         */
+        virtual void endSheet() = 0;
+
+        /**
+         * Finishes the current sheet, if any, and the file.
+         * @throw IllegalStateException if the writer is already closed
+         * @throw IOException if writing fails
+         */
+        virtual void close() = 0;
+
+        /** Empty virtual destructor */
+        virtual ~StreamWriter() {}
+};
+
+// forward declarations
+class XlsxStreamWriterImpl;
+class OdsStreamWriterImpl;
+
+/**
+ * Stream writer that outputs spreadsheets in Excel 2007 format. The rows
+ * are compressed into the file as they are written, so memory use does
+ * not depend on the size of the spreadsheet.
+ */
+class SPLIB_API XlsxStreamWriter : public StreamWriter {
+    public:
+        /**
+         * Creates the file and opens it for writing.
+         * @param pathname a pointer to a 0-terminated path name
+         *        of the file to write
+         * @throw IOException if the file cannot be created
+         */
+        XlsxStreamWriter(const _TCHAR* pathname);
+
+        /**
+         * Creates a writer that writes to a sink.
+         * @param sink the sink to write the file to; must live until the
+         *        writer is closed
+         */
+        XlsxStreamWriter(OutputSink& sink);
+
+        /**
+         * Destructor. Closes the writer unless it is closed; errors are
+         * ignored, so call <code>close()</code> to detect them.
+         */
+        virtual ~XlsxStreamWriter();
+
+        /**
+         * Sets the compression of the entries opened from now on; set it
+         * before the first sheet to apply it to all entries.
+         */
+        void setCompression(const CompressionOptions& compression);
+
+        /**
+         * Sets whether the texts of the rows written from now on go into
+         * a shared string table, as with <code>XlsxWriter</code>; set it
+         * before the first sheet to apply it to all texts. The table is
+         * kept in memory until the writer is closed, so memory use grows
+         * with the number of distinct texts.
+         */
+        void setSharedStrings(bool sharedStrings);
+
+        /**
+         * Sets whether the sheets begun from now on are written in the
+         * compact encoding of <code>XlsxWriter</code>. The sheets have
+         * no dimension, since it is not known when they are begun.
+         */
+        void setCompact(bool compact);
+
+        // inherit doc
+        virtual void beginSheet(const _TCHAR* name);
+
+        // inherit doc
+        virtual void setColumnWidth(int column, double width);
+
+        // inherit doc
+        virtual void setRowHeight(int row, double height);
+
+        // inherit doc
+        virtual void writeRow(int row, int first, const CellValue* values,
+                              int count);
+
+        // inherit doc
+        virtual void endSheet();
+
+        // inherit doc
+        virtual void close();
+
+    private:
+        /** Not implemented; writers are not copied */
+        XlsxStreamWriter(const XlsxStreamWriter&);
+
+        /** Not implemented; writers are not copied */
+        XlsxStreamWriter& operator = (const XlsxStreamWriter&);
+
+    private:
+        /** The implementation of the writer */
+        XlsxStreamWriterImpl* impl;
+};
+
+/**
+ * Stream writer that outputs spreadsheets in OpenDocument format, on the
+ * grid of <code>OdsWriter</code>. The styles of the row heights and column
+ * widths precede the tables in the file, so the tables are compressed into
+ * memory as they arrive and stored into the file, after the styles, when
+ * the writer is closed; memory use grows with the compressed size of the
+ * tables, without temporary files.
+ */
+class SPLIB_API OdsStreamWriter : public StreamWriter {
+    public:
+        /**
+         * Creates the file and opens it for writing.
+         * @param pathname a pointer to a 0-terminated path name
+         *        of the file to write
+         * @throw IOException if the file cannot be created
+         */
+        OdsStreamWriter(const _TCHAR* pathname);
+
+        /**
+         * Creates a writer that writes to a sink.
+         * @param sink the sink to write the file to; must live until the
+         *        writer is closed
+         */
+        OdsStreamWriter(OutputSink& sink);
+
+        /**
+         * Destructor. Closes the writer unless it is closed; errors are
+         * ignored, so call <code>close()</code> to detect them.
+         */
+        virtual ~OdsStreamWriter();
+
+        /**
+         * Sets the compression of the entries opened from now on; set it
+         * before the first sheet to apply it to all entries.
+         */
+        void setCompression(const CompressionOptions& compression);
+
+        // inherit doc
+        virtual void beginSheet(const _TCHAR* name);
+
+        // inherit doc
+        virtual void setColumnWidth(int column, double width);
+
+        // inherit doc
+        virtual void setRowHeight(int row, double height);
+
+        // inherit doc
+        virtual void writeRow(int row, int first, const CellValue* values,
+                              int count);
+
+        // inherit doc
+        virtual void endSheet();
+
+        // inherit doc
+        virtual void close();
+
+    private:
+        /** Not implemented; writers are not copied */
+        OdsStreamWriter(const OdsStreamWriter&);
+
+        /** Not implemented; writers are not copied */
+        OdsStreamWriter& operator = (const OdsStreamWriter&);
+
+    private:
+        /** The implementation of the writer */
+        OdsStreamWriterImpl* impl;
 };
 
 /**
@@ -1203,6 +2047,192 @@ class SPLIB_API IOException : public ExceptionImpl {
         IOException(const _TCHAR* message);
 };
 
+/**
+ * A typed value to be stored in a cell. Arrays of values are passed to
+ * the methods that set many cells at once, such as
+ * <code>Table::setRow()</code>. A value copies the date or time it is
+ * created from, but not the text or formula; these must stay valid as
+ * long as the value is used.
+ */
+class CellValue {
+    public:
+        /** Creates a value of type <code>Cell::NONE</code>. */
+        CellValue() : type(Cell::NONE) {}
+
+        /**
+         * Creates a value of type <code>Cell::LONG</code>.
+         * @param l the value
+         */
+        CellValue(int l) : type(Cell::LONG) {value.longValue = l;}
+
+        /**
+         * Creates a value of type <code>Cell::LONG</code>.
+         * @param l the value
+         */
+        CellValue(long l) : type(Cell::LONG) {value.longValue = l;}
+
+        /**
+         * Creates a value of type <code>Cell::DOUBLE</code>.
+         * @param d the value
+         */
+        CellValue(double d) : type(Cell::DOUBLE) {value.doubleValue = d;}
+
+        /**
+         * Creates a value of type <code>Cell::TEXT</code>.
+         * @param text a pointer to the text; 0 stands for an empty text
+         */
+        CellValue(const _TCHAR* text) : type(Cell::TEXT) {
+            value.text = text;
+        }
+
+        /**
+         * Creates a value of type <code>Cell::DATE</code>.
+         * @param date the date
+         */
+        CellValue(const Date& date) : type(Cell::DATE) {
+            value.date.year = date.getYear();
+            value.date.month = (short)date.getMonth();
+            value.date.day = (short)date.getDay();
+        }
+
+        /**
+         * Creates a value of type <code>Cell::TIME</code>.
+         * @param time the time
+         */
+        CellValue(const Time& time) : type(Cell::TIME) {
+            value.time.hours = (short)time.getHours();
+            value.time.minutes = (short)time.getMinutes();
+            value.time.seconds = (short)time.getSeconds();
+            value.time.millis = (short)time.getMillis();
+        }
+
+        /**
+         * Creates a value of type <code>Cell::FORMULA</code>.
+         * @param formula a pointer to the formula
+         * @return the value
+         */
+        static CellValue formula(const _TCHAR* formula) {
+            CellValue res;
+            res.type = Cell::FORMULA;
+            res.value.text = formula;
+            return res;
+        }
+
+        /**
+         * Creates a value holding the value of a cell. Texts and formulas
+         * are referenced, not copied, so the value is valid only as long
+         * as the cell keeps its text or formula.
+         * @param cell the cell
+         * @return the value
+         */
+        static CellValue of(const Cell& cell) {
+            switch (cell.getType()) {
+                case Cell::TEXT:    return CellValue(cell.getText());
+                case Cell::LONG:    return CellValue(cell.getLong());
+                case Cell::DOUBLE:  return CellValue(cell.getDouble());
+                case Cell::DATE:    return CellValue(cell.getDate());
+                case Cell::TIME:    return CellValue(cell.getTime());
+                case Cell::FORMULA: return formula(cell.getFormula());
+                default:            return CellValue();
+            }
+        }
+
+        /** Retrieves the type of the value. */
+        Cell::Type getType() const {return type;}
+
+        /**
+         * Retrieves a long value.
+         * @throw IllegalStateException if the type is not
+         *        <code>Cell::LONG</code>
+         */
+        long getLong() const {
+            check(Cell::LONG);
+            return value.longValue;
+        }
+
+        /**
+         * Retrieves a double value.
+         * @throw IllegalStateException if the type is not
+         *        <code>Cell::DOUBLE</code>
+         */
+        double getDouble() const {
+            check(Cell::DOUBLE);
+            return value.doubleValue;
+        }
+
+        /**
+         * Retrieves a text value.
+         * @return a pointer to the text; may be 0
+         * @throw IllegalStateException if the type is not
+         *        <code>Cell::TEXT</code>
+         */
+        const _TCHAR* getText() const {
+            check(Cell::TEXT);
+            return value.text;
+        }
+
+        /**
+         * Retrieves a date value.
+         * @throw IllegalStateException if the type is not
+         *        <code>Cell::DATE</code>
+         */
+        Date getDate() const {
+            check(Cell::DATE);
+            return Date(value.date.year, value.date.month, value.date.day);
+        }
+
+        /**
+         * Retrieves a time value.
+         * @throw IllegalStateException if the type is not
+         *        <code>Cell::TIME</code>
+         */
+        Time getTime() const {
+            check(Cell::TIME);
+            return Time(value.time.hours, value.time.minutes,
+                        value.time.seconds, value.time.millis);
+        }
+
+        /**
+         * Retrieves a formula value.
+         * @throw IllegalStateException if the type is not
+         *        <code>Cell::FORMULA</code>
+         */
+        const _TCHAR* getFormula() const {
+            check(Cell::FORMULA);
+            return value.text;
+        }
+
+    private:
+        /** Throws an exception unless the value is of a specific type. */
+        void check(Cell::Type t) const {
+            if (type != t) {
+                throw IllegalStateException();
+            }
+        }
+
+    private:
+        /** The type of the value */
+        Cell::Type type;
+
+        /** The set of possible values */
+        union {
+            long longValue;
+            double doubleValue;
+            const _TCHAR* text;
+            struct {
+                int year;
+                short month;
+                short day;
+            } date;
+            struct {
+                short hours;
+                short minutes;
+                short seconds;
+                short millis;
+            } time;
+        } value;
+};
+
 }
 
 #endif // SPLIB_H
@@ -1,7 +1,9 @@
 /* 
   This file is copied from the minizip package
   (http://www.winimage.com/zLibDll/minizip.html) and modified to support
-  Unicode on Windows. Below is the original file header.
+  Unicode on Windows, and streams that cannot seek: when the seek function
+  is NULL, the entries are followed by data descriptors. Below is the
+  original file header.
 */
 
 /* zip.c -- IO on .zip files using zlib
@@ -94,6 +96,7 @@ const char zip_copyright[] =
 #define LOCALHEADERMAGIC    (0x04034b50)
 #define CENTRALHEADERMAGIC  (0x02014b50)
 #define ENDHEADERMAGIC      (0x06054b50)
+#define DATADESCRIPTORMAGIC (0x08074b50)
 
 #define FLAG_LOCALHEADER_OFFSET (0x06)
 #define CRC_LOCALHEADER_OFFSET  (0x0e)
@@ -770,6 +773,8 @@ extern int ZEXPORT zipOpenNewFileInZip3 (
       zi->ci.flag |= 6;
     if (password != NULL)
       zi->ci.flag |= 1;
+    if (zi->z_filefunc.zseek_file == NULL)
+      zi->ci.flag |= 8; /* the sizes follow the data */
 
     zi->ci.crc32 = 0;
     zi->ci.method = method;
@@ -1005,14 +1010,12 @@ extern int ZEXPORT zipWriteInFileInZip (
         }
         else
         {
-            uInt copy_this,i;
+            uInt copy_this;
             if (zi->ci.stream.avail_in < zi->ci.stream.avail_out)
                 copy_this = zi->ci.stream.avail_in;
             else
                 copy_this = zi->ci.stream.avail_out;
-            for (i=0;i<copy_this;i++)
-                *(((char*)zi->ci.stream.next_out)+i) =
-                    *(((const char*)zi->ci.stream.next_in)+i);
+            memcpy(zi->ci.stream.next_out, zi->ci.stream.next_in, copy_this);
             {
                 zi->ci.stream.avail_in -= copy_this;
                 zi->ci.stream.avail_out-= copy_this;
@@ -1097,7 +1100,20 @@ extern int ZEXPORT zipCloseFileInZipRaw (
                                        (uLong)zi->ci.size_centralheader);
     free(zi->ci.central_header);
 
-    if (err==ZIP_OK)
+    if ((err==ZIP_OK) && (zi->ci.flag & 8))
+    {
+        err = ziplocal_putValue(&zi->z_filefunc,zi->filestream,(uLong)DATADESCRIPTORMAGIC,4);
+
+        if (err==ZIP_OK)
+            err = ziplocal_putValue(&zi->z_filefunc,zi->filestream,crc32,4);
+
+        if (err==ZIP_OK)
+            err = ziplocal_putValue(&zi->z_filefunc,zi->filestream,compressed_size,4);
+
+        if (err==ZIP_OK)
+            err = ziplocal_putValue(&zi->z_filefunc,zi->filestream,uncompressed_size,4);
+    }
+    else if (err==ZIP_OK)
     {
         long cur_pos_inzip = ZTELL(zi->z_filefunc,zi->filestream);
         if (ZSEEK(zi->z_filefunc,zi->filestream,
@@ -3,10 +3,16 @@
 
 #include "splib.h"
 #include <assert.h>
+#include <locale>
+#include <map>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 #include <math.h>
 #include <sstream>
 #include <stdio.h>
 #include <string.h>
+#include <zlib.h>
 
 // these lines define the verify() macro that is equivalent to assert() in
 // debug configurations but also works in release configurations; this is
@@ -46,6 +52,66 @@ void testTable();
  */
 void testCell();
 
+/**
+ * Tests the Rows and Cells collections.
+ */
+void testCollections();
+
+/**
+ * Tests the columnar Table implementation.
+ */
+void testColumnarTable();
+
+/**
+ * Tests the bulk row and range setters of both table implementations.
+ */
+void testBulkRows();
+
+/**
+ * Tests the bulk row and range setters of a table.
+ */
+void testBulkRows(splib::Table& table);
+
+/**
+ * Tests the lifetime of the texts of both table implementations.
+ */
+void testTexts();
+
+/**
+ * Tests the lifetime of the texts of a table.
+ */
+void testTexts(splib::Table& table);
+
+/**
+ * Tests the table statistics of both table implementations.
+ */
+void testStatistics();
+
+/**
+ * Tests the statistics of a table.
+ */
+void testStatistics(splib::Table& table);
+
+/**
+ * Tests clearing and removing ranges in both table implementations.
+ */
+void testRanges();
+
+/**
+ * Tests clearing and removing ranges in a table.
+ */
+void testRanges(splib::Table& table);
+
+/**
+ * Tests the const lookup methods in both table implementations.
+ */
+void testFindCell();
+
+/**
+ * Tests the const lookup methods of a table.
+ */
+void testFindCell(const splib::Table& table);
+
 /**
  * Tests the Date class.
  */
@@ -56,11 +122,121 @@ void testDate();
  */
 void testTime();
 
+/**
+ * Tests that the writers check the tables against the grid of their
+ * formats.
+ */
+void testWriterLimits();
+
+/**
+ * Tests the stream writers.
+ */
+void testStreamWriters();
+
+/**
+ * Writes a small spreadsheet with a stream writer and tests the error
+ * handling of the writer. The writer has a grid of the specified number
+ * of columns.
+ */
+void testStreamWriter(splib::StreamWriter& writer, int columns);
+
 /**
  * Tests the XlsWriter, XlsxWriter, and OdsWriter classes.
  */
 void testWriters();
 
+/**
+ * Tests writing files to output sinks.
+ */
+void testSinks();
+
+/**
+ * Tests the CompressionOptions class and writing with different levels.
+ */
+void testCompression();
+
+/**
+ * Tests that entries compressed in blocks by several threads inflate
+ * to the bytes written by a single thread.
+ */
+void testBlockCompression();
+
+/**
+ * Tests the numbers written into xlsx and ods files.
+ */
+void testNumberFormat();
+
+/**
+ * Tests the text written into xlsx and ods files.
+ */
+void testXmlText();
+
+/**
+ * Tests the cell references written into xlsx files.
+ */
+void testCellReferences();
+
+/**
+ * Tests the shared string table of xlsx files.
+ */
+void testSharedStrings();
+
+/**
+ * Tests the compact encoding of xlsx sheets.
+ */
+void testCompactSheets();
+
+/**
+ * Writes a spreadsheet into memory without compression and returns it.
+ */
+std::string writeStored(splib::Spreadsheet& sc, bool xlsx);
+
+/**
+ * Appends the bytes passed to a CallbackSink to the string that is
+ * the context.
+ */
+bool collect(void* context, const void* data, unsigned length);
+
+/**
+ * Refuses the bytes passed to a CallbackSink.
+ */
+bool refuse(void* context, const void* data, unsigned length);
+
+/**
+ * Reads a file into a string.
+ */
+std::string readFile(const char* pathname);
+
+/**
+ * Writes a string to a file.
+ */
+void writeFile(const char* pathname, const std::string& data);
+
+/**
+ * Reads a little-endian integer of 2 or 4 bytes from a zip archive.
+ */
+unsigned long zipInt(const std::string& zip, size_t offset, int size);
+
+/** The entries of a zip archive, by name */
+typedef std::map<std::string, std::string> ZipEntries;
+
+/**
+ * Reads the entries of a zip archive through its central directory,
+ * inflating them and checking their sizes and CRC-32.
+ */
+ZipEntries readZip(const std::string& zip);
+
+/**
+ * Retrieves the number of bytes allocated from the heap, or 0 where it
+ * cannot be measured.
+ */
+size_t heapInUse();
+
+/**
+ * Writes a spreadsheet into memory as xlsx and returns it.
+ */
+std::string writeXlsx(splib::Spreadsheet& sc, splib::XlsxWriter& writer);
+
 /**
  * Setups a test spreadsheet for writer testing.
  */
@@ -101,6 +277,11 @@ void setupHeightsAndWidthsTable(splib::Spreadsheet& sc);
  */
 void setupEmptyTable(splib::Spreadsheet& sc);
 
+/**
+ * Setups a columnar test table.
+ */
+void setupColumnarTable(splib::Spreadsheet& sc);
+
 
 /**
  * Program entry point.
@@ -110,9 +291,26 @@ int _tmain(int argc, _TCHAR* argv[]) {
     testSpreadsheet();
     testTable();
     testCell();
+    testCollections();
+    testColumnarTable();
+    testBulkRows();
+    testTexts();
+    testStatistics();
+    testRanges();
+    testFindCell();
     testDate();
     testTime();
+    testWriterLimits();
+    testStreamWriters();
     testWriters();
+    testSinks();
+    testCompression();
+    testBlockCompression();
+    testNumberFormat();
+    testXmlText();
+    testCellReferences();
+    testSharedStrings();
+    testCompactSheets();
 }
 
 void testSpreadsheet() {
@@ -165,6 +363,30 @@ void testSpreadsheet() {
     verify(&table2 == &sc.table(0));
     verify(&table2 == &sc.table(_T("table 2")));
 
+    // texts are shared by all tables and survive the removal of a table
+    splib::Table& shared = sc.insertColumnarTable(1, _T("shared"));
+    for (int i = 0; i < 1000; i++) {
+        std::basic_stringstream<_TCHAR> text;
+        text << _T("text ") << i % 300;
+        table2.cell(0, i).setText(text.str().c_str());
+        shared.cell(0, i).setText(text.str().c_str());
+        shared.cell(1, i).setText(text.str().c_str());
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        table2.cell(0, i).setLong(i);
+    }
+    sc.removeTable(_T("shared"));
+    for (int i = 0; i < 1000; i++) {
+        std::basic_stringstream<_TCHAR> text;
+        text << _T("text ") << i % 300;
+        if (i % 2 == 0) {
+            verify(table2.cell(0, i).getLong() == i);
+        } else {
+            verify(text.str() == table2.cell(0, i).getText());
+        }
+    }
+    table2.clearRange(0, 0, 0, 999);
+
     // Error handling
     try {
         sc.insertTable(2, _T("does not matter"));
@@ -260,6 +482,10 @@ void testTable() {
     verify(&table.cell(_T("IV1")) == &table.cell(255, 0));
     verify(&table.cell(_T("IV65536")) == &table.cell(255, 65535));
     table.clearCell(_T("IV65536"));
+    verify(&table.cell(_T("AAA1")) == &table.cell(702, 0));
+    verify(&table.cell(_T("XFD1048576")) == &table.cell(16383, 1048575));
+    table.clearCell(_T("AAA1"));
+    table.clearCell(_T("XFD1048576"));
 
     // clearCell()
     table.cell(_T("A1"));
@@ -339,6 +565,17 @@ void testTable() {
     verify(table.firstRow() == 5);
     verify(table.lastColumn() == 7);
     verify(table.lastRow() == 15);
+    const splib::Table& constTable = table;
+    table.cell(5, 1048575);
+    verify(constTable.lastRow() == 1048575);
+    table.clearCell(5, 1048575);
+    table.cell(5, 63);
+    table.cell(5, 64);
+    verify(constTable.lastRow() == 64);
+    table.clearCell(5, 64);
+    verify(constTable.lastRow() == 63);
+    table.clearCell(5, 63);
+    verify(constTable.lastRow() == 15);
 
     // getName() & setName()
     verify(_tcscmp(table.getName(), _T("table")) == 0);
@@ -349,14 +586,14 @@ void testTable() {
 
     // Error handling
     table.cell(0, 0);
-    table.cell(255, 65535);
+    table.cell(16383, 1048575);
     try {
         table.cell(-1, 0);
         verify(false);
     } catch (splib::IllegalArgumentException&) {
     }
     try {
-        table.cell(256, 0);
+        table.cell(16384, 0);
         verify(false);
     } catch (splib::IllegalArgumentException&) {
     }
@@ -366,7 +603,7 @@ void testTable() {
     } catch (splib::IllegalArgumentException&) {
     }
     try {
-        table.cell(0, 65536);
+        table.cell(0, 1048576);
         verify(false);
     } catch (splib::IllegalArgumentException&) {
     }
@@ -582,6 +819,25 @@ void testCell() {
     cell.setTime(splib::Time(_T("21:30:45")));
     verify(cell.getTime() == splib::Time(_T("21:30:45")));
 
+    // dates and times are copies that reading other cells leaves alone
+    table.cell(10, 0).setDate(splib::Date(2020, 1, 2));
+    table.cell(10, 1).setTime(splib::Time(8, 30));
+    const splib::Date& date = table.cell(10, 0).getDate();
+    const splib::Time& time = table.cell(10, 1).getTime();
+    splib::CellValue dateValue = splib::CellValue::of(table.cell(10, 0));
+    for (int i = 0; i < 100; i++) {
+        table.cell(11, i).setDate(splib::Date(2015, 3, 4));
+        table.cell(11, i).getDate();
+        table.cell(12, i).setTime(splib::Time(23, 59));
+        table.cell(12, i).getTime();
+    }
+    verify(date == splib::Date(2020, 1, 2));
+    verify(time == splib::Time(8, 30));
+    verify(dateValue.getDate() == splib::Date(2020, 1, 2));
+    verify(splib::CellValue(splib::Time(1, 2, 3, 4)).getTime() ==
+           splib::Time(1, 2, 3, 4));
+    table.clearRange(10, 0, 12, 99);
+
     // FORMULA
     cell.setFormula(_T("SUM(A1:B10)"));
     verify(cell.getType() == splib::Cell::FORMULA);
@@ -639,6 +895,674 @@ void testCell() {
     }
 }
 
+void testCollections() {
+    splib::SpreadsheetImpl sc;
+    splib::Table& table = sc.insertTable(0, _T("table"));
+    splib::Rows& rows = table.rows();
+
+    // objects are created on demand and kept sorted by index regardless
+    // of the insertion order
+    int indices[] = {1000, 5, 64, 63, 0, 65535, 127, 128, 4000, 1};
+    const int N = sizeof(indices) / sizeof(int);
+    verify(rows.isEmpty());
+    for (int i = 0; i < N; i++) {
+        verify(!rows.contains(indices[i]));
+        rows.get(indices[i]).setHeight(indices[i]);
+        verify(rows.contains(indices[i]));
+    }
+    verify(rows.size() == N);
+    verify(!rows.isEmpty());
+    verify(!rows.contains(2));
+    verify(!rows.contains(65534));
+    verify(rows.first().index() == 0);
+    verify(rows.last().index() == 65535);
+    verify(rows.last().object().getHeight() == 65535);
+    int count = 0;
+    int prev = -1;
+    splib::Rows::Iterator* i = rows.iterator();
+    while (i->hasNext()) {
+        splib::Rows::Entry entry = i->next();
+        verify(entry.index() > prev);
+        verify(entry.object().getHeight() == entry.index());
+        verify(&entry.object() == &rows.get(entry.index()));
+        prev = entry.index();
+        count++;
+    }
+    try {
+        i->next();
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+    delete i;
+    verify(count == N);
+
+    // remove()
+    rows.remove(0);
+    rows.remove(65535);
+    rows.remove(64);
+    rows.remove(2); // not present
+    verify(rows.size() == N - 3);
+    verify(!rows.contains(0));
+    verify(!rows.contains(64));
+    verify(rows.contains(63));
+    verify(rows.first().index() == 1);
+    verify(rows.last().index() == 4000);
+    for (int i = 0; i < N; i++) {
+        rows.remove(indices[i]);
+    }
+    verify(rows.isEmpty());
+    try {
+        rows.first();
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+    try {
+        rows.last();
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+
+    // a dense row of cells
+    splib::Cells& cells = rows.get(10).cells();
+    for (int c = 255; c >= 0; c--) {
+        cells.get(c).setLong(c);
+    }
+    verify(cells.size() == 256);
+    verify(cells.first().index() == 0);
+    verify(cells.last().index() == 255);
+    splib::Cells::Iterator* j = cells.iterator();
+    for (int c = 0; c < 256; c++) {
+        verify(j->hasNext());
+        splib::Cells::Entry entry = j->next();
+        verify(entry.index() == c);
+        verify(entry.object().getLong() == c);
+    }
+    verify(!j->hasNext());
+    delete j;
+
+    // removed objects make room for new ones without disturbing the rest
+    for (int round = 0; round < 3; round++) {
+        for (int c = round % 2; c < 256; c += 2) {
+            cells.remove(c);
+        }
+        verify(cells.size() == 128);
+        for (int r = 0; r < 100; r++) {
+            rows.get(r + 11).cells().get(r).setText(_T("text"));
+        }
+        for (int c = round % 2; c < 256; c += 2) {
+            cells.get(c).setLong(c);
+        }
+        for (int r = 0; r < 100; r++) {
+            rows.remove(r + 11);
+        }
+        for (int c = 0; c < 256; c++) {
+            verify(cells.get(c).getLong() == c);
+        }
+    }
+}
+
+void testBulkRows() {
+    splib::SpreadsheetImpl sc;
+    testBulkRows(sc.insertTable(0, _T("table")));
+    testBulkRows(sc.insertColumnarTable(1, _T("columnar")));
+}
+
+void testBulkRows(splib::Table& table) {
+    splib::Date date(_T("2006-07-12"));
+    splib::Time time(_T("21:30:45.999"));
+    splib::CellValue values[] = {
+        splib::CellValue(_T("text")),
+        splib::CellValue(42L),
+        splib::CellValue(1.5),
+        splib::CellValue(),
+        splib::CellValue(date),
+        splib::CellValue(time),
+        splib::CellValue::formula(_T("SUM(A1:B10)"))
+    };
+    verify(values[3].getType() == splib::Cell::NONE);
+    try {
+        values[0].getLong();
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+
+    // appendRow()
+    verify(table.appendRow(values, 7) == 0);
+    verify(table.appendRow(values, 0) == 1);
+    verify(table.rows().contains(1));
+    verify(table.appendRow(values + 1, 2) == 2);
+    verify(_tcscmp(table.cell(0, 0).getText(), _T("text")) == 0);
+    verify(table.cell(1, 0).getLong() == 42);
+    verify(table.cell(2, 0).getDouble() == 1.5);
+    verify(table.isEmptyCell(3, 0));
+    verify(table.cell(4, 0).getDate() == date);
+    verify(table.cell(5, 0).getTime() == time);
+    verify(_tcscmp(table.cell(6, 0).getFormula(), _T("SUM(A1:B10)")) == 0);
+    verify(table.cell(0, 2).getLong() == 42);
+    verify(table.cell(1, 2).getDouble() == 1.5);
+    verify(table.lastRow() == 2);
+
+    // setRow()
+    table.cell(3, 10).setHAlignment(splib::Cell::RIGHT);
+    table.cell(5, 10).setLong(7);
+    table.setRow(10, 2, values, 4);
+    verify(_tcscmp(table.cell(2, 10).getText(), _T("text")) == 0);
+    verify(table.cell(3, 10).getLong() == 42);
+    verify(table.cell(3, 10).getHAlignment() == splib::Cell::RIGHT);
+    verify(table.cell(4, 10).getDouble() == 1.5);
+    verify(table.cell(5, 10).getLong() == 7);
+    verify(table.isEmptyCell(1, 10));
+    verify(table.isEmptyCell(6, 10));
+    verify(table.appendRow(values, 1) == 11);
+
+    // Error handling
+    try {
+        table.setRow(-1, 0, values, 1);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.setRow(20, 16380, values, 7);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.setRow(20, 0, 0, 1);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.setRow(20, 0, values, -1);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    verify(!table.rows().contains(20));
+    splib::CellValue bad = splib::CellValue::formula(_T("SUM(A1:B1048577)"));
+    try {
+        table.setRow(20, 0, &bad, 1);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+
+    // setRange()
+    double matrix[3][4] = {
+        {1.5, 2.5, 3.5, -1},
+        {4.5, 5.5, 6.5, -1},
+        {7.5, 8.5, 9.5, -1}
+    };
+    table.setRange(10, 30, 3, 3, &matrix[0][0], 4);
+    verify(table.cell(10, 30).getDouble() == 1.5);
+    verify(table.cell(12, 30).getDouble() == 3.5);
+    verify(table.cell(11, 31).getDouble() == 5.5);
+    verify(table.cell(12, 32).getDouble() == 9.5);
+    verify(table.isEmptyCell(13, 30));
+    verify(table.isEmptyCell(10, 33));
+    long column[] = {1, 2, 3};
+    table.setRange(11, 30, 1, 3, column, 1);
+    verify(table.cell(11, 30).getType() == splib::Cell::LONG);
+    verify(table.cell(11, 32).getLong() == 3);
+    verify(table.cell(12, 32).getDouble() == 9.5);
+    const _TCHAR* texts[] = {_T("a"), 0, _T("a")};
+    table.setRange(20, 40, 3, 1, texts, 3);
+    verify(_tcscmp(table.cell(20, 40).getText(), _T("a")) == 0);
+    verify(_tcscmp(table.cell(21, 40).getText(), _T("")) == 0);
+    verify(_tcscmp(table.cell(22, 40).getText(), _T("a")) == 0);
+    splib::Date dates[] = {date, date};
+    table.setRange(0, 50, 2, 2, dates, 0);
+    verify(table.cell(1, 51).getDate() == date);
+    table.setRange(0, 60, 0, 5, (double*)0, 0);
+    table.setRange(-1, -1, 0, 0, (long*)0, 0);
+    verify(table.lastRow() == 51);
+    try {
+        table.setRange(0, 0, -1, 1, &matrix[0][0], 4);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.setRange(16382, 0, 3, 1, &matrix[0][0], 4);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.setRange(0, 1048575, 1, 2, &matrix[0][0], 4);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.setRange(0, 0, 1, 1, (double*)0, 4);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    verify(table.lastRow() == 51);
+}
+
+void testTexts() {
+    splib::SpreadsheetImpl sc;
+    testTexts(sc.insertTable(0, _T("table")));
+    testTexts(sc.insertColumnarTable(1, _T("columnar")));
+}
+
+void testTexts(splib::Table& table) {
+    // a cell set to its own text or formula keeps it
+    table.cell(0, 0).setText(_T("only here"));
+    table.cell(0, 0).setText(table.cell(0, 0).getText());
+    verify(_tcscmp(table.cell(0, 0).getText(), _T("only here")) == 0);
+    table.cell(1, 0).setFormula(_T("SUM(A1:A2)"));
+    table.cell(1, 0).setFormula(table.cell(1, 0).getFormula());
+    verify(_tcscmp(table.cell(1, 0).getFormula(), _T("SUM(A1:A2)")) == 0);
+    splib::CellValue value(table.cell(0, 0).getText());
+    table.setRow(0, 0, &value, 1);
+    verify(_tcscmp(table.cell(0, 0).getText(), _T("only here")) == 0);
+
+    // the text of a cell stays in place while other texts are added
+    const _TCHAR* text = table.cell(0, 0).getText();
+    for (int row = 1; row < 1000; row++) {
+        std::basic_string<_TCHAR> other(row, _T('t'));
+        table.cell(0, row).setText(other.c_str());
+    }
+    verify(_tcscmp(text, _T("only here")) == 0);
+    verify(text == table.cell(0, 0).getText());
+    table.clearRange(0, 0, 1, 999);
+}
+
+void testStatistics() {
+    splib::SpreadsheetImpl sc;
+    testStatistics(sc.insertTable(0, _T("table")));
+    testStatistics(sc.insertColumnarTable(1, _T("columnar")));
+}
+
+void testStatistics(splib::Table& table) {
+    const splib::TableStatistics& stats = table.statistics();
+    verify(stats.getCellCount() == 0);
+    verify(stats.getCellCount(splib::Cell::NONE) == 0);
+
+    // cell creation and type changes
+    table.cell(5, 5);
+    table.cell(3, 7).setText(_T("text"));
+    table.cell(8, 2).setDouble(1.5);
+    table.cell(8, 3).setDouble(2.5);
+    table.cell(6, 9).setFormula(_T("SUM(A1:B2)"));
+    verify(stats.getCellCount() == 5);
+    verify(stats.getCellCount(splib::Cell::NONE) == 1);
+    verify(stats.getCellCount(splib::Cell::TEXT) == 1);
+    verify(stats.getCellCount(splib::Cell::DOUBLE) == 2);
+    verify(stats.getCellCount(splib::Cell::FORMULA) == 1);
+    verify(table.firstColumn() == 3);
+    verify(table.lastColumn() == 8);
+    table.cell(3, 7).setLong(1);
+    table.cell(8, 3).clear();
+    verify(stats.getCellCount() == 5);
+    verify(stats.getCellCount(splib::Cell::NONE) == 2);
+    verify(stats.getCellCount(splib::Cell::TEXT) == 0);
+    verify(stats.getCellCount(splib::Cell::LONG) == 1);
+    verify(stats.getCellCount(splib::Cell::DOUBLE) == 1);
+
+    // bulk setters
+    splib::CellValue values[] = {
+        splib::CellValue(1L), splib::CellValue(), splib::CellValue(_T("a"))
+    };
+    table.setRow(20, 1, values, 3);
+    verify(stats.getCellCount() == 7);
+    verify(stats.getCellCount(splib::Cell::LONG) == 2);
+    verify(stats.getCellCount(splib::Cell::TEXT) == 1);
+    verify(table.firstColumn() == 1);
+
+    // removal of cells and rows
+    table.clearCell(1, 20);
+    verify(table.firstColumn() == 3);
+    table.clearCell(3, 7);
+    verify(table.firstColumn() == 3);
+    table.rows().remove(20);
+    verify(table.firstColumn() == 5);
+    verify(stats.getCellCount() == 4);
+    verify(stats.getCellCount(splib::Cell::LONG) == 0);
+    verify(stats.getCellCount(splib::Cell::TEXT) == 0);
+    table.rows().get(2).cells().remove(8);
+    verify(table.lastColumn() == 8);
+    table.clearCell(8, 3);
+    verify(table.lastColumn() == 6);
+    table.clearRange(0, 0, 255, 100);
+    verify(stats.getCellCount() == 0);
+    verify(stats.getCellCount(splib::Cell::FORMULA) == 0);
+    verify(stats.getCellCount(splib::Cell::NONE) == 0);
+    verify(table.firstColumn() == -1);
+    verify(table.lastColumn() == -1);
+}
+
+void testRanges() {
+    splib::SpreadsheetImpl sc;
+    testRanges(sc.insertTable(0, _T("table")));
+    testRanges(sc.insertColumnarTable(1, _T("columnar")));
+}
+
+void testRanges(splib::Table& table) {
+    // clearRange() over the whole sheet
+    for (int i = 0; i < 100; i++) {
+        table.cell(i % 7, i * 600).setLong(i);
+    }
+    table.cell(255, 65535);
+    table.rows().get(300).setHeight(20);
+    table.clearRange(_T("A1"), _T("IV65536"));
+    verify(table.statistics().getCellCount() == 0);
+    verify(table.rows().size() == 1);
+    verify(table.rows().get(300).getHeight() == 20);
+    table.rows().remove(300);
+
+    // clearRange() keeps the cells around the range
+    for (int r = 0; r < 200; r += 3) {
+        for (int c = 0; c < 100; c += 7) {
+            table.cell(c, r).setLong(r * 1000 + c);
+        }
+    }
+    int count = table.statistics().getCellCount();
+    table.clearRange(13, 10, 70, 100);
+    verify(table.isEmptyCell(14, 12));
+    verify(table.isEmptyCell(70, 99));
+    verify(table.cell(7, 12).getLong() == 12007);
+    verify(table.cell(77, 12).getLong() == 12077);
+    verify(table.cell(14, 9).getLong() == 9014);
+    verify(table.cell(14, 102).getLong() == 102014);
+    verify(table.statistics().getCellCount() == count - 9 * 30);
+
+    // removeRows()
+    table.rows().get(150).setHeight(10);
+    table.removeRows(160, 140);
+    verify(!table.rows().contains(141));
+    verify(!table.rows().contains(150));
+    verify(!table.rows().contains(159));
+    verify(table.cell(0, 138).getLong() == 138000);
+    verify(table.cell(0, 162).getLong() == 162000);
+    verify(table.statistics().getCellCount() == count - 9 * 30 - 7 * 15);
+
+    // removeColumns()
+    table.columns().get(20).setWidth(50);
+    table.columns().get(30).setWidth(50);
+    table.removeColumns(10, 25);
+    verify(!table.columns().contains(20));
+    verify(table.columns().contains(30));
+    verify(table.isEmptyCell(14, 0));
+    verify(table.isEmptyCell(21, 0));
+    verify(table.cell(28, 0).getLong() == 28);
+    verify(table.cell(7, 0).getLong() == 7);
+    table.removeColumns(0, 255);
+    verify(table.statistics().getCellCount() == 0);
+    verify(table.rows().isEmpty());
+    verify(table.columns().isEmpty());
+    verify(table.firstColumn() == -1);
+    verify(table.lastRow() == -1);
+
+    // Error handling
+    try {
+        table.removeRows(-1, 0);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.removeRows(0, 1048576);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.removeColumns(0, 16384);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+}
+
+void testFindCell() {
+    splib::SpreadsheetImpl sc;
+    splib::Table& table = sc.insertTable(0, _T("table"));
+    splib::Table& columnar = sc.insertColumnarTable(1, _T("columnar"));
+    for (int i = 0; i < 2; i++) {
+        splib::Table& t = i == 0 ? table : columnar;
+        t.cell(2, 5).setLong(25);
+        t.cell(3, 5).setText(_T("text"));
+        t.cell(1, 70).setDouble(1.5);
+        t.cell(200, 70).setDate(splib::Date(2009, 3, 14));
+        t.rows().get(130).setHeight(12);
+        testFindCell(t);
+    }
+
+    // const lookups over a large columnar table allocate nothing
+    splib::Table& large = sc.insertColumnarTable(2, _T("large"));
+    splib::CellValue values[10];
+    for (int r = 0; r < 20000; r++) {
+        for (int c = 0; c < 10; c++) {
+            values[c] = splib::CellValue((double)r);
+        }
+        large.setRow(r, 0, values, 10);
+    }
+    const splib::Table& reader = large;
+    size_t heap = heapInUse();
+    double sum = 0;
+    for (int r = 0; r < 20000; r++) {
+        const splib::Cells& cells = reader.rows().find(r)->cells();
+        for (int c = 0; c < 10; c++) {
+            sum += reader.findCell(c, r)->getDouble();
+            sum += cells.find(c)->getDouble();
+        }
+    }
+    verify(heapInUse() == heap);
+    verify(sum == 20. * 20000 * 19999 / 2);
+}
+
+void testFindCell(const splib::Table& table) {
+    // lookups of missing cells create nothing
+    verify(table.findCell(0, 0) == 0);
+    verify(table.findCell(4, 5) == 0);
+    verify(table.findCell(_T("C7")) == 0);
+    verify(table.findCell(0, 130) == 0);
+    verify(table.rows().find(6) == 0);
+    verify(table.rows().find(5)->cells().find(0) == 0);
+    verify(!table.rows().contains(0));
+    verify(table.rows().size() == 3);
+    verify(table.rows().find(5)->cells().size() == 2);
+    verify(table.statistics().getCellCount() == 4);
+
+    // lookups of existing cells
+    verify(table.findCell(2, 5)->getLong() == 25);
+    verify(_tcscmp(table.findCell(_T("D6"))->getText(), _T("text")) == 0);
+    verify(table.findCell(1, 70)->getDouble() == 1.5);
+    verify(table.findCell(200, 70)->getDate() == splib::Date(2009, 3, 14));
+    verify(table.rows().find(130)->getHeight() == 12);
+    verify(table.rows().find(130)->cells().isEmpty());
+
+    // iteration with next() and find()
+    int rows[3];
+    int n = 0;
+    int cells = 0;
+    for (int r = table.rows().next(0); r != -1; r = table.rows().next(r + 1)) {
+        verify(n < 3);
+        rows[n++] = r;
+        const splib::Cells& c = table.rows().find(r)->cells();
+        for (int i = c.next(0); i != -1; i = c.next(i + 1)) {
+            verify(c.contains(i));
+            verify(c.find(i)->getType() != splib::Cell::NONE);
+            cells++;
+        }
+    }
+    verify(n == 3 && rows[0] == 5 && rows[1] == 70 && rows[2] == 130);
+    verify(cells == 4);
+    verify(table.rows().next(-10) == 5);
+    verify(table.rows().next(71) == 130);
+    verify(table.rows().next(131) == -1);
+    verify(table.rows().next(1 << 30) == -1);
+    verify(table.rows().find(70)->cells().next(2) == 200);
+    verify(table.rows().find(70)->cells().next(201) == -1);
+
+    // Error handling
+    try {
+        table.findCell(-1, 0);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.findCell(0, 1048576);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.findCell(_T("A0"));
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.findCell(0);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        table.rows().find(-1);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+}
+
+void testColumnarTable() {
+    splib::SpreadsheetImpl sc;
+    sc.insertTable(0, _T("table"));
+    splib::Table& table = sc.insertColumnarTable(1, _T("columnar"));
+    verify(&sc.table(_T("columnar")) == &table);
+    try {
+        sc.insertColumnarTable(0, _T("table"));
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    verify(table.firstColumn() == -1);
+    verify(table.firstRow() == -1);
+    verify(table.lastColumn() == -1);
+    verify(table.lastRow() == -1);
+
+    // cell values
+    splib::Cell& cell = table.cell(_T("C3"));
+    verify(!table.isEmptyCell(2, 2));
+    verify(cell.getType() == splib::Cell::NONE);
+    cell.setText(_T("my text"));
+    verify(_tcscmp(table.cell(2, 2).getText(), _T("my text")) == 0);
+    cell.setText(0);
+    verify(_tcscmp(cell.getText(), _T("")) == 0);
+    cell.setLong(-1);
+    verify(cell.getType() == splib::Cell::LONG);
+    verify(cell.getLong() == -1);
+    cell.setDouble(1.5);
+    verify(cell.getType() == splib::Cell::DOUBLE);
+    verify(cell.getDouble() == 1.5);
+    cell.setDate(splib::Date(_T("2006-07-12")));
+    verify(cell.getDate() == splib::Date(_T("2006-07-12")));
+    cell.setTime(splib::Time(_T("21:30:45.999")));
+    verify(cell.getTime() == splib::Time(_T("21:30:45.999")));
+    cell.setFormula(_T("SUM(A1:B10)"));
+    verify(_tcscmp(cell.getFormula(), _T("SUM(A1:B10)")) == 0);
+    try {
+        cell.setFormula(_T("SUM(A1:B1048577)"));
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    cell.setHAlignment(splib::Cell::FILLED);
+    cell.setVAlignment(splib::Cell::BOTTOM);
+    cell.clear();
+    verify(cell.getType() == splib::Cell::NONE);
+    verify(cell.getHAlignment() == splib::Cell::FILLED);
+    verify(cell.getVAlignment() == splib::Cell::BOTTOM);
+    try {
+        cell.getDouble();
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+
+    // bounds
+    table.cell(5, 100).setDouble(1);
+    table.cell(1, 7).setLong(2);
+    verify(table.firstColumn() == 1);
+    verify(table.lastColumn() == 5);
+    verify(table.firstRow() == 2);
+    verify(table.lastRow() == 100);
+
+    // rows and cells
+    splib::Rows& rows = table.rows();
+    verify(rows.size() == 3);
+    verify(rows.contains(7));
+    verify(!rows.contains(8));
+    verify(rows.first().index() == 2);
+    verify(rows.last().index() == 100);
+    rows.get(8).setHeight(20);
+    verify(rows.size() == 4);
+    verify(rows.get(8).cells().isEmpty());
+    verify(rows.get(8).getHeight() == 20);
+    verify(rows.get(7).getHeight() < 0);
+    splib::Cells& cells = rows.get(7).cells();
+    cells.get(3).setText(_T("x"));
+    verify(cells.size() == 2);
+    verify(cells.first().index() == 1);
+    verify(cells.last().index() == 3);
+    verify(_tcscmp(cells.last().object().getText(), _T("x")) == 0);
+    cells.remove(3);
+    verify(cells.size() == 1);
+    verify(!cells.contains(3));
+    int expected[] = {2, 7, 8, 100};
+    int count = 0;
+    splib::Rows::Iterator* i = rows.iterator();
+    while (i->hasNext()) {
+        splib::Rows::Entry entry = i->next();
+        verify(entry.index() == expected[count++]);
+        splib::Cells::Iterator* j = entry.object().cells().iterator();
+        while (j->hasNext()) {
+            splib::Cells::Entry cellEntry = j->next();
+            verify(!table.isEmptyCell(cellEntry.index(), entry.index()));
+        }
+        delete j;
+    }
+    delete i;
+    verify(count == 4);
+
+    // views stay bound to their cell and row for a number of lookups
+    splib::Cell& kept = table.cell(5, 100);
+    const splib::Cell* found = table.findCell(1, 7);
+    splib::Row& keptRow = rows.get(100);
+    for (int r = 200; r < 220; r++) {
+        table.cell(4, r).setLong(r);
+        verify(table.findCell(4, r)->getLong() == r);
+        rows.get(r);
+    }
+    kept.setLong(3);
+    verify(table.findCell(5, 100)->getLong() == 3);
+    verify(found->getLong() == 2);
+    verify(keptRow.cells().find(5)->getLong() == 3);
+    verify(table.findCell(4, 200)->getLong() == 200);
+    table.clearRange(4, 200, 4, 219);
+
+    // clearCell() keeps rows that have a height
+    table.clearCell(1, 7);
+    verify(!rows.contains(7));
+    table.cell(0, 8).setText(_T("y"));
+    table.clearCell(_T("A9"));
+    verify(rows.contains(8));
+    rows.remove(8);
+    verify(!rows.contains(8));
+    table.clearRange(_T("A1"), _T("F101"));
+    verify(rows.isEmpty());
+    verify(table.firstColumn() == -1);
+
+    // a large column; the views are not kept, so a cell filled through
+    // cell() costs only its storage, and looking it up again costs nothing
+    const int H = 65536;
+    size_t heap = heapInUse();
+    for (int r = 0; r < H; r++) {
+        table.cell(0, r).setDouble(r * .5);
+    }
+    verify(rows.size() == H);
+    verify(heapInUse() - heap < 24 * H);
+    heap = heapInUse();
+    double sum = 0;
+    for (int r = 0; r < H; r++) {
+        sum += table.cell(0, r).getDouble();
+        table.cell(0, r).setDouble(r * .5);
+        sum += rows.get(r).cells().get(0).getDouble();
+    }
+    verify(sum == .5 * H * (H - 1));
+    verify(heapInUse() == heap);
+}
+
 void testDate() {
     // constructors and assignment
     verify(splib::Date() == splib::Date(0, 1, 1));
@@ -982,12 +1906,866 @@ void testTime() {
     }
 }
 
+void testWriterLimits() {
+    splib::SpreadsheetImpl sc;
+    splib::Table& table = sc.insertTable(0, _T("table"));
+    splib::Table& columnar = sc.insertColumnarTable(1, _T("columnar"));
+    for (int r = 0; r < 1048576; r += 4099) {
+        table.cell(r % 100, r).setLong(r);
+        columnar.cell(r % 100, r).setDouble(r);
+    }
+    columnar.cell(1000, 1048575).setText(_T("last"));
+    verify(table.rows().size() == 256);
+    verify(columnar.rows().size() == 257);
+
+    // rows past the XLS grid
+    try {
+        splib::XlsWriter().write(sc, _T("testlimits.xls"));
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    splib::XlsxWriter().write(sc, _T("testlimits.xlsx"));
+    splib::OdsWriter().write(sc, _T("testlimits.ods"));
+
+    // columns past the ODS grid
+    columnar.cell(1024, 0).setLong(1);
+    try {
+        splib::OdsWriter().write(sc, _T("testlimits.ods"));
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    columnar.clearCell(1024, 0);
+    table.columns().get(5000).setWidth(10);
+    try {
+        splib::OdsWriter().write(sc, _T("testlimits.ods"));
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    splib::XlsxWriter().write(sc, _T("testlimits.xlsx"));
+
+    // formulas that refer past the XLS grid
+    sc.removeTable(1);
+    table.removeRows(65536, 1048575);
+    table.columns().remove(5000);
+    table.cell(0, 0).setFormula(_T("SUM(A65536:B65537)"));
+    try {
+        splib::XlsWriter().write(sc, _T("testlimits.xls"));
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    splib::MemorySink sink;
+    try {
+        splib::XlsWriter().write(sc, sink);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    verify(sink.getSize() == 0);
+
+    // tables that fit the XLS grid
+    table.cell(0, 0).setFormula(_T("SUM(A65535:IV65536)"));
+    splib::XlsWriter().write(sc, _T("testlimits.xls"));
+}
+
+void testStreamWriters() {
+    splib::XlsxStreamWriter xlsx(_T("teststream.xlsx"));
+    testStreamWriter(xlsx, 16384);
+    splib::OdsStreamWriter ods(_T("teststream.ods"));
+    testStreamWriter(ods, 1024);
+}
+
+void testStreamWriter(splib::StreamWriter& writer, int columns) {
+    splib::Date date(2009, 3, 14);
+    splib::Time time(12, 30, 15);
+    splib::CellValue values[] = {
+        _T("text <&> \"text\""), 42, 1.5, date, time,
+        splib::CellValue::formula(_T("SUM(B2:C2)")), splib::CellValue()};
+
+    // calls out of order
+    try {
+        writer.writeRow(0, 0, values, 1);
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+    try {
+        writer.endSheet();
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+
+    // a sheet with widths and heights
+    writer.beginSheet(_T("first"));
+    try {
+        writer.beginSheet(_T("second"));
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+    writer.setColumnWidth(0, 60);
+    writer.setColumnWidth(3, 30);
+    writer.setRowHeight(0, 25);
+    writer.writeRow(0, 0, values, 1);
+    writer.writeRow(1, 0, values, 7);
+    writer.setRowHeight(3, 40);
+    writer.setRowHeight(5, 10);
+    writer.writeRow(5, 2, values, 3);
+    writer.writeRow(1000000, columns - 4, values + 1, 4);
+    try {
+        writer.setColumnWidth(1, 10);
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+    try {
+        writer.writeRow(1000000, 0, values, 1);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        writer.setRowHeight(999, 10);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        writer.writeRow(1000001, columns, values, 1);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        writer.writeRow(1000001, columns - 3, values, 4);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        writer.writeRow(1000001, 0, 0, 1);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    splib::CellValue bad = splib::CellValue::formula(_T("SUM(A1:B1048577)"));
+    try {
+        writer.writeRow(1000001, 0, &bad, 1);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    writer.endSheet();
+
+    // an empty sheet and a sheet with a single row
+    try {
+        writer.beginSheet(_T("first"));
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        writer.beginSheet(0);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    writer.beginSheet(_T("empty"));
+    writer.endSheet();
+    writer.beginSheet(_T("last"));
+    writer.setRowHeight(7, 25);
+    writer.close();
+    try {
+        writer.beginSheet(_T("closed"));
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+    try {
+        writer.close();
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+}
+
 void testWriters() {
     splib::SpreadsheetImpl sc;
     setupTestSpreadsheet(sc);
     splib::XlsWriter().write(sc, _T("testout.xls"));
     splib::XlsxWriter().write(sc, _T("testout.xlsx"));
     splib::OdsWriter().write(sc, _T("testout.ods"));
+
+    // sheets written by several threads
+    splib::XlsxWriter parallel;
+    verify(parallel.getThreads() == 1);
+    parallel.setThreads(4);
+    verify(parallel.getThreads() == 4);
+    parallel.write(sc, _T("testparallel.xlsx"));
+    parallel.setThreads(0);
+    parallel.write(sc, _T("testparallel.xlsx"));
+    try {
+        parallel.setThreads(-1);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+
+    // a single sheet compressed in blocks by several threads
+    splib::SpreadsheetImpl single;
+    splib::Table& table = single.insertTable(0, _T("Blocks"));
+    for (int row = 0; row < 5000; row++) {
+        for (int column = 0; column < 10; column++) {
+            table.cell(column, row).setDouble(row * 10. + column / 7.);
+        }
+    }
+    parallel.setThreads(4);
+    parallel.write(single, _T("testblocks.xlsx"));
+
+    // the entries are the same whatever the number of threads
+    splib::XlsxWriter serial;
+    parallel.setThreads(4);
+    for (int shared = 0; shared < 2; shared++) {
+        serial.setSharedStrings(shared != 0);
+        parallel.setSharedStrings(shared != 0);
+        ZipEntries expected = readZip(writeXlsx(sc, serial));
+        verify(expected.size() > 10);
+        verify(readZip(writeXlsx(sc, parallel)) == expected);
+        expected = readZip(writeXlsx(single, serial));
+        verify(expected["xl/worksheets/sheet1.xml"].size() > 1000000);
+        verify(readZip(writeXlsx(single, parallel)) == expected);
+    }
+}
+
+void testSinks() {
+    splib::SpreadsheetImpl sc;
+    setupTestSpreadsheet(sc);
+
+    // the xls file is the same whether the sink can seek or not
+    std::string file = readFile("testout.xls");
+    splib::MemorySink memory;
+    verify(memory.isSeekable());
+    verify(memory.getData() == 0 && memory.getSize() == 0);
+    splib::XlsWriter().write(sc, memory);
+    verify(memory.getSize() == file.size());
+    verify(memcmp(memory.getData(), file.data(), file.size()) == 0);
+    std::string collected;
+    splib::CallbackSink callback(collect, &collected);
+    verify(!callback.isSeekable());
+    splib::XlsWriter().write(sc, callback);
+    verify(collected == file);
+    try {
+        callback.seek(0);
+        verify(false);
+    } catch (splib::IllegalStateException&) {
+    }
+
+    // zip packages; without seeking, the entries have data descriptors
+    memory.clear();
+    splib::XlsxWriter().write(sc, memory);
+    verify(memory.getSize() > 4);
+    verify(memcmp(memory.getData(), "PK\3\4", 4) == 0);
+    collected.clear();
+    splib::XlsxWriter().write(sc, callback);
+    verify(collected.compare(0, 4, "PK\3\4") == 0);
+    writeFile("testsink.xlsx", collected);
+    collected.clear();
+    splib::OdsWriter().write(sc, callback);
+    writeFile("testsink.ods", collected);
+    collected.clear();
+    {
+        splib::XlsxStreamWriter writer(callback);
+        testStreamWriter(writer, 16384);
+    }
+    writeFile("teststreamsink.xlsx", collected);
+    collected.clear();
+    {
+        splib::OdsStreamWriter writer(callback);
+        testStreamWriter(writer, 1024);
+    }
+    writeFile("teststreamsink.ods", collected);
+
+    // the ods tables are joined to the start of content.xml, and every
+    // style they use is an automatic style that precedes them
+    for (int i = 0; i < 2; i++) {
+        if (i == 1) {
+            collected.clear();
+            splib::CompressionOptions stored;
+            stored.setEntryLevel("content.xml",
+                                 splib::CompressionOptions::STORE);
+            splib::OdsStreamWriter writer(callback);
+            writer.setCompression(stored);
+            testStreamWriter(writer, 1024);
+        }
+        std::string content = readZip(collected)["content.xml"];
+        size_t body = content.find("<office:body>");
+        verify(body != std::string::npos);
+        verify(content.find(
+            "<style:style style:name=\"ro2\" style:family=\"table-row\">\r\n"
+            "<style:table-row-properties style:row-height=\"25pt\"") < body);
+        verify(content.find(
+            "<table:table-row table:style-name=\"ro2\"") > body);
+        const char attribute[] = "table:style-name=\"";
+        int used = 0;
+        for (size_t p = content.find(attribute, body); p != std::string::npos;
+             p = content.find(attribute, p + 1)) {
+            size_t start = p + sizeof(attribute) - 1;
+            std::string name = content.substr(start,
+                                              content.find('"', start) - start);
+            size_t style = content.find(
+                "<style:style style:name=\"" + name + "\"");
+            verify(style < body);
+            used++;
+        }
+        verify(used > 3);
+        verify(content.rfind("</office:document-content>") ==
+               content.size() - 28);
+    }
+
+    // a file descriptor of a file can seek
+    FILE* f = fopen("testfd.xlsx", "wb");
+    verify(f != 0);
+    splib::FileDescriptorSink fd(fileno(f));
+    verify(fd.isSeekable());
+    splib::XlsxWriter().write(sc, fd);
+    fclose(f);
+
+    // errors of the sink
+    try {
+        splib::CallbackSink(0, 0);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    splib::CallbackSink failing(refuse, 0);
+    try {
+        splib::XlsWriter().write(sc, failing);
+        verify(false);
+    } catch (splib::IOException&) {
+    }
+    try {
+        splib::XlsxWriter().write(sc, failing);
+        verify(false);
+    } catch (splib::IOException&) {
+    }
+}
+
+void testCompression() {
+    splib::CompressionOptions options;
+    verify(options.getLevel() == splib::CompressionOptions::DEFAULT_LEVEL);
+    verify(options.getEntryLevel("xl/styles.xml") == -1);
+    options.setEntryLevel("xl/", 9);
+    options.setEntryLevel("xl/worksheets/", 1);
+    verify(options.getEntryLevel("xl/worksheets/sheet1.xml") == 1);
+    verify(options.getEntryLevel("xl/styles.xml") == 9);
+    verify(options.getEntryLevel("docProps/app.xml") == -1);
+    options.setEntryLevel("xl/", 8);
+    verify(options.getEntryLevel("xl/styles.xml") == 8);
+    options.clearEntryLevels();
+    verify(options.getEntryLevel("xl/styles.xml") == -1);
+    try {
+        splib::CompressionOptions invalid(10);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        options.setLevel(-2);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+    try {
+        options.setEntryLevel(0, 1);
+        verify(false);
+    } catch (splib::IllegalArgumentException&) {
+    }
+
+    // stored entries take more room than compressed ones
+    splib::SpreadsheetImpl sc;
+    setupTestSpreadsheet(sc);
+    splib::XlsxWriter xlsx;
+    splib::MemorySink compressed;
+    xlsx.write(sc, compressed);
+    xlsx.setCompression(splib::CompressionOptions(
+        splib::CompressionOptions::STORE));
+    verify(xlsx.getCompression().getLevel() == 0);
+    splib::MemorySink stored;
+    xlsx.write(sc, stored);
+    verify(stored.getSize() > 2 * compressed.getSize());
+    xlsx.write(sc, _T("teststore.xlsx"));
+
+    // fast sheets and small other entries, also in memory by threads
+    options.setLevel(splib::CompressionOptions::BEST_COMPRESSION);
+    options.setEntryLevel("xl/worksheets/",
+                          splib::CompressionOptions::BEST_SPEED);
+    xlsx.setCompression(options);
+    xlsx.setThreads(4);
+    xlsx.write(sc, _T("testlevels.xlsx"));
+    splib::OdsWriter ods;
+    ods.setCompression(splib::CompressionOptions(
+        splib::CompressionOptions::STORE));
+    ods.write(sc, _T("teststore.ods"));
+}
+
+/** A decimal comma and grouping by thousands */
+class CommaNumpunct : public std::numpunct<char> {
+    protected:
+        virtual char do_decimal_point() const {
+            return ',';
+        }
+
+        virtual char do_thousands_sep() const {
+            return '.';
+        }
+
+        virtual std::string do_grouping() const {
+            return "\3";
+        }
+};
+
+void testBlockCompression() {
+    // the size of the blocks that the threads compress
+    const size_t BLOCK = 128 * 1024;
+    splib::SpreadsheetImpl sc;
+    splib::Table& table = sc.insertTable(0, _T("Blocks"));
+    table.cell(0, 0).setText(_T(""));
+    splib::XlsxWriter serial;
+    splib::XlsxWriter parallel;
+    parallel.setThreads(4);
+    const char* name = "xl/worksheets/sheet1.xml";
+    size_t empty = readZip(writeXlsx(sc, serial))[name].size();
+
+    // a sheet smaller than a block, a single block, several blocks of
+    // one batch, several batches, and one byte past them
+    size_t sizes[] = {empty + 100, BLOCK, 3 * BLOCK, 8 * BLOCK,
+                      8 * BLOCK + 1};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        std::basic_string<_TCHAR> text(sizes[i] - empty, _T('a'));
+        unsigned random = 1;
+        for (size_t j = 0; j < text.size(); j++) {
+            random = random * 1103515245 + 12345;
+            text[j] = (_TCHAR)(_T('a') + (random >> 16) % 26);
+        }
+        table.cell(0, 0).setText(text.c_str());
+        ZipEntries expected = readZip(writeXlsx(sc, serial));
+        verify(expected[name].size() == sizes[i]);
+        verify(readZip(writeXlsx(sc, parallel)) == expected);
+    }
+}
+
+void testNumberFormat() {
+    splib::SpreadsheetImpl sc;
+    splib::Table& table = sc.insertTable(0, _T("Numbers"));
+    table.cell(0, 0).setDouble(0.1);
+    table.cell(0, 1).setDouble(-2.5);
+    table.cell(0, 2).setDouble(1.0 / 3);
+    table.cell(0, 3).setDouble(1e21);
+    table.cell(0, 4).setDouble(1.5e-7);
+    table.cell(0, 5).setDouble(123456789.0);
+    table.cell(0, 6).setDouble(5e-324);
+    table.cell(1, 0).setLong(1234567L);
+    table.cell(1, 1).setLong(-42L);
+    table.cell(1, 2).setLong(0L);
+
+    // the same numbers whatever the locale of the program
+    std::locale previous = std::locale::global(
+        std::locale(std::locale::classic(), new CommaNumpunct()));
+    std::string xlsx = writeStored(sc, true);
+    std::string ods = writeStored(sc, false);
+    std::locale::global(previous);
+    verify(xlsx == writeStored(sc, true));
+    verify(ods == writeStored(sc, false));
+
+    const char* expected[] = {
+        "0.1", "-2.5", "0.3333333333333333", "1e+21", "1.5e-7",
+        "123456789", "5e-324", "1234567", "-42", "0"
+    };
+    for (int i = 0; i < (int)(sizeof(expected) / sizeof(expected[0])); i++) {
+        std::string v = std::string("<v>") + expected[i] + "</v>";
+        verify(xlsx.find(v) != std::string::npos);
+        std::string p = std::string("<text:p>") + expected[i] + "</text:p>";
+        verify(ods.find(p) != std::string::npos);
+    }
+}
+
+void testXmlText() {
+    splib::SpreadsheetImpl sc;
+    splib::Table& table = sc.insertTable(0, _T("A&B <\"1\">"));
+    table.cell(0, 0).setText(_T("1 < 2 & \"3\" > 0"));
+    table.cell(0, 1).setText(_T(""));
+    // longer than the buffer of the writer
+    std::basic_string<_TCHAR> text(40000, _T('x'));
+    text[20000] = _T('&');
+    table.cell(0, 2).setText(text.c_str());
+
+    std::string xlsx = writeStored(sc, true);
+    std::string ods = writeStored(sc, false);
+    verify(xlsx.find("<t>1 &lt; 2 &amp; &quot;3&quot; &gt; 0</t>") !=
+           std::string::npos);
+    verify(ods.find("<text:p>1 &lt; 2 &amp; &quot;3&quot; &gt; 0</text:p>") !=
+           std::string::npos);
+    verify(xlsx.find("<t></t>") != std::string::npos);
+    verify(ods.find("<text:p></text:p>") != std::string::npos);
+    const char* name = "A&amp;B &lt;&quot;1&quot;&gt;";
+    verify(xlsx.find(std::string("<sheet name=\"") + name) !=
+           std::string::npos);
+    verify(xlsx.find(std::string("<vt:lpstr>") + name) != std::string::npos);
+    verify(ods.find(std::string("table:name=\"") + name) != std::string::npos);
+    std::string expected = std::string(20000, 'x') + "&amp;" +
+                           std::string(19999, 'x');
+    verify(xlsx.find(std::string("<t>") + expected + "</t>") !=
+           std::string::npos);
+    verify(ods.find(std::string("<text:p>") + expected + "</text:p>") !=
+           std::string::npos);
+
+    // special characters around the blocks searched at a time
+    splib::SpreadsheetImpl blocks;
+    splib::Table& offsets = blocks.insertTable(0, _T("Offsets"));
+    for (int i = 0; i < 70; i++) {
+        std::basic_string<_TCHAR> text(70, _T('a'));
+        text[i] = _T('<');
+        text[69 - i] = _T('"');
+        offsets.cell(0, i).setText(text.c_str());
+        std::basic_string<_TCHAR> prefix(i, _T('b'));
+        offsets.cell(1, i).setText((prefix + _T(">")).c_str());
+        // control characters other than tabs and line ends are replaced
+        std::basic_string<_TCHAR> controls(70, _T('c'));
+        controls[69 - i] = i % 2 == 0 ? _T('\t') : _T('\n');
+        controls[i] = i % 3 == 0 ? _T('\x01') : i % 3 == 1 ? _T('\x0B')
+                                                         : _T('\x1F');
+        offsets.cell(2, i).setText(controls.c_str());
+    }
+    xlsx = writeStored(blocks, true);
+    for (int i = 0; i < 70; i++) {
+        std::string text(70, 'a');
+        text[i] = '<';
+        text[69 - i] = '"';
+        std::string escaped;
+        for (int j = 0; j < 70; j++) {
+            escaped += text[j] == '<' ? "&lt;" : text[j] == '"' ? "&quot;" :
+                       std::string(1, text[j]);
+        }
+        verify(xlsx.find("<t>" + escaped + "</t>") != std::string::npos);
+        std::string prefix(i, 'b');
+        verify(xlsx.find("<t>" + prefix + "&gt;</t>") != std::string::npos);
+        std::string controls(70, 'c');
+        controls[69 - i] = i % 2 == 0 ? '\t' : '\n';
+        controls.replace(i, 1, "\xEF\xBF\xBD");
+        verify(xlsx.find("<t>" + controls + "</t>") != std::string::npos);
+    }
+    std::string sheet = readZip(xlsx)["xl/worksheets/sheet1.xml"];
+    verify(sheet.find('\x01') == std::string::npos);
+    verify(sheet.find('\x0B') == std::string::npos);
+    verify(sheet.find('\x1F') == std::string::npos);
+
+#ifndef WIN32
+    // valid UTF-8 is kept, and invalid bytes are replaced
+    splib::SpreadsheetImpl utf8;
+    splib::Table& texts = utf8.insertTable(0, "UTF-8");
+    texts.cell(0, 0).setText("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 & "
+                             "0123456789012345678901234567890123456789");
+    texts.cell(0, 1).setText("a\xC3(b\xFF\xC0\xAF\xED\xA0\x80\xF4\x90\x80\x80");
+    xlsx = writeStored(utf8, true);
+    verify(xlsx.find("<t>caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 &amp; "
+                     "0123456789012345678901234567890123456789</t>") !=
+           std::string::npos);
+    std::string replacement = "\xEF\xBF\xBD";
+    std::string replaced = "<t>a" + replacement + "(b";
+    for (int i = 0; i < 10; i++) {
+        replaced += replacement;
+    }
+    verify(xlsx.find(replaced + "</t>") != std::string::npos);
+#endif // WIN32
+}
+
+void testCellReferences() {
+    splib::SpreadsheetImpl sc;
+    splib::Table& table = sc.insertTable(0, _T("References"));
+    const int columns[] = {0, 1, 25, 26, 27, 51, 52, 701, 702, 703, 16383};
+    const char* names[] = {"A", "B", "Z", "AA", "AB", "AZ", "BA", "ZZ",
+                           "AAA", "AAB", "XFD"};
+    const int rows[] = {0, 8, 9, 98, 99, 999, 9999, 99999, 1048575};
+    const char* numbers[] = {"1", "9", "10", "99", "100", "1000", "10000",
+                             "100000", "1048576"};
+    const int count = sizeof(columns) / sizeof(columns[0]);
+    for (int i = 0; i < count; i++) {
+        table.cell(columns[i], rows[i % 9]).setLong(i);
+    }
+    std::string xlsx = writeStored(sc, true);
+    for (int i = 0; i < count; i++) {
+        std::string ref = std::string("<c r=\"") + names[i] +
+                          numbers[i % 9] + "\"";
+        verify(xlsx.find(ref) != std::string::npos);
+    }
+    verify(xlsx.find("<dimension ref=\"A1:XFD1048576\"/>") !=
+           std::string::npos);
+}
+
+void testSharedStrings() {
+    splib::SpreadsheetImpl sc;
+    splib::Table& first = sc.insertTable(0, _T("First"));
+    splib::Table& second = sc.insertTable(1, _T("Second"));
+    const _TCHAR* labels[] = {_T("North"), _T("South"), _T("R&D <x>")};
+    for (int row = 0; row < 30; row++) {
+        first.cell(0, row).setText(labels[row % 3]);
+        first.cell(1, row).setLong(row);
+        second.cell(0, row).setText(labels[(row + 1) % 3]);
+    }
+    second.cell(1, 0).setText(_T(""));
+    second.cell(1, 1).setText(_T("Only once"));
+
+    splib::XlsxWriter writer;
+    verify(!writer.getSharedStrings());
+    writer.setCompression(splib::CompressionOptions(
+        splib::CompressionOptions::STORE));
+    splib::MemorySink inlineSink;
+    writer.write(sc, inlineSink);
+    std::string inlined((const char*)inlineSink.getData(),
+                        inlineSink.getSize());
+    verify(inlined.find("xl/sharedStrings.xml") == std::string::npos);
+    verify(inlined.find("<is><t>North</t></is>") != std::string::npos);
+
+    writer.setSharedStrings(true);
+    verify(writer.getSharedStrings());
+    splib::MemorySink sink;
+    writer.write(sc, sink);
+    std::string xlsx((const char*)sink.getData(), sink.getSize());
+    verify(xlsx.find("<is>") == std::string::npos);
+    verify(xlsx.find("<Override PartName=\"/xl/sharedStrings.xml\" "
+                     "ContentType=\"application/vnd.openxmlformats-"
+                     "officedocument.spreadsheetml.sharedStrings+xml\"/>") !=
+           std::string::npos);
+    verify(xlsx.find("<Relationship Id=\"rId5\" Type=\"http://schemas."
+                     "openxmlformats.org/officeDocument/2006/relationships/"
+                     "sharedStrings\" Target=\"sharedStrings.xml\"/>") !=
+           std::string::npos);
+    // the texts in the order they first appear, each once
+    verify(xlsx.find("count=\"62\" uniqueCount=\"5\">\r\n"
+                     "<si><t>North</t></si>\r\n"
+                     "<si><t>South</t></si>\r\n"
+                     "<si><t>R&amp;D &lt;x&gt;</t></si>\r\n"
+                     "<si><t></t></si>\r\n"
+                     "<si><t>Only once</t></si>\r\n"
+                     "</sst>") != std::string::npos);
+    verify(xlsx.find("<c r=\"A3\" t=\"s\">\r\n<v>2</v>\r\n</c>") !=
+           std::string::npos);
+    verify(xlsx.find("<c r=\"B2\" t=\"s\">\r\n<v>4</v>\r\n</c>") !=
+           std::string::npos);
+    writer.write(sc, _T("testshared.xlsx"));
+
+    // the same table when the sheets are written by several threads
+    writer.setThreads(2);
+    splib::MemorySink parallel;
+    writer.write(sc, parallel);
+    std::string threaded((const char*)parallel.getData(), parallel.getSize());
+    size_t start = xlsx.find("<sst ");
+    verify(start != std::string::npos);
+    verify(threaded.find(xlsx.substr(start, xlsx.find("</sst>") - start)) !=
+           std::string::npos);
+    verify(threaded.find("<c r=\"B2\" t=\"s\">\r\n<v>4</v>\r\n</c>") !=
+           std::string::npos);
+
+    // stream writer
+    splib::MemorySink streamed;
+    splib::XlsxStreamWriter stream(streamed);
+    stream.setCompression(splib::CompressionOptions(
+        splib::CompressionOptions::STORE));
+    stream.setSharedStrings(true);
+    stream.beginSheet(_T("Stream"));
+    for (int row = 0; row < 10; row++) {
+        splib::CellValue values[] = {
+            splib::CellValue(labels[row % 2]), splib::CellValue((long)row)};
+        stream.writeRow(row, 0, values, 2);
+    }
+    stream.endSheet();
+    stream.close();
+    std::string streamXlsx((const char*)streamed.getData(),
+                           streamed.getSize());
+    verify(streamXlsx.find("count=\"10\" uniqueCount=\"2\">") !=
+           std::string::npos);
+    verify(streamXlsx.find("<c r=\"A2\" t=\"s\">\r\n<v>1</v>") !=
+           std::string::npos);
+    verify(streamXlsx.find("sharedStrings+xml") != std::string::npos);
+}
+
+void testCompactSheets() {
+    splib::SpreadsheetImpl sc;
+    splib::Table& table = sc.insertTable(0, _T("Compact"));
+    for (int col = 0; col < 3; col++) {
+        table.cell(col, 0).setLong(col + 1);
+        table.cell(col, 2).setDouble(0.5 + col);
+    }
+    table.cell(4, 0).setText(_T("a & b"));
+    table.cell(1, 1).setText(_T("second"));
+    table.columns().get(0).setWidth(225);
+    table.columns().get(1).setWidth(225);
+    table.columns().get(2).setWidth(225);
+    table.columns().get(3).setWidth(450);
+    table.columns().get(5).setWidth(225);
+    sc.insertTable(1, _T("Copy"));
+    sc.table(1).cell(0, 0).setText(_T("copy"));
+
+    splib::XlsxWriter writer;
+    verify(!writer.getCompact());
+    writer.setCompression(splib::CompressionOptions(
+        splib::CompressionOptions::STORE));
+    writer.setCompact(true);
+    verify(writer.getCompact());
+    splib::MemorySink sink;
+    writer.write(sc, sink);
+    std::string xlsx((const char*)sink.getData(), sink.getSize());
+    verify(xlsx.find(
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/"
+        "2006/5/main\" xmlns:r=\"http://schemas.openxmlformats.org/"
+        "officeDocument/2006/relationships\"><dimension ref=\"A1:E3\"/>"
+        "<cols>"
+        "<col min=\"1\" max=\"3\" width=\"42.85546875\" customWidth=\"1\"/>"
+        "<col min=\"4\" max=\"4\" width=\"85.7109375\" customWidth=\"1\"/>"
+        "<col min=\"6\" max=\"6\" width=\"42.85546875\" customWidth=\"1\"/>"
+        "</cols><sheetData>"
+        "<row spans=\"1:5\"><c><v>1</v></c><c><v>2</v></c><c><v>3</v></c>"
+        "<c r=\"E1\"><is><t>a &amp; b</t></is></c></row>"
+        "<row spans=\"1:5\"><c r=\"B2\"><is><t>second</t></is></c></row>"
+        "<row spans=\"1:5\"><c><v>0.5</v></c><c><v>1.5</v></c>"
+        "<c><v>2.5</v></c></row>"
+        "</sheetData></worksheet>") != std::string::npos);
+
+    // with shared strings, and by several threads
+    writer.setSharedStrings(true);
+    writer.setThreads(2);
+    splib::MemorySink shared;
+    writer.write(sc, shared);
+    xlsx.assign((const char*)shared.getData(), shared.getSize());
+    verify(xlsx.find("<c r=\"E1\" t=\"s\"><v>0</v></c>") !=
+           std::string::npos);
+    verify(xlsx.find("<c r=\"B2\" t=\"s\"><v>1</v></c>") !=
+           std::string::npos);
+    verify(xlsx.find("<row spans=\"1:1\"><c t=\"s\"><v>2</v></c></row>") !=
+           std::string::npos);
+    writer.write(sc, _T("testcompact.xlsx"));
+
+    // stream writer, with rows that are not consecutive
+    splib::MemorySink streamed;
+    splib::XlsxStreamWriter stream(streamed);
+    stream.setCompression(splib::CompressionOptions(
+        splib::CompressionOptions::STORE));
+    stream.setCompact(true);
+    stream.beginSheet(_T("Stream"));
+    stream.setColumnWidth(1, 225);
+    stream.setColumnWidth(2, 225);
+    splib::CellValue values[] = {
+        splib::CellValue(1L), splib::CellValue(), splib::CellValue(2.5)};
+    stream.writeRow(0, 1, values, 3);
+    stream.writeRow(1, 0, values, 1);
+    stream.writeRow(5, 0, values, 1);
+    stream.endSheet();
+    stream.close();
+    xlsx.assign((const char*)streamed.getData(), streamed.getSize());
+    verify(xlsx.find(
+        "<cols><col min=\"2\" max=\"3\" width=\"42.85546875\" "
+        "customWidth=\"1\"/></cols><sheetData>"
+        "<row spans=\"2:4\"><c r=\"B1\"><v>1</v></c><c r=\"D1\"><v>2.5</v></c>"
+        "</row><row spans=\"1:1\"><c><v>1</v></c></row>"
+        "<row r=\"6\" spans=\"1:1\"><c><v>1</v></c></row>"
+        "</sheetData></worksheet>") != std::string::npos);
+}
+
+std::string writeStored(splib::Spreadsheet& sc, bool xlsx) {
+    splib::CompressionOptions options(splib::CompressionOptions::STORE);
+    splib::MemorySink sink;
+    if (xlsx) {
+        splib::XlsxWriter writer;
+        writer.setCompression(options);
+        writer.write(sc, sink);
+    } else {
+        splib::OdsWriter writer;
+        writer.setCompression(options);
+        writer.write(sc, sink);
+    }
+    return std::string((const char*)sink.getData(), sink.getSize());
+}
+
+bool collect(void* context, const void* data, unsigned length) {
+    ((std::string*)context)->append((const char*)data, length);
+    return true;
+}
+
+bool refuse(void*, const void*, unsigned) {
+    return false;
+}
+
+std::string readFile(const char* pathname) {
+    std::string data;
+    FILE* f = fopen(pathname, "rb");
+    verify(f != 0);
+    char buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        data.append(buffer, length);
+    }
+    fclose(f);
+    return data;
+}
+
+void writeFile(const char* pathname, const std::string& data) {
+    FILE* f = fopen(pathname, "wb");
+    verify(f != 0);
+    verify(fwrite(data.data(), 1, data.size(), f) == data.size());
+    fclose(f);
+}
+
+unsigned long zipInt(const std::string& zip, size_t offset, int size) {
+    verify(offset + size <= zip.size());
+    unsigned long value = 0;
+    for (int i = size - 1; i >= 0; i--) {
+        value = (value << 8) | (unsigned char)zip[offset + i];
+    }
+    return value;
+}
+
+size_t heapInUse() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+ZipEntries readZip(const std::string& zip) {
+    // the end of central directory record, without an archive comment
+    verify(zip.size() >= 22);
+    size_t end = zip.size() - 22;
+    verify(zipInt(zip, end, 4) == 0x06054b50);
+    unsigned long count = zipInt(zip, end + 10, 2);
+    size_t header = zipInt(zip, end + 16, 4);
+    ZipEntries entries;
+    for (unsigned long n = 0; n < count; n++) {
+        verify(zipInt(zip, header, 4) == 0x02014b50);
+        unsigned long method = zipInt(zip, header + 10, 2);
+        unsigned long crc = zipInt(zip, header + 16, 4);
+        unsigned long packed = zipInt(zip, header + 20, 4);
+        unsigned long length = zipInt(zip, header + 24, 4);
+        size_t nameLength = zipInt(zip, header + 28, 2);
+        std::string name = zip.substr(header + 46, nameLength);
+        size_t local = zipInt(zip, header + 42, 4);
+        verify(zipInt(zip, local, 4) == 0x04034b50);
+        size_t data = local + 30 + zipInt(zip, local + 26, 2) +
+                      zipInt(zip, local + 28, 2);
+        verify(data + packed <= zip.size());
+        std::string content(length, '\0');
+        if (method == 0) {
+            verify(packed == length);
+            content = zip.substr(data, packed);
+        } else {
+            verify(method == Z_DEFLATED);
+            z_stream zs;
+            memset(&zs, 0, sizeof(zs));
+            verify(inflateInit2(&zs, -MAX_WBITS) == Z_OK);
+            zs.next_in = (Bytef*)zip.data() + data;
+            zs.avail_in = (uInt)packed;
+            // one spare byte to detect data past the expected length
+            std::string buffer(length + 1, '\0');
+            zs.next_out = (Bytef*)&buffer[0];
+            zs.avail_out = (uInt)buffer.size();
+            verify(inflate(&zs, Z_FINISH) == Z_STREAM_END);
+            verify(zs.total_out == length && zs.avail_in == 0);
+            inflateEnd(&zs);
+            content = buffer.substr(0, length);
+        }
+        verify(crc32(0, (const Bytef*)content.data(), (uInt)length) == crc);
+        entries[name] = content;
+        header += 46 + nameLength + zipInt(zip, header + 30, 2) +
+                  zipInt(zip, header + 32, 2);
+    }
+    return entries;
+}
+
+std::string writeXlsx(splib::Spreadsheet& sc, splib::XlsxWriter& writer) {
+    splib::MemorySink sink;
+    writer.write(sc, sink);
+    return std::string((const char*)sink.getData(), sink.getSize());
 }
 
 void setupTestSpreadsheet(splib::Spreadsheet& sc) {
@@ -998,6 +2776,7 @@ void setupTestSpreadsheet(splib::Spreadsheet& sc) {
     setupSpecialCharsTable(sc);
     setupHeightsAndWidthsTable(sc);
     setupEmptyTable(sc);
+    setupColumnarTable(sc);
 }
 
 void setupCellTypesTable(splib::Spreadsheet& sc) {
@@ -1180,3 +2959,25 @@ void setupHeightsAndWidthsTable(splib::Spreadsheet& sc) {
 void setupEmptyTable(splib::Spreadsheet& sc) {
     sc.insertTable(sc.tableCount(), _T("Empty Sheet"));
 }
+
+void setupColumnarTable(splib::Spreadsheet& sc) {
+    splib::Table& table =
+        sc.insertColumnarTable(sc.tableCount(), _T("Columnar"));
+    const int H = 100; // height of the table
+    table.cell(0, 0).setText(_T("Index"));
+    table.cell(1, 0).setText(_T("Value"));
+    table.cell(2, 0).setText(_T("Date"));
+    table.cell(3, 0).setText(_T("Time"));
+    for (int r = 1; r <= H; r++) {
+        table.cell(0, r).setLong(r);
+        table.cell(1, r).setDouble(1. / r);
+        table.cell(2, r).setDate(splib::Date(2006, 1 + r % 12, 1 + r % 28));
+        table.cell(3, r).setTime(splib::Time(r % 24, r % 60));
+    }
+    std::basic_stringstream<_TCHAR> formula;
+    formula << _T("SUM(B2:B") << (H + 1) << _T(")");
+    table.cell(1, H + 1).setFormula(formula.str().c_str());
+    table.cell(1, H + 1).setHAlignment(splib::Cell::RIGHT);
+    table.rows().get(0).setHeight(30);
+    table.columns().get(2).setWidth(70);
+}